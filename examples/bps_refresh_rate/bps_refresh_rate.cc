@@ -5,9 +5,10 @@
 #include "analysis/plotting/box_plot.h"
 #include "analysis/pdmp_runner.h"
 #include "analysis/output_processors/batch_means.h"
+#include "analysis/output_processors/refresh_rate_adapter.h"
 #include "analysis/running_policies/timed_runned.h"
 #include "analysis/timers/per_thread_cpu_timer.h"
-#include "analysis/parallel_workers.h"
+#include "analysis/parallel_chain_runner.h"
 
 #include "core/state_space/position_and_velocity_state.h"
 #include "core/policies/linear_flow.h"
@@ -45,46 +46,98 @@ auto getInitialState() {
   return initialState;
 }
 
-// Returns a new BPS pdmp.
-auto buildBpsPdmp(GaussianDistribution& distribution, double refreshRate) {
+// Returns a new BPS builder.
+BpsBuilder getBpsBuilder(GaussianDistribution& distribution, double refreshRate) {
   BpsBuilder bpsBuilder(kDimension);
   std::vector<int> modelVariables;
   for (int i = 0; i < kDimension; i++) {
     modelVariables.push_back(i);
   }
   bpsBuilder.addFactor(modelVariables, distribution, refreshRate);
-  return bpsBuilder.build();
+  return bpsBuilder;
 }
 
 // Estimates the asymptotic variance for a given pdmp.
 template<class Pdmp>
-double getAsymptoticVariance(Pdmp& pdmp) {
+double getAsymptoticVariance(Pdmp& pdmp, const State& initialState) {
   PdmpRunner<Pdmp, State, TimedRunner<PerThreadCpuTimer>> runner;
   auto batchMeansProcessor = BatchMeans<Pdmp, State, LinearFlow>(
     functionToEstimate);
   runner.registerAnObserver(&batchMeansProcessor);
-  auto initialState = getInitialState();
   runner.run(pdmp, initialState, 2000, 0, true);
   return batchMeansProcessor.estimateAsymptoticVariance();
 }
 
-double getBpsAsymptoticVariance(double refreshRate) {
-  auto bpsPdmp = buildBpsPdmp(gaussian, refreshRate);
-  return getAsymptoticVariance(bpsPdmp);
+// Estimates the asymptotic variances for the given refresh rates with a
+// single PDMP, whose refresh rate is changed in place between the runs.
+std::vector<double> getBpsAsymptoticVariances(
+  const std::vector<double>& refreshRates) {
+
+  BpsBuilder bpsBuilder = getBpsBuilder(gaussian, 1.0);
+  auto bpsPdmp = bpsBuilder.build();
+  std::vector<double> variances;
+  for (double refreshRate : refreshRates) {
+    // The base rate is 1, so the scale is the refresh rate. Each run starts
+    // from a fresh state, so the other pending events are dropped as well.
+    bpsBuilder.setRefreshRateScale(bpsPdmp, refreshRate);
+    bpsPdmp.resetEvents();
+    variances.push_back(getAsymptoticVariance(bpsPdmp, getInitialState()));
+  }
+  return variances;
+}
+
+// Tunes the refresh rate during a burn-in run, starting from the standard
+// rate, and estimates the asymptotic variance with the tuned rate.
+double getTunedBpsAsymptoticVariance() {
+  BpsBuilder bpsBuilder = getBpsBuilder(gaussian, 1.0);
+  auto bpsPdmp = bpsBuilder.build();
+  using Pdmp = decltype(bpsPdmp);
+
+  PdmpRunner<Pdmp, State, TimedRunner<PerThreadCpuTimer>> tuningRunner;
+  RefreshRateAdapter<
+    Pdmp, State, LinearFlow, PdmpRefreshRateController<Pdmp>> adapter(
+      bpsBuilder.getRefreshRateController(bpsPdmp), functionToEstimate);
+  tuningRunner.registerAnObserver(&adapter);
+  // The last state of the tuning run is not exposed by the runner, so the
+  // estimation run starts from a fresh state, without the pending events of
+  // the tuning run.
+  tuningRunner.run(bpsPdmp, getInitialState(), 1000, 0, true);
+  cout << "Tuned refresh rate: "
+       << bpsBuilder.getRefreshRateController()->getRate(0) << endl;
+  bpsPdmp.resetEvents();
+
+  return getAsymptoticVariance(bpsPdmp, getInitialState());
 }
 
 int main() {
   std::vector<std::vector<double>> results;
   std::vector<std::string> names{
-    "1e-2", "0.1", "1", "10", "100"};
+    "1e-2", "0.1", "1", "10", "100", "tuned"};
 
+  // Each chain sweeps all the candidate rates.
+  ParallelChainRunner runner(7);
+  std::vector<double> refreshRates;
   for (double i = 1e-2; i <= 100.0; i *= 10.0) {
-    ::bps::analysis::ParallelWorkers<double> workers;
-    auto task = [i] () { return getBpsAsymptoticVariance(i); };
-    std::unique_ptr<std::vector<double>> workersResults =
-      workers.executeTasksInParallel(task, 14, 7);
-    results.push_back(*(workersResults.release()));
+    refreshRates.push_back(i);
   }
+  auto chain = [&refreshRates] (int, std::mt19937_64& rng) {
+    ScopedRngSeed seed(rng());
+    return getBpsAsymptoticVariances(refreshRates);
+  };
+  auto chainResults = runner.runChains(chain, 14);
+  for (int k = 0; k < refreshRates.size(); k++) {
+    results.emplace_back();
+    for (const auto& chainResult : chainResults) {
+      results.back().push_back(chainResult[k]);
+    }
+  }
+
+  // A single tuned run replaces the sweep over the candidate rates.
+  auto tunedChain = [] (int, std::mt19937_64& rng) {
+    ScopedRngSeed seed(rng());
+    return getTunedBpsAsymptoticVariance();
+  };
+  results.push_back(runner.runChains(tunedChain, 14));
 
   plotBoxPlot(results,
               names,
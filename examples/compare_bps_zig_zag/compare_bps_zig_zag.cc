@@ -7,7 +7,7 @@
 #include "analysis/output_processors/batch_means.h"
 #include "analysis/running_policies/timed_runned.h"
 #include "analysis/timers/per_thread_cpu_timer.h"
-#include "analysis/parallel_workers.h"
+#include "analysis/parallel_chain_runner.h"
 
 #include "core/state_space/position_and_velocity_state.h"
 #include "core/policies/linear_flow.h"
@@ -101,15 +101,21 @@ double getZigZagAsymptoticVariance() {
 }
 
 int main() {
-  ::bps::analysis::ParallelWorkers<double> bpsWorkers;
-  ::bps::analysis::ParallelWorkers<double> zigZagWorkers;
-
-  auto bpsAsymptoticVariances = bpsWorkers.executeTasksInParallel(
-    getBpsAsymptoticVariance, 42, 7);
-  auto zigZagAsymptoticVariances = zigZagWorkers.executeTasksInParallel(
-    getZigZagAsymptoticVariance, 42, 7);
-
-  plotBoxPlot({*bpsAsymptoticVariances, *zigZagAsymptoticVariances},
+  ParallelChainRunner runner(7);
+  auto bpsAsymptoticVariances = runner.runChains(
+    [] (int, std::mt19937_64& rng) {
+      ScopedRngSeed seed(rng());
+      return getBpsAsymptoticVariance();
+    },
+    42);
+  auto zigZagAsymptoticVariances = runner.runChains(
+    [] (int, std::mt19937_64& rng) {
+      ScopedRngSeed seed(rng());
+      return getZigZagAsymptoticVariance();
+    },
+    42);
+
+  plotBoxPlot({bpsAsymptoticVariances, zigZagAsymptoticVariances},
               {"Bps", "Zig-Zag"},
               "asymptoticvar");
   return 0;
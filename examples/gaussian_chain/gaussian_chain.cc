@@ -1,8 +1,10 @@
+#include <chrono>
 #include <iostream>
 
 #include <Eigen/Core>
 
 #include "analysis/pdmp_runner.h"
+#include "analysis/output_processors/refresh_rate_adapter.h"
 #include "analysis/running_policies/timed_runned.h"
 #include "analysis/timers/wall_clock_timer.h"
 #include "analysis/parallel_workers.h"
@@ -33,6 +35,16 @@ DEFINE_int32(pairs, 100, "The chain length.");
 DEFINE_int64(timeInMs, 10000, "The running time in milliseconds");
 DEFINE_int32(variancesOutputCount, 0,
              "Output estimated variances for the first n variables.");
+DEFINE_int32(factorsPerBlock, 1,
+             "The number of consecutive chain factors fused into a block.");
+DEFINE_int64(refreshTuningTimeInMs, 0,
+             "If positive, the refresh rate is tuned for this long before "
+             "the run, starting from the rate 1 / pairs per factor.");
+DEFINE_int32(startupThreads, 0,
+             "If positive, the initial events are simulated with this many "
+             "threads, and so are the factors constructed, unless they are "
+             "fused into blocks (see --factorsPerBlock). The timed run "
+             "itself is single-threaded.");
 
 
 // Will be set by the initialise() function.
@@ -78,29 +90,98 @@ auto getInitialState() {
   return initialState;
 }
 
-// Returns a new BPS pdmp on the gaussian chain target distribution.
-auto buildBpsOnGaussianChain() {
+// Returns a BPS builder of the gaussian chain target distribution.
+BpsBuilder getBpsBuilderOfGaussianChain() {
   double perFactorRefreshRate = 1.0 / FLAGS_pairs;
 
   RealVector mean = RealVector::Zero(2);
   GaussianDistribution gaussian(mean, chainFactorCovarianceMatrix);
 
   BpsBuilder bpsBuilder(FLAGS_pairs + 1);
+  // The factors added in bulk are not fused, so the fused factors are added
+  // one by one.
+  if (FLAGS_startupThreads > 0 && FLAGS_factorsPerBlock == 1) {
+    vector<vector<int>> variableIds;
+    for (int i = 0; i < FLAGS_pairs; i++) {
+      variableIds.push_back({i, i + 1});
+    }
+    bpsBuilder.addFactors(
+      variableIds, vector<GaussianDistribution>(FLAGS_pairs, gaussian),
+      RefreshmentOptions(perFactorRefreshRate), FLAGS_startupThreads);
+    return bpsBuilder;
+  }
+  bpsBuilder.setFactorsPerBlock(FLAGS_factorsPerBlock);
   for (int i = 0; i < FLAGS_pairs; i++) {
     bpsBuilder.addFactor({i, i + 1}, gaussian, perFactorRefreshRate);
   }
 
-  return bpsBuilder.build();
+  return bpsBuilder;
+}
+
+// Tunes the refresh rates of the given pdmp for the ESS of the first
+// variable's second moment, and reports the tuning trace.
+template<class Pdmp>
+void tuneRefreshRate(
+  Pdmp& pdmp,
+  std::shared_ptr<PdmpRefreshRateController<Pdmp>> refreshRateController) {
+
+  RefreshRateAdapter<
+    Pdmp, State, LinearFlow, PdmpRefreshRateController<Pdmp>> adapter(
+      refreshRateController,
+      [] (const State& state) {
+        return state.position(0) * state.position(0);
+      });
+  PdmpRunner<Pdmp, State, TimedRunner<WallClockTimer>> runner;
+  runner.registerAnObserver(&adapter);
+  runner.run(pdmp, getInitialState(), FLAGS_refreshTuningTimeInMs, 0, true);
+
+  for (const auto& step : adapter.getTuningTrace()) {
+    cout << "scale=" << step.scale
+         << " ess=" << step.effectiveSampleSize
+         << " essPerSecond=" << step.effectiveSampleSizePerSecond << endl;
+  }
+  cout << "Tuned per factor refresh rate: "
+       << refreshRateController->getRate(0) << endl << endl;
 }
 
 void runBps() {
-  auto pdmp = buildBpsOnGaussianChain();
+  // The time to first event covers the construction of the factor graph and
+  // the simulation of the initial events of all the factors.
+  const auto startTime = chrono::steady_clock::now();
+  BpsBuilder bpsBuilder = getBpsBuilderOfGaussianChain();
+  auto pdmp = bpsBuilder.build();
+  const auto buildTime = chrono::steady_clock::now();
+  const State initialState = getInitialState();
+  const auto stateTime = chrono::steady_clock::now();
+  if (FLAGS_startupThreads > 0) {
+    pdmp.setParallelResimulation(FLAGS_startupThreads);
+  }
+  pdmp.simulateOneIteration(initialState);
+  const auto firstEventTime = chrono::steady_clock::now();
+  // Only the initial events are simulated in parallel.
+  pdmp.setParallelResimulation(1);
+  cout << "buildTimeInMs="
+       << chrono::duration<double, milli>(buildTime - startTime).count()
+       << " firstEventTimeInMs="
+       << chrono::duration<double, milli>(firstEventTime - stateTime).count()
+       << " timeToFirstEventInMs="
+       << chrono::duration<double, milli>(
+            firstEventTime - stateTime + buildTime - startTime).count()
+       << endl << endl;
+  // The timed iteration's events are dropped, and the run starts afresh.
+  pdmp.resetEvents();
+
+  if (FLAGS_refreshTuningTimeInMs > 0) {
+    tuneRefreshRate(pdmp, bpsBuilder.getRefreshRateController(pdmp));
+    // The run starts afresh, not from the last state of the tuning run.
+    pdmp.resetEvents();
+  }
   VarianceProcessor<decltype(pdmp), State> varianceProcessor;
   PdmpRunner<decltype(pdmp), State, TimedRunner<WallClockTimer>> runner;
   runner.registerAnObserver(&varianceProcessor);
   // Run with no burn in and include variance calculation time
   // into the total time.
-  runner.run(pdmp, getInitialState(), FLAGS_timeInMs, 0, false);
+  runner.run(pdmp, initialState, FLAGS_timeInMs, 0, false);
 
   for (int i = 0; i < FLAGS_variancesOutputCount; i++) {
     cout << "i=" << i << endl
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include "analysis/pdmp_runner.h"
+
+namespace pdmp {
+namespace analysis {
+
+/**
+ * Runs a batch of chains simulated together (e.g. a
+ * mcmc::BatchedGaussianBps) and notifies the observers of each chain as if
+ * the chain was run on its own by a PdmpRunner, so that the output
+ * processors (BatchMeans, the mean estimators, ...) can consume the
+ * trajectories of the chains.
+ * The observers are notified with the batch as the observed Pdmp, i.e.
+ * they are of type ObserverBase<BatchedPdmp, State>.
+ */
+template<class BatchedPdmp>
+class BatchedChainsRunner {
+
+ public:
+
+  using State = typename BatchedPdmp::State;
+  using ObserverPtr = ObserverBase<BatchedPdmp, State>*;
+
+  /**
+   * Simulates the given number of events of each chain, starting at their
+   * current states. The observers of each chain are notified that the
+   * process begins with the current state of the chain, of each event of
+   * the chain, and that the process has ended.
+   */
+  void run(BatchedPdmp& batchedPdmp, int numberOfIterations);
+
+  /**
+   * Registers a given observer to the chain with the given id.
+   */
+  void registerAnObserver(int chainId, ObserverPtr observer);
+
+ private:
+
+  std::vector<std::vector<ObserverPtr>> observers_;
+};
+
+}
+}
+
+#include "batched_chains_runner.tcc"
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace pdmp {
+namespace analysis {
+
+template<class BatchedPdmp>
+void BatchedChainsRunner<BatchedPdmp>::run(
+  BatchedPdmp& batchedPdmp, int numberOfIterations) {
+
+  const int numberOfChains = batchedPdmp.getNumberOfChains();
+  if (static_cast<int>(observers_.size()) > numberOfChains) {
+    throw std::out_of_range(
+      "Observers are registered to " + std::to_string(observers_.size())
+      + " chains, but the batch has only "
+      + std::to_string(numberOfChains) + ".");
+  }
+  observers_.resize(numberOfChains);
+
+  for (int k = 0; k < numberOfChains; k++) {
+    for (const auto& observer : observers_[k]) {
+      observer->notifyProcessBegins(batchedPdmp, batchedPdmp.getState(k));
+    }
+  }
+  batchedPdmp.simulateIterations(
+    numberOfIterations,
+    [this] (int chainId, const IterationResult<State>& iterationResult) {
+      for (const auto& observer : observers_[chainId]) {
+        observer->notifyIterationResult(iterationResult);
+      }
+    });
+  for (int k = 0; k < numberOfChains; k++) {
+    for (const auto& observer : observers_[k]) {
+      observer->notifyProcessEnded();
+    }
+  }
+}
+
+template<class BatchedPdmp>
+void BatchedChainsRunner<BatchedPdmp>::registerAnObserver(
+  int chainId, ObserverPtr observer) {
+
+  if (chainId < 0) {
+    throw std::out_of_range(
+      "Chain id should be non-negative, but is "
+      + std::to_string(chainId) + ".");
+  }
+  if (chainId >= static_cast<int>(observers_.size())) {
+    observers_.resize(chainId + 1);
+  }
+  observers_[chainId].push_back(observer);
+}
+
+}
+}
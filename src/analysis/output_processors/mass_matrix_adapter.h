@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+
+#include <Eigen/Core>
+
+#include "analysis/output_processors/sequential_processor_base.h"
+
+namespace pdmp {
+namespace analysis {
+
+/**
+ * A processor which adapts the mass matrix of a preconditioned linear flow
+ * PDMP online. The target covariance is estimated from the exact path
+ * integrals of the piecewise linear trajectory, and the inverse mass matrix
+ * is periodically set to it, shrunk towards the identity while the estimate
+ * is based on few iterations.
+ *
+ * Register it for a burn-in run only, since changing the mass matrix during
+ * the run does not preserve the target distribution.
+ *
+ * MassMatrix should implement setInverse(const Eigen::MatrixXd&).
+ */
+template<class Pdmp, class State, class MassMatrix>
+class MassMatrixAdapter : public SequentialProcessorBase<Pdmp, State> {
+
+ public:
+
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+  /**
+   * Creates the adapter, which updates the given mass matrix once every
+   * given number of iterations and when the process ends.
+   */
+  MassMatrixAdapter(
+    std::shared_ptr<MassMatrix> massMatrix, long updateInterval = 1000);
+
+  virtual void notifyProcessEnded() override;
+
+  /**
+   * Returns the current estimate of the target covariance.
+   */
+  RealMatrix estimateCovariance() const;
+
+ protected:
+
+  virtual void processTwoSequentialResults(
+    const IterationResult<State>& first,
+    const IterationResult<State>& second) override final;
+
+ private:
+
+  // Sets the inverse mass matrix to the regularised covariance estimate.
+  void updateMassMatrix();
+
+  std::shared_ptr<MassMatrix> massMatrix_;
+  long updateInterval_;
+  long numberOfIterations_{0};
+  double totalTime_{0.0};
+  RealVector integratedPosition_;
+  RealMatrix integratedSquaredPosition_;
+
+};
+
+}
+}
+
+#include "mass_matrix_adapter.tcc"
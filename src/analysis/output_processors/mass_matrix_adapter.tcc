@@ -0,0 +1,74 @@
+#pragma once
+
+namespace pdmp {
+namespace analysis {
+
+template<class Pdmp, class State, class MassMatrix>
+MassMatrixAdapter<Pdmp, State, MassMatrix>::MassMatrixAdapter(
+  std::shared_ptr<MassMatrix> massMatrix, long updateInterval)
+  : massMatrix_(massMatrix),
+    updateInterval_(updateInterval) {
+}
+
+template<class Pdmp, class State, class MassMatrix>
+void MassMatrixAdapter<Pdmp, State, MassMatrix>::notifyProcessEnded() {
+  updateMassMatrix();
+}
+
+template<class Pdmp, class State, class MassMatrix>
+auto MassMatrixAdapter<Pdmp, State, MassMatrix>::estimateCovariance() const
+  -> RealMatrix {
+
+  RealVector mean = integratedPosition_ / totalTime_;
+  RealMatrix covariance =
+    integratedSquaredPosition_ / totalTime_ - mean * mean.transpose();
+  return covariance;
+}
+
+template<class Pdmp, class State, class MassMatrix>
+void MassMatrixAdapter<Pdmp, State, MassMatrix>::processTwoSequentialResults(
+  const IterationResult<State>& first,
+  const IterationResult<State>& second) {
+
+  const RealVector position = first.state.position.template cast<double>();
+  const RealVector velocity = first.state.velocity.template cast<double>();
+  const double time = second.iterationTime;
+  if (numberOfIterations_ == 0) {
+    integratedPosition_ = RealVector::Zero(position.size());
+    integratedSquaredPosition_ =
+      RealMatrix::Zero(position.size(), position.size());
+  }
+
+  // Exact integrals of x + vt and (x + vt)(x + vt)^T over [0, time].
+  const RealMatrix crossTerm = position * velocity.transpose();
+  totalTime_ += time;
+  integratedPosition_ += position * time + velocity * time * time / 2.0;
+  integratedSquaredPosition_ +=
+    position * position.transpose() * time
+    + (crossTerm + crossTerm.transpose()) * time * time / 2.0
+    + velocity * velocity.transpose() * time * time * time / 3.0;
+
+  numberOfIterations_++;
+  if (numberOfIterations_ % updateInterval_ == 0) {
+    updateMassMatrix();
+  }
+}
+
+template<class Pdmp, class State, class MassMatrix>
+void MassMatrixAdapter<Pdmp, State, MassMatrix>::updateMassMatrix() {
+  if (numberOfIterations_ == 0 || totalTime_ <= 0.0) {
+    return;
+  }
+  // Shrink the estimate towards a small multiple of the identity, as in
+  // the Stan warm-up, to keep it well conditioned early on.
+  const double n = numberOfIterations_;
+  RealMatrix covariance = estimateCovariance();
+  RealMatrix regularised =
+    (n / (n + 5.0)) * covariance
+    + 1e-3 * (5.0 / (n + 5.0))
+      * RealMatrix::Identity(covariance.rows(), covariance.cols());
+  massMatrix_->setInverse(regularised);
+}
+
+}
+}
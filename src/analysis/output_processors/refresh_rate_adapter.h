@@ -0,0 +1,140 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "analysis/output_processors/batch_means.h"
+#include "analysis/pdmp_runner.h"
+#include "analysis/timers/per_thread_cpu_timer.h"
+
+namespace pdmp {
+namespace analysis {
+
+/**
+ * The efficiency measured by a RefreshRateAdapter during one tuning window.
+ */
+struct RefreshRateTuningStep {
+  // The scale of the refresh rates used during the window.
+  double scale;
+  long numberOfIterations;
+  double trajectoryLength;
+  // The simulation time, excluding the time spent by the adapter itself.
+  double seconds;
+  double effectiveSampleSize;
+  double effectiveSampleSizePerSecond;
+};
+
+/**
+ * A processor which tunes the refresh rates of a BPS online, to maximise
+ * the effective sample size of the given integrand per second of
+ * simulation.
+ *
+ * The run is split into windows of a fixed number of iterations. The ESS
+ * of each window is estimated by batch means around the running mean of all
+ * the windows, and divided by the time spent simulating the window, which
+ * accounts both for the mixing and for the event throughput at the current
+ * rates. The log-scale of the rates is tuned by a compass search: the
+ * current scale and its neighbours at +-step are evaluated in turn, the
+ * best one becomes the current scale, and the step is halved whenever the
+ * current scale wins.
+ *
+ * When the process ends, the controller is set to the current scale and,
+ * by default, frozen. Register it for a burn-in run only, since changing
+ * the rates during the run makes the process time-inhomogeneous.
+ *
+ * Controller should implement getScale(), setScale(double) and freeze(),
+ * e.g. mcmc::PdmpRefreshRateController, which resimulates the pending
+ * refreshment events of the PDMP at each change of the scale. With a
+ * controller which does not, such as mcmc::RefreshRateController, each
+ * pending refreshment keeps the rate at which it was simulated, so the
+ * windows should be long compared to the largest 1 / rate.
+ */
+template<
+  class Pdmp, class State, class Flow, class Controller,
+  class Timer = PerThreadCpuTimer>
+class RefreshRateAdapter : public ObserverBase<Pdmp, State> {
+
+ public:
+
+  using RealType = typename State::RealType;
+
+  /**
+   * Creates the adapter.
+   *
+   * @param controller
+   *   The controller of the refresh rates of the observed PDMP.
+   * @param integrand
+   *   The function whose ESS is maximised, e.g. the squared norm of the
+   *   position.
+   * @param windowIterations
+   *   The number of iterations used to evaluate each scale.
+   * @param initialStep
+   *   The initial multiplicative step of the scale search.
+   * @param freezeOnEnd
+   *   Whether the controller should be frozen when the process ends.
+   */
+  RefreshRateAdapter(
+    std::shared_ptr<Controller> controller,
+    std::function<RealType(State)> integrand,
+    long windowIterations = 10000,
+    double initialStep = 4.0,
+    bool freezeOnEnd = true);
+
+  virtual void notifyProcessBegins(
+    const Pdmp& pdmp, const State& initialState) override;
+
+  virtual void notifyIterationResult(
+    const IterationResult<State>& iterationResult) override;
+
+  virtual void notifyProcessEnded() override;
+
+  /**
+   * Returns the measurements of all the finished tuning windows.
+   */
+  const std::vector<RefreshRateTuningStep>& getTuningTrace() const;
+
+  /**
+   * Returns the scale currently considered the best.
+   */
+  double getTunedScale() const;
+
+ private:
+
+  // Starts measuring the efficiency of the next candidate scale.
+  void startWindow(const State& state);
+
+  // Records the measurement of the current window and moves the search on.
+  void finishWindow(const State& state);
+
+  std::shared_ptr<Controller> controller_;
+  std::function<RealType(State)> integrand_;
+  long windowIterations_;
+  bool freezeOnEnd_;
+
+  const Pdmp* observedPdmp_ = nullptr;
+  Timer timer_;
+  long windowIteration_{0};
+  std::unique_ptr<BatchMeans<Pdmp, State, Flow>> batchMeans_;
+  std::unique_ptr<BatchMeans<Pdmp, State, Flow>> squaredBatchMeans_;
+
+  // The running integrals of the integrand and its square over all the
+  // finished windows.
+  double totalTrajectoryLength_{0.0};
+  double integratedValue_{0.0};
+  double integratedSquaredValue_{0.0};
+
+  // The compass search state, in log-scale.
+  double logScale_{0.0};
+  double logStep_;
+  int candidateIndex_{0};
+  std::vector<double> candidateEfficiencies_;
+
+  std::vector<RefreshRateTuningStep> tuningTrace_;
+
+};
+
+}
+}
+
+#include "refresh_rate_adapter.tcc"
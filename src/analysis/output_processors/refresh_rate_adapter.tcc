@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace pdmp {
+namespace analysis {
+
+namespace {
+
+// The offsets from the current log-scale, evaluated in this order.
+double getCandidateOffset(int candidateIndex, double logStep) {
+  return candidateIndex == 0 ? 0.0 : (candidateIndex == 1 ? logStep : -logStep);
+}
+
+}
+
+template<class Pdmp, class State, class Flow, class Controller, class Timer>
+RefreshRateAdapter<Pdmp, State, Flow, Controller, Timer>::RefreshRateAdapter(
+  std::shared_ptr<Controller> controller,
+  std::function<RealType(State)> integrand,
+  long windowIterations,
+  double initialStep,
+  bool freezeOnEnd)
+  : controller_(controller),
+    integrand_(integrand),
+    windowIterations_(windowIterations),
+    freezeOnEnd_(freezeOnEnd),
+    timer_(Timer::getTimer()),
+    logScale_(log(controller->getScale())),
+    logStep_(log(initialStep)),
+    candidateEfficiencies_(3, 0.0) {
+
+  if (windowIterations <= 0) {
+    throw std::invalid_argument(
+      "Tuning window should have a positive number of iterations, but has "
+      + std::to_string(windowIterations) + ".");
+  }
+  if (!(initialStep > 1.0)) {
+    throw std::invalid_argument(
+      "Initial refresh rate scale step should be greater than 1, but is "
+      + std::to_string(initialStep) + ".");
+  }
+}
+
+template<class Pdmp, class State, class Flow, class Controller, class Timer>
+void RefreshRateAdapter<Pdmp, State, Flow, Controller, Timer>::
+  notifyProcessBegins(const Pdmp& pdmp, const State& initialState) {
+
+  observedPdmp_ = &pdmp;
+  startWindow(initialState);
+  timer_.start();
+}
+
+template<class Pdmp, class State, class Flow, class Controller, class Timer>
+void RefreshRateAdapter<Pdmp, State, Flow, Controller, Timer>::
+  notifyIterationResult(const IterationResult<State>& iterationResult) {
+
+  // The timer runs only between the notifications, so it does not include
+  // the time spent on the batch means.
+  timer_.stop();
+  batchMeans_->notifyIterationResult(iterationResult);
+  squaredBatchMeans_->notifyIterationResult(iterationResult);
+  windowIteration_++;
+  if (windowIteration_ == windowIterations_) {
+    finishWindow(iterationResult.state);
+  }
+  timer_.start();
+}
+
+template<class Pdmp, class State, class Flow, class Controller, class Timer>
+void RefreshRateAdapter<Pdmp, State, Flow, Controller, Timer>::
+  notifyProcessEnded() {
+
+  // The last, unfinished window is discarded.
+  controller_->setScale(getTunedScale());
+  if (freezeOnEnd_) {
+    controller_->freeze();
+  }
+}
+
+template<class Pdmp, class State, class Flow, class Controller, class Timer>
+auto RefreshRateAdapter<Pdmp, State, Flow, Controller, Timer>::
+  getTuningTrace() const -> const std::vector<RefreshRateTuningStep>& {
+
+  return tuningTrace_;
+}
+
+template<class Pdmp, class State, class Flow, class Controller, class Timer>
+double RefreshRateAdapter<Pdmp, State, Flow, Controller, Timer>::
+  getTunedScale() const {
+
+  return exp(logScale_);
+}
+
+template<class Pdmp, class State, class Flow, class Controller, class Timer>
+void RefreshRateAdapter<Pdmp, State, Flow, Controller, Timer>::startWindow(
+  const State& state) {
+
+  controller_->setScale(
+    exp(logScale_ + getCandidateOffset(candidateIndex_, logStep_)));
+  auto integrand = integrand_;
+  batchMeans_ = std::make_unique<BatchMeans<Pdmp, State, Flow>>(integrand);
+  squaredBatchMeans_ = std::make_unique<BatchMeans<Pdmp, State, Flow>>(
+    [integrand] (const State& state) {
+      RealType value = integrand(state);
+      return value * value;
+    });
+  batchMeans_->notifyProcessBegins(*observedPdmp_, state);
+  squaredBatchMeans_->notifyProcessBegins(*observedPdmp_, state);
+  windowIteration_ = 0;
+  timer_.reset();
+}
+
+template<class Pdmp, class State, class Flow, class Controller, class Timer>
+void RefreshRateAdapter<Pdmp, State, Flow, Controller, Timer>::finishWindow(
+  const State& state) {
+
+  double trajectoryLength = 0.0;
+  for (const auto& batch : batchMeans_->getBatches()) {
+    trajectoryLength += batch.trajectoryLength;
+  }
+  // The mean and variance are estimated from all the windows, since a badly
+  // mixing window can look stationary around its own mean.
+  totalTrajectoryLength_ += trajectoryLength;
+  integratedValue_ += batchMeans_->estimateMean() * trajectoryLength;
+  integratedSquaredValue_ +=
+    squaredBatchMeans_->estimateMean() * trajectoryLength;
+  const double mean = integratedValue_ / totalTrajectoryLength_;
+  const double variance = std::max(
+    0.0, integratedSquaredValue_ / totalTrajectoryLength_ - mean * mean);
+  const double asymptoticVariance =
+    batchMeans_->estimateAsymptoticVariance(mean);
+  double effectiveSampleSize = trajectoryLength * variance / asymptoticVariance;
+  if (!std::isfinite(effectiveSampleSize)) {
+    // Too few batches to estimate the asymptotic variance.
+    effectiveSampleSize = 0.0;
+  }
+  const double seconds = std::max(1L, timer_.getTimeInMs()) / 1000.0;
+
+  const double efficiency = effectiveSampleSize / seconds;
+  tuningTrace_.push_back(RefreshRateTuningStep{
+    controller_->getScale(), windowIteration_, trajectoryLength, seconds,
+    effectiveSampleSize, efficiency});
+
+  candidateEfficiencies_[candidateIndex_] = efficiency;
+  candidateIndex_++;
+  if (candidateIndex_ == candidateEfficiencies_.size()) {
+    const int best = std::max_element(
+      candidateEfficiencies_.begin(), candidateEfficiencies_.end())
+      - candidateEfficiencies_.begin();
+    if (best == 0) {
+      logStep_ /= 2.0;
+    }
+    logScale_ += getCandidateOffset(best, logStep_);
+    candidateIndex_ = 0;
+  }
+  startWindow(state);
+}
+
+}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace pdmp {
+namespace analysis {
+
+/**
+ * A class for running many independent chains (e.g. Pdmps driven by a
+ * PdmpRunner) on a persistent pool of threads, which can be reused for
+ * several batches of chains.
+ *
+ * The chains of a batch are dealt out to per-thread queues, and a thread
+ * which runs out of chains steals from the back of the other queues, so
+ * chains of different lengths keep all threads busy. Each chain gets its
+ * own random number generator, seeded by the seed of the batch and the
+ * chain id, so a batch is reproducible whatever the number of threads.
+ */
+class ParallelChainRunner {
+
+ public:
+
+  /**
+   * @param numberOfThreads
+   *   The number of threads running the chains.
+   * @param shouldPinThreads
+   *   If true, each thread is pinned to its own CPU (only on Linux), to
+   *   keep the chain's data in that CPU's caches.
+   */
+  explicit ParallelChainRunner(
+    int numberOfThreads, bool shouldPinThreads = false);
+
+  ~ParallelChainRunner();
+
+  ParallelChainRunner(const ParallelChainRunner&) = delete;
+  ParallelChainRunner& operator=(const ParallelChainRunner&) = delete;
+
+  int getNumberOfThreads() const;
+
+  /**
+   * Runs chain(chainId, rng) for each chainId = 0, ..., numberOfChains - 1,
+   * where rng is the random number generator of the chain (see
+   * getChainRng), and returns their results in the order of the chain
+   * ids. The results are default constructed in advance, and each chain
+   * writes its own. If a chain throws, the chains not yet started are
+   * skipped and the exception is rethrown here. Batches given from several
+   * threads at once are run one after another. A chain must not call
+   * runChains of the same runner, which throws std::logic_error.
+   */
+  template<class Chain>
+  auto runChains(const Chain& chain, int numberOfChains, std::uint64_t seed);
+
+  /**
+   * Runs the chains with a random seed.
+   */
+  template<class Chain>
+  auto runChains(const Chain& chain, int numberOfChains);
+
+  /**
+   * Returns the random number generator of the given chain of a batch run
+   * with the given seed.
+   */
+  static std::mt19937_64 getChainRng(std::uint64_t seed, int chainId);
+
+ private:
+
+  struct ChainQueue {
+    std::mutex mutex;
+    std::deque<int> chainIds;
+  };
+
+  // Runs task(chainId) for each chain on the threads, and waits for them.
+  // Holds batchMutex_ for the whole batch.
+  void runTasks(int numberOfChains, const std::function<void(int)>& task);
+
+  // Takes the next chain from the front of the own queue, or steals one
+  // from the back of another queue. Returns false if there are none left.
+  bool takeChain(int threadId, int* chainId);
+
+  void worker(int threadId);
+
+  void pinToCpu(int threadId);
+
+  const bool shouldPinThreads_;
+  std::vector<std::unique_ptr<ChainQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::mutex batchMutex_;
+  std::mutex mutex_;
+  std::condition_variable batchStarted_;
+  std::condition_variable batchFinished_;
+
+  // The current batch, guarded by mutex_.
+  const std::function<void(int)>* task_{nullptr};
+  long batchId_{0};
+  int numberOfUnfinishedChains_{0};
+  bool isStopping_{false};
+  std::exception_ptr exception_;
+
+};
+
+}
+}
+
+#include "parallel_chain_runner.tcc"
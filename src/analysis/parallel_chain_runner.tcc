@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace pdmp {
+namespace analysis {
+
+ParallelChainRunner::ParallelChainRunner(
+  int numberOfThreads, bool shouldPinThreads)
+  : shouldPinThreads_(shouldPinThreads) {
+
+  if (numberOfThreads < 1) {
+    throw std::invalid_argument(
+      "The number of threads should be positive, but "
+      + std::to_string(numberOfThreads) + " was given.");
+  }
+  for (int i = 0; i < numberOfThreads; i++) {
+    queues_.push_back(std::make_unique<ChainQueue>());
+  }
+  for (int i = 0; i < numberOfThreads; i++) {
+    threads_.emplace_back(&ParallelChainRunner::worker, this, i);
+  }
+}
+
+ParallelChainRunner::~ParallelChainRunner() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    isStopping_ = true;
+  }
+  batchStarted_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+int ParallelChainRunner::getNumberOfThreads() const {
+  return threads_.size();
+}
+
+template<class Chain>
+auto ParallelChainRunner::runChains(
+  const Chain& chain, int numberOfChains, std::uint64_t seed) {
+
+  using Result = std::decay_t<decltype(
+    chain(0, std::declval<std::mt19937_64&>()))>;
+  std::vector<Result> results(numberOfChains);
+  std::function<void(int)> task =
+    [&chain, &results, seed] (int chainId) {
+      std::mt19937_64 rng = getChainRng(seed, chainId);
+      results[chainId] = chain(chainId, rng);
+    };
+  runTasks(numberOfChains, task);
+  return results;
+}
+
+template<class Chain>
+auto ParallelChainRunner::runChains(const Chain& chain, int numberOfChains) {
+  std::random_device randomDevice;
+  const std::uint64_t seed =
+    (static_cast<std::uint64_t>(randomDevice()) << 32) | randomDevice();
+  return runChains(chain, numberOfChains, seed);
+}
+
+std::mt19937_64 ParallelChainRunner::getChainRng(
+  std::uint64_t seed, int chainId) {
+
+  std::seed_seq seedSequence{
+    static_cast<std::uint32_t>(seed),
+    static_cast<std::uint32_t>(seed >> 32),
+    static_cast<std::uint32_t>(chainId)};
+  return std::mt19937_64(seedSequence);
+}
+
+void ParallelChainRunner::runTasks(
+  int numberOfChains, const std::function<void(int)>& task) {
+
+  for (const auto& thread : threads_) {
+    if (thread.get_id() == std::this_thread::get_id()) {
+      throw std::logic_error(
+        "A chain can not run chains on its own ParallelChainRunner.");
+    }
+  }
+  if (numberOfChains <= 0) {
+    return;
+  }
+  // The batch state below is shared by all the batches, so concurrent
+  // batches have to wait for the running one to finish.
+  std::lock_guard<std::mutex> batchLock(batchMutex_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (int chainId = 0; chainId < numberOfChains; chainId++) {
+    auto& queue = *queues_[chainId % queues_.size()];
+    std::lock_guard<std::mutex> queueLock(queue.mutex);
+    queue.chainIds.push_back(chainId);
+  }
+  task_ = &task;
+  numberOfUnfinishedChains_ = numberOfChains;
+  exception_ = nullptr;
+  batchId_++;
+  batchStarted_.notify_all();
+  batchFinished_.wait(lock, [this] () {
+    return numberOfUnfinishedChains_ == 0;
+  });
+  task_ = nullptr;
+  if (exception_) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+bool ParallelChainRunner::takeChain(int threadId, int* chainId) {
+  {
+    auto& queue = *queues_[threadId];
+    std::lock_guard<std::mutex> queueLock(queue.mutex);
+    if (!queue.chainIds.empty()) {
+      *chainId = queue.chainIds.front();
+      queue.chainIds.pop_front();
+      return true;
+    }
+  }
+  for (int i = 1; i < queues_.size(); i++) {
+    auto& queue = *queues_[(threadId + i) % queues_.size()];
+    std::lock_guard<std::mutex> queueLock(queue.mutex);
+    if (!queue.chainIds.empty()) {
+      *chainId = queue.chainIds.back();
+      queue.chainIds.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ParallelChainRunner::worker(int threadId) {
+  if (shouldPinThreads_) {
+    pinToCpu(threadId);
+  }
+  long lastBatchId = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      batchStarted_.wait(lock, [this, lastBatchId] () {
+        return isStopping_ || batchId_ != lastBatchId;
+      });
+      if (isStopping_) {
+        return;
+      }
+      lastBatchId = batchId_;
+    }
+    int chainId;
+    while (takeChain(threadId, &chainId)) {
+      const std::function<void(int)>* task;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task = exception_ ? nullptr : task_;
+      }
+      std::exception_ptr exception;
+      if (task) {
+        try {
+          (*task)(chainId);
+        } catch (...) {
+          exception = std::current_exception();
+        }
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (exception && !exception_) {
+        exception_ = exception;
+      }
+      if (--numberOfUnfinishedChains_ == 0) {
+        batchFinished_.notify_one();
+      }
+    }
+  }
+}
+
+void ParallelChainRunner::pinToCpu(int threadId) {
+#ifdef __linux__
+  const int numberOfCpus =
+    std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(threadId % numberOfCpus, &cpuSet);
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+#endif
+}
+
+}
+}
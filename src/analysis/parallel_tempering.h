@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "analysis/pdmp_runner.h"
+#include "core/pdmp.h"
+#include "core/thread_pool.h"
+
+namespace pdmp {
+namespace analysis {
+
+/**
+ * The swap acceptance rates and the throughput of a ParallelTempering run.
+ */
+struct ParallelTemperingReport {
+
+  struct Replica {
+    double inverseTemperature;
+    // The number of events simulated by the replica's PDMP.
+    long numberOfEvents;
+    // The wall-clock time spent simulating the replica, in seconds.
+    double simulationTime;
+    double eventsPerSecond;
+  };
+
+  // The swaps proposed between the replicas k and k + 1.
+  struct Exchange {
+    long numberOfProposals;
+    long numberOfAcceptances;
+    double acceptanceRate;
+  };
+
+  std::vector<Replica> replicas;
+  std::vector<Exchange> exchanges;
+
+};
+
+/**
+ * A replica-exchange (parallel tempering) driver, for multimodal targets
+ * between whose modes a single chain rarely moves.
+ *
+ * Replica k is a PDMP targeting pi^beta_k, for the decreasing inverse
+ * temperatures 1 = beta_0 > beta_1 > ... > beta_{K-1} > 0 (e.g. built by a
+ * BpsBuilder or ZigZagBuilder after setInverseTemperature(beta_k)). The
+ * replicas are simulated on a thread pool for a fixed trajectory time
+ * between exchanges. At each exchange, the states of every other pair of
+ * neighbouring replicas (alternately the pairs starting at even and at odd
+ * k) are swapped with the probability
+ *   min(1, exp((beta_k - beta_{k+1}) (log pi(x_{k+1}) - log pi(x_k)))).
+ * The whole states are swapped, as the velocities have the same
+ * distribution at all temperatures. The exchanges are done by the calling
+ * thread between the simulation rounds, so the replicas never lock each
+ * other, and a run with the same seed and reproducible replicas gives the
+ * same result with any number of threads.
+ *
+ * Only the trajectory of the beta = 1 replica is passed to the observers,
+ * with an accepted swap appearing as a jump at the time of the exchange.
+ * The observers are notified on one of the pool's threads, but never
+ * concurrently.
+ */
+template<class Pdmp, class State>
+class ParallelTempering {
+
+ public:
+
+  using ObserverPtr = ObserverBase<Pdmp, State>*;
+
+  // Returns a PDMP targeting pi^beta for the given inverse temperature beta.
+  using ReplicaFactory = std::function<Pdmp(double inverseTemperature)>;
+
+  // Returns log pi of the given state, up to an additive constant.
+  using LogDensity = std::function<double(const State& state)>;
+
+  /**
+   * @param createReplica
+   *   Called once per inverse temperature, in order, to create the replicas.
+   * @param inverseTemperatures
+   *   The decreasing inverse temperatures in (0, 1], starting with 1.
+   * @param logDensity
+   *   The untempered log density of the target.
+   * @param exchangeInterval
+   *   The trajectory time between two exchanges.
+   * @param numberOfThreads
+   *   The number of threads simulating the replicas.
+   * @param seed
+   *   The seed of the swap decisions.
+   */
+  ParallelTempering(
+    const ReplicaFactory& createReplica,
+    const std::vector<double>& inverseTemperatures,
+    const LogDensity& logDensity,
+    double exchangeInterval,
+    int numberOfThreads,
+    std::uint64_t seed);
+
+  int getNumberOfReplicas() const;
+
+  /**
+   * Registers an observer of the beta = 1 replica.
+   */
+  void registerAnObserver(ObserverPtr observer);
+
+  /**
+   * Simulates the replicas from the given initial states (one per replica,
+   * in the order of the inverse temperatures) for the given trajectory
+   * time. Each run starts anew, including the report.
+   */
+  void run(const std::vector<State>& initialStates, double time);
+
+  /**
+   * Simulates the replicas, all starting from the given state.
+   */
+  void run(const State& initialState, double time);
+
+  /**
+   * Returns the state of the given replica at the end of the last run.
+   */
+  State getState(int replicaId) const;
+
+  ParallelTemperingReport getReport() const;
+
+ private:
+
+  struct Replica {
+    Pdmp pdmp;
+    // The state after the last simulated event, and the time of the event.
+    State state;
+    double time{0.0};
+    // The next iteration, simulated but not reached by the last round.
+    std::unique_ptr<IterationResult<State>> nextIteration;
+    long numberOfEvents{0};
+    double simulationTime{0.0};
+  };
+
+  // Simulates the events of the replica up to the given time.
+  void advanceReplica(int replicaId, double untilTime);
+
+  // Proposes the swaps of the given round at the given time.
+  void exchangeStates(int round, double time);
+
+  std::vector<double> inverseTemperatures_;
+  LogDensity logDensity_;
+  double exchangeInterval_;
+  std::mt19937_64 rng_;
+
+  std::vector<Replica> replicas_;
+  std::vector<long> numberOfProposals_;
+  std::vector<long> numberOfAcceptances_;
+  double endTime_{0.0};
+
+  std::vector<ObserverPtr> observers_;
+  std::unique_ptr<ThreadPool> threadPool_;
+
+};
+
+}
+}
+
+#include "parallel_tempering.tcc"
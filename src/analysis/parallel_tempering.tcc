@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace pdmp {
+namespace analysis {
+
+template<class Pdmp, class State>
+ParallelTempering<Pdmp, State>::ParallelTempering(
+  const ReplicaFactory& createReplica,
+  const std::vector<double>& inverseTemperatures,
+  const LogDensity& logDensity,
+  double exchangeInterval,
+  int numberOfThreads,
+  std::uint64_t seed)
+  : inverseTemperatures_(inverseTemperatures),
+    logDensity_(logDensity),
+    exchangeInterval_(exchangeInterval),
+    rng_(seed) {
+
+  if (inverseTemperatures.empty() || inverseTemperatures[0] != 1.0) {
+    throw std::invalid_argument(
+      "The first inverse temperature should be 1.");
+  }
+  for (int k = 1; k < inverseTemperatures.size(); k++) {
+    if (!(inverseTemperatures[k] > 0.0
+          && inverseTemperatures[k] < inverseTemperatures[k - 1])) {
+      throw std::invalid_argument(
+        "The inverse temperatures should be positive and decreasing, but "
+        + std::to_string(inverseTemperatures[k]) + " follows "
+        + std::to_string(inverseTemperatures[k - 1]) + ".");
+    }
+  }
+  if (!(exchangeInterval > 0.0)) {
+    throw std::invalid_argument(
+      "The exchange interval should be positive, but is "
+      + std::to_string(exchangeInterval) + ".");
+  }
+  if (numberOfThreads < 1) {
+    throw std::invalid_argument(
+      "The number of threads should be positive, but "
+      + std::to_string(numberOfThreads) + " was given.");
+  }
+  for (double inverseTemperature : inverseTemperatures) {
+    replicas_.push_back(Replica{createReplica(inverseTemperature)});
+  }
+  numberOfProposals_.resize(replicas_.size() - 1, 0);
+  numberOfAcceptances_.resize(replicas_.size() - 1, 0);
+  threadPool_ = std::make_unique<ThreadPool>(numberOfThreads);
+}
+
+template<class Pdmp, class State>
+int ParallelTempering<Pdmp, State>::getNumberOfReplicas() const {
+  return replicas_.size();
+}
+
+template<class Pdmp, class State>
+void ParallelTempering<Pdmp, State>::registerAnObserver(ObserverPtr observer) {
+  observers_.push_back(observer);
+}
+
+template<class Pdmp, class State>
+void ParallelTempering<Pdmp, State>::run(
+  const std::vector<State>& initialStates, double time) {
+
+  if (initialStates.size() != replicas_.size()) {
+    throw std::invalid_argument(
+      "Got " + std::to_string(initialStates.size()) + " initial states for "
+      + std::to_string(replicas_.size()) + " replicas.");
+  }
+  if (time < 0.0) {
+    throw std::invalid_argument(
+      "The simulation time should be non-negative, but is "
+      + std::to_string(time) + ".");
+  }
+  for (int k = 0; k < replicas_.size(); k++) {
+    Replica& replica = replicas_[k];
+    replica.pdmp.resetEvents();
+    replica.state = initialStates[k];
+    replica.time = 0.0;
+    replica.nextIteration.reset();
+    replica.numberOfEvents = 0;
+    replica.simulationTime = 0.0;
+  }
+  std::fill(numberOfProposals_.begin(), numberOfProposals_.end(), 0);
+  std::fill(numberOfAcceptances_.begin(), numberOfAcceptances_.end(), 0);
+  endTime_ = time;
+
+  for (const auto& observer : observers_) {
+    observer->notifyProcessBegins(replicas_[0].pdmp, initialStates[0]);
+  }
+  for (int round = 0; ; round++) {
+    const double untilTime = std::min(time, (round + 1) * exchangeInterval_);
+    threadPool_->parallelFor(
+      replicas_.size(),
+      [this, untilTime] (int replicaId) {
+        this->advanceReplica(replicaId, untilTime);
+      });
+    if (untilTime >= time) {
+      break;
+    }
+    this->exchangeStates(round, untilTime);
+  }
+  for (const auto& observer : observers_) {
+    observer->notifyProcessEnded();
+  }
+}
+
+template<class Pdmp, class State>
+void ParallelTempering<Pdmp, State>::run(
+  const State& initialState, double time) {
+
+  this->run(std::vector<State>(replicas_.size(), initialState), time);
+}
+
+template<class Pdmp, class State>
+State ParallelTempering<Pdmp, State>::getState(int replicaId) const {
+  if (replicaId < 0 || replicaId >= replicas_.size()) {
+    throw std::out_of_range(
+      "Replica id " + std::to_string(replicaId) + " is out of range.");
+  }
+  const Replica& replica = replicas_[replicaId];
+  return replica.pdmp.advanceStateByFlow(
+    replica.state, endTime_ - replica.time);
+}
+
+template<class Pdmp, class State>
+ParallelTemperingReport ParallelTempering<Pdmp, State>::getReport() const {
+  ParallelTemperingReport report;
+  for (int k = 0; k < replicas_.size(); k++) {
+    const Replica& replica = replicas_[k];
+    report.replicas.push_back(ParallelTemperingReport::Replica{
+      inverseTemperatures_[k],
+      replica.numberOfEvents,
+      replica.simulationTime,
+      replica.simulationTime > 0.0
+        ? replica.numberOfEvents / replica.simulationTime : 0.0});
+  }
+  for (int k = 0; k + 1 < replicas_.size(); k++) {
+    report.exchanges.push_back(ParallelTemperingReport::Exchange{
+      numberOfProposals_[k],
+      numberOfAcceptances_[k],
+      numberOfProposals_[k] > 0
+        ? static_cast<double>(numberOfAcceptances_[k]) / numberOfProposals_[k]
+        : 0.0});
+  }
+  return report;
+}
+
+template<class Pdmp, class State>
+void ParallelTempering<Pdmp, State>::advanceReplica(
+  int replicaId, double untilTime) {
+
+  const auto startTime = std::chrono::steady_clock::now();
+  Replica& replica = replicas_[replicaId];
+  while (true) {
+    if (!replica.nextIteration) {
+      replica.nextIteration = std::make_unique<IterationResult<State>>(
+        replica.pdmp.simulateOneIteration(replica.state));
+    }
+    if (replica.time + replica.nextIteration->iterationTime > untilTime) {
+      break;
+    }
+    if (replicaId == 0) {
+      for (const auto& observer : observers_) {
+        observer->notifyIterationResult(*replica.nextIteration);
+      }
+    }
+    replica.time += replica.nextIteration->iterationTime;
+    replica.state = std::move(replica.nextIteration->state);
+    replica.nextIteration.reset();
+    replica.numberOfEvents++;
+  }
+  replica.simulationTime += std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - startTime).count();
+}
+
+template<class Pdmp, class State>
+void ParallelTempering<Pdmp, State>::exchangeStates(int round, double time) {
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  for (int k = round % 2; k + 1 < replicas_.size(); k += 2) {
+    Replica& colder = replicas_[k];
+    Replica& hotter = replicas_[k + 1];
+    State colderState =
+      colder.pdmp.advanceStateByFlow(colder.state, time - colder.time);
+    State hotterState =
+      hotter.pdmp.advanceStateByFlow(hotter.state, time - hotter.time);
+    const double logAcceptanceRatio =
+      (inverseTemperatures_[k] - inverseTemperatures_[k + 1])
+      * (logDensity_(hotterState) - logDensity_(colderState));
+    numberOfProposals_[k]++;
+    if (std::log(unif(rng_)) >= logAcceptanceRatio) {
+      continue;
+    }
+    numberOfAcceptances_[k]++;
+    if (k == 0) {
+      // The swap is a jump of the observed trajectory.
+      IterationResult<State> swap(hotterState, time - colder.time);
+      for (const auto& observer : observers_) {
+        observer->notifyIterationResult(swap);
+      }
+    }
+    // The pending events were simulated for the previous states.
+    colder.state = std::move(hotterState);
+    hotter.state = std::move(colderState);
+    for (Replica* replica : {&colder, &hotter}) {
+      replica->pdmp.resetEvents();
+      replica->time = time;
+      replica->nextIteration.reset();
+    }
+  }
+}
+
+}
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <set>
 #include <vector>
@@ -31,6 +32,26 @@ class DependenciesGraph {
     const VariableNodes& variableNodes,
     const FactorNodes& factorNodes);
 
+  /**
+   * Creates a graph with the given Markov kernel and factor nodes, which
+   * shares the variable nodes, the cached factor dependencies and the hub
+   * threshold of the given graph, e.g. for another chain of the same model,
+   * whose nodes keep their own lambda state. The graphs can be used
+   * concurrently once all the factor dependencies are cached (see
+   * cacheAllFactorDependencies).
+   */
+  DependenciesGraph(
+    const DependenciesGraph& graph,
+    const MarkovKernelNodes& markovKernelNodes,
+    const FactorNodes& factorNodes);
+
+  /**
+   * Computes and caches the dependencies of all the factors, after which
+   * the graph is no longer modified by the getters.
+   */
+  template<class Flow = LinearFlow>
+  void cacheAllFactorDependencies();
+
   /**
    * Returns ids of factors, dependent on a given factor.
    *
@@ -50,19 +71,52 @@ class DependenciesGraph {
   template<class Flow = LinearFlow>
   const std::vector<int>& getFactorDependencies(int factorId);
 
+  /**
+   * Returns ids of factors, dependent on any of the given variables, either
+   * directly or through the Flow. Unlike getFactorDependencies, the result
+   * is not cached.
+   */
+  template<class Flow = LinearFlow>
+  std::vector<int> getFactorDependenciesOfVariables(
+    const std::vector<int>& variableIds) const;
+
+  /**
+   * Sets the number of dependent factors, from which on a factor is
+   * considered a hub factor (usually one whose Markov kernel modifies a
+   * variable shared by many factors, e.g. a global hyperparameter).
+   * By default, no factor is a hub factor.
+   */
+  void setHubThreshold(int numberOfDependentFactors);
+
+  /**
+   * Returns true, if the events of the given factor require resimulating at
+   * least as many factors as the hub threshold.
+   */
+  template<class Flow = LinearFlow>
+  bool isHubFactor(int factorId);
+
   const MarkovKernelNodes markovKernelNodes;
   const VariableNodes variableNodes;
   const FactorNodes factorNodes;
 
  private:
 
-  // A bool array, specifying if factor dependencies for i-th factor
-  // were already cached.
-  std::vector<bool> areFactorDependenciesCached_;
+  struct FactorDependenciesCache {
+
+    // A bool array, specifying if factor dependencies for i-th factor
+    // were already cached.
+    std::vector<bool> areFactorDependenciesCached;
+
+    // Once we calculate dependencies for a given factor, we cache the
+    // results here.
+    std::vector<std::vector<int>> factorDependencies;
+
+  };
+
+  // Shared by the graphs created from this one.
+  std::shared_ptr<FactorDependenciesCache> factorDependenciesCache_;
 
-  // Once we calculate dependencies for a given factor, we cache the
-  // results here.
-  std::vector<std::vector<int>> factorDependenciesCache_;
+  int hubThreshold_{std::numeric_limits<int>::max()};
 
 };
 
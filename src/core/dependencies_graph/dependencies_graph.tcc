@@ -13,21 +13,16 @@ constexpr void checkFactorIdBounds(int factorId, int maxId) {
     : 0;
 }
 
-// A helper method for caching factor dependencies.
+// A helper method for finding the factors, which depend on any of the given
+// variables, or on the variables depending on them through the Flow.
 template<class Flow, class Graph>
-std::vector<int> computeFactorDependencies(int factorId, const Graph& graph) {
-  std::set<int> variableDependencies;
-
-  // First add all variable ids, that are modified by the current markov kernel.
-  auto markovKernelNode = graph.markovKernelNodes[factorId];
-  for (const int& id : markovKernelNode->dependentVariableIds) {
-    variableDependencies.insert(id);
-  }
+std::vector<int> computeFactorDependenciesOfVariables(
+  const std::vector<int>& variableIds, const Graph& graph) {
 
-  // Now expand the dependencies set, based on the Flow policy used.
+  // Expand the dependencies set, based on the Flow policy used.
   const int stateSpaceDim = graph.variableNodes.size();
   std::set<int> variableToVariableDependencies;
-  for (const int& depVar : variableDependencies) {
+  for (const int& depVar : variableIds) {
     for (const int& id : Flow::getDependentVariableIds(depVar, stateSpaceDim)) {
       variableToVariableDependencies.insert(id);
     }
@@ -47,6 +42,23 @@ std::vector<int> computeFactorDependencies(int factorId, const Graph& graph) {
   return dependenciesVector;
 }
 
+// A helper method for caching factor dependencies.
+template<class Flow, class Graph>
+std::vector<int> computeFactorDependencies(int factorId, const Graph& graph) {
+  std::set<int> variableDependencies;
+
+  // First add all variable ids, that are modified by the current markov kernel.
+  auto markovKernelNode = graph.markovKernelNodes[factorId];
+  for (const int& id : markovKernelNode->dependentVariableIds) {
+    variableDependencies.insert(id);
+  }
+
+  return computeFactorDependenciesOfVariables<Flow>(
+    std::vector<int>(
+      std::begin(variableDependencies), std::end(variableDependencies)),
+    graph);
+}
+
 }
 
 namespace pdmp {
@@ -61,14 +73,49 @@ DependenciesGraph<MarkovKernelNode_t, VariableNode_t, FactorNode_t>
   : markovKernelNodes(markovKernelNodes),
     variableNodes(variableNodes),
     factorNodes(factorNodes),
-    areFactorDependenciesCached_(factorNodes.size(), false),
-    factorDependenciesCache_(factorNodes.size(), std::vector<int>()) {
+    factorDependenciesCache_(std::make_shared<FactorDependenciesCache>()) {
 
   if (factorNodes.size() != markovKernelNodes.size()) {
     throw std::runtime_error(
       "Trying to create a dependencies graph with different number of factor "
       "and Markov kernel nodes.");
   }
+  factorDependenciesCache_->areFactorDependenciesCached.resize(
+    factorNodes.size(), false);
+  factorDependenciesCache_->factorDependencies.resize(factorNodes.size());
+}
+
+template<class MarkovKernelNode_t, class VariableNode_t, class FactorNode_t>
+DependenciesGraph<MarkovKernelNode_t, VariableNode_t, FactorNode_t>
+  ::DependenciesGraph(
+    const DependenciesGraph& graph,
+    const MarkovKernelNodes& markovKernelNodes,
+    const FactorNodes& factorNodes)
+  : markovKernelNodes(markovKernelNodes),
+    variableNodes(graph.variableNodes),
+    factorNodes(factorNodes),
+    factorDependenciesCache_(graph.factorDependenciesCache_),
+    hubThreshold_(graph.hubThreshold_) {
+
+  if (factorNodes.size() != graph.factorNodes.size()
+      || markovKernelNodes.size() != graph.markovKernelNodes.size()) {
+    throw std::runtime_error(
+      "Trying to create a dependencies graph sharing the dependencies of a "
+      "graph with " + std::to_string(graph.factorNodes.size())
+      + " factors, but " + std::to_string(factorNodes.size())
+      + " factor and " + std::to_string(markovKernelNodes.size())
+      + " Markov kernel nodes were given.");
+  }
+}
+
+template<class MarkovKernelNode_t, class VariableNode_t, class FactorNode_t>
+template<class Flow>
+void DependenciesGraph<MarkovKernelNode_t, VariableNode_t, FactorNode_t>
+  ::cacheAllFactorDependencies() {
+
+  for (int factorId = 0; factorId < factorNodes.size(); factorId++) {
+    getFactorDependencies<Flow>(factorId);
+  }
 }
 
 template<class MarkovKernelNode_t, class VariableNode_t, class FactorNode_t>
@@ -78,14 +125,44 @@ DependenciesGraph<MarkovKernelNode_t, VariableNode_t, FactorNode_t>
   ::getFactorDependencies(int factorId) {
 
   checkFactorIdBounds(factorId, factorNodes.size());
-  if (!areFactorDependenciesCached_[factorId]) {
-    factorDependenciesCache_[factorId] =
+  auto& cache = *factorDependenciesCache_;
+  if (!cache.areFactorDependenciesCached[factorId]) {
+    cache.factorDependencies[factorId] =
       computeFactorDependencies<Flow>(factorId, *this);
-    areFactorDependenciesCached_[factorId] = true;
+    cache.areFactorDependenciesCached[factorId] = true;
   }
-  return factorDependenciesCache_[factorId];
+  return cache.factorDependencies[factorId];
 }
 
+template<class MarkovKernelNode_t, class VariableNode_t, class FactorNode_t>
+template<class Flow>
+std::vector<int>
+DependenciesGraph<MarkovKernelNode_t, VariableNode_t, FactorNode_t>
+  ::getFactorDependenciesOfVariables(const std::vector<int>& variableIds) const {
+
+  return computeFactorDependenciesOfVariables<Flow>(variableIds, *this);
 }
+
+template<class MarkovKernelNode_t, class VariableNode_t, class FactorNode_t>
+void DependenciesGraph<MarkovKernelNode_t, VariableNode_t, FactorNode_t>
+  ::setHubThreshold(int numberOfDependentFactors) {
+
+  if (numberOfDependentFactors < 1) {
+    throw std::invalid_argument(
+      "The hub threshold should be positive, but "
+      + std::to_string(numberOfDependentFactors) + " was given.");
+  }
+  hubThreshold_ = numberOfDependentFactors;
 }
 
+template<class MarkovKernelNode_t, class VariableNode_t, class FactorNode_t>
+template<class Flow>
+bool DependenciesGraph<MarkovKernelNode_t, VariableNode_t, FactorNode_t>
+  ::isHubFactor(int factorId) {
+
+  return static_cast<int>(getFactorDependencies<Flow>(factorId).size())
+         >= hubThreshold_;
+}
+
+}
+}
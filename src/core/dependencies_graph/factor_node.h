@@ -2,6 +2,8 @@
 
 #include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "core/policies/linear_flow.h"
@@ -24,12 +26,19 @@ using PoissonProcessResultPtr = std::shared_ptr<PoissonProcessResultBase>;
 template<class State>
 struct FactorNodeBase {
   using RealType = typename State::RealType;
+  using Subvector = std::decay_t<decltype(std::declval<const State&>()
+    .getSubvector(std::declval<const std::vector<int>&>()))>;
   FactorNodeBase(const std::vector<int>& dependentVariableIds);
   ~FactorNodeBase() = default;
   virtual RealType evaluateIntensity(
     const State& state, const RealType& time) = 0;
   virtual PoissonProcessResultPtr getPoissonProcessResult(
     const State& state) = 0;
+  virtual PoissonProcessResultPtr getPoissonProcessResultOfSubvector(
+    const Subvector& stateSubvector, const State& state);
+  virtual std::shared_ptr<FactorNodeBase> getCopy() const;
+  virtual std::shared_ptr<FactorNodeBase> getCopyWithRemappedVariableIds(
+    const std::vector<int>& variableIdMap) const;
   const std::vector<int> dependentVariableIds;
 };
 
@@ -46,6 +55,7 @@ class FactorNode : public FactorNodeBase<State> {
  public:
 
   using RealType = typename FactorNodeBase<State>::RealType;
+  using Subvector = typename FactorNodeBase<State>::Subvector;
   static const int kStateSpaceDim = State::kStateSpaceDim;
 
   FactorNode(
@@ -66,6 +76,30 @@ class FactorNode : public FactorNodeBase<State> {
   virtual PoissonProcessResultPtr
     getPoissonProcessResult(const State& state) override final;
 
+  /**
+   * Get Poisson process simulation result for an already extracted
+   * subvector of the dependent variables, e.g. one extrapolated along the
+   * flow without advancing the whole state.
+   */
+  virtual PoissonProcessResultPtr getPoissonProcessResultOfSubvector(
+    const Subvector& stateSubvector,
+    const State& state) override final;
+
+  /**
+   * Returns a copy of this node, including the state of its lambdas (e.g.
+   * random number generators).
+   */
+  virtual std::shared_ptr<FactorNodeBase<State>> getCopy() const override final;
+
+  /**
+   * Returns a copy of this node, which depends on the variables with ids
+   * variableIdMap[id] instead of id. The order of the dependent variables
+   * is kept, so the lambdas are given the same subvectors.
+   */
+  virtual std::shared_ptr<FactorNodeBase<State>>
+    getCopyWithRemappedVariableIds(
+      const std::vector<int>& variableIdMap) const override final;
+
  private:
 
   PoissonProcessLambda poissonProcessLambda_;
@@ -9,6 +9,29 @@ FactorNodeBase<State>::FactorNodeBase(
   : dependentVariableIds(dependentVariableIds) {
 }
 
+template<class State>
+PoissonProcessResultPtr FactorNodeBase<State>
+  ::getPoissonProcessResultOfSubvector(const Subvector&, const State&) {
+
+  throw std::logic_error(
+    "Called unimplemented subvector Poisson process simulation of a factor "
+    "node.");
+}
+
+template<class State>
+std::shared_ptr<FactorNodeBase<State>> FactorNodeBase<State>::getCopy() const {
+  throw std::logic_error("Called unimplemented copying of a factor node.");
+}
+
+template<class State>
+std::shared_ptr<FactorNodeBase<State>>
+FactorNodeBase<State>::getCopyWithRemappedVariableIds(
+  const std::vector<int>&) const {
+
+  throw std::logic_error(
+    "Called unimplemented variable id remapping of a factor node.");
+}
+
 template<
   class State, class PoissonProcessLambda, class Flow, class IntensityLambda>
 FactorNode<State, PoissonProcessLambda, Flow, IntensityLambda>::FactorNode(
@@ -41,5 +64,40 @@ FactorNode<State, PoissonProcessLambda, Flow, IntensityLambda>
   return this->poissonProcessLambda_(stateSubvector, *this, state);
 }
 
+template<
+  class State, class PoissonProcessLambda, class Flow, class IntensityLambda>
+std::shared_ptr<FactorNodeBase<State>>
+FactorNode<State, PoissonProcessLambda, Flow, IntensityLambda>
+  ::getCopyWithRemappedVariableIds(
+    const std::vector<int>& variableIdMap) const {
+
+  std::vector<int> remappedIds;
+  remappedIds.reserve(this->dependentVariableIds.size());
+  for (int id : this->dependentVariableIds) {
+    remappedIds.push_back(variableIdMap.at(id));
+  }
+  return std::make_shared<FactorNode>(
+    remappedIds,
+    this->poissonProcessLambda_,
+    this->intensityLambda_);
+}
+
+template<
+  class State, class PoissonProcessLambda, class Flow, class IntensityLambda>
+PoissonProcessResultPtr
+FactorNode<State, PoissonProcessLambda, Flow, IntensityLambda>
+  ::getPoissonProcessResultOfSubvector(
+    const Subvector& stateSubvector, const State& state) {
+
+  return this->poissonProcessLambda_(stateSubvector, *this, state);
+}
+
+template<
+  class State, class PoissonProcessLambda, class Flow, class IntensityLambda>
+std::shared_ptr<FactorNodeBase<State>>
+FactorNode<State, PoissonProcessLambda, Flow, IntensityLambda>::getCopy() const {
+  return std::make_shared<FactorNode>(*this);
+}
+
 }
 }
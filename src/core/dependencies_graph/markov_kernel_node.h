@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace pdmp {
@@ -8,10 +10,19 @@ namespace dependencies_graph {
 
 template<class State>
 struct MarkovKernelNodeBase {
+  using Subvector = std::decay_t<decltype(
+    std::declval<const std::decay_t<State>&>()
+      .getSubvector(std::declval<const std::vector<int>&>()))>;
   MarkovKernelNodeBase(const std::vector<int>& dependentVariableIds);
   ~MarkovKernelNodeBase() = default;
   virtual State jump(const State& state) = 0;
   virtual std::decay_t<State> jump(State&& state) = 0;
+  virtual Subvector jumpSubvector(
+    const Subvector& stateSubvector) = 0;
+  virtual const std::vector<int>& getRequiredVariableIds() const = 0;
+  virtual std::shared_ptr<MarkovKernelNodeBase> getCopy() const = 0;
+  virtual std::shared_ptr<MarkovKernelNodeBase> getCopyWithRemappedVariableIds(
+    const std::vector<int>& variableIdMap) const = 0;
   const std::vector<int> dependentVariableIds;
 };
 
@@ -23,6 +34,9 @@ class MarkovKernelNode : public MarkovKernelNodeBase<State> {
 
  public:
 
+  using Subvector =
+    typename MarkovKernelNodeBase<State>::Subvector;
+
   /**
    * This constructor assumes, that this Markov kernel will only need
    * access to the variables that are going to be modified.
@@ -64,6 +78,35 @@ class MarkovKernelNode : public MarkovKernelNodeBase<State> {
    */
   virtual std::decay_t<State> jump(State&& state) override final;
 
+  /**
+   * Applies the Markov kernel jump on an already extracted subvector of the
+   * variables with ids getRequiredVariableIds(), and returns the modified
+   * subvector.
+   */
+  virtual Subvector jumpSubvector(
+    const Subvector& stateSubvector) override final;
+
+  /**
+   * Returns the ids of the variables passed to the jump kernel lambda.
+   */
+  virtual const std::vector<int>& getRequiredVariableIds() const override final;
+
+  /**
+   * Returns a copy of this node, including the state of its lambda (e.g.
+   * a random number generator).
+   */
+  virtual std::shared_ptr<MarkovKernelNodeBase<State>> getCopy()
+    const override final;
+
+  /**
+   * Returns a copy of this node, which modifies and accesses the variables
+   * with ids variableIdMap[id] instead of id. The order of the variables is
+   * kept, so the lambda is given the same subvectors.
+   */
+  virtual std::shared_ptr<MarkovKernelNodeBase<State>>
+    getCopyWithRemappedVariableIds(
+      const std::vector<int>& variableIdMap) const override final;
+
  private:
 
   Lambda lambda_;
@@ -47,5 +47,44 @@ std::decay_t<State> MarkovKernelNode<State, Lambda>::jump(State&& state) {
   return newState;
 }
 
+template<class State, class Lambda>
+typename MarkovKernelNode<State, Lambda>::Subvector
+MarkovKernelNode<State, Lambda>::jumpSubvector(
+  const Subvector& stateSubvector) {
+
+  return this->lambda_(stateSubvector);
+}
+
+template<class State, class Lambda>
+const std::vector<int>&
+MarkovKernelNode<State, Lambda>::getRequiredVariableIds() const {
+  return this->requiredVariableIdsForAccess_;
+}
+
+template<class State, class Lambda>
+std::shared_ptr<MarkovKernelNodeBase<State>>
+MarkovKernelNode<State, Lambda>::getCopy() const {
+  return std::make_shared<MarkovKernelNode>(*this);
+}
+
+template<class State, class Lambda>
+std::shared_ptr<MarkovKernelNodeBase<State>>
+MarkovKernelNode<State, Lambda>::getCopyWithRemappedVariableIds(
+  const std::vector<int>& variableIdMap) const {
+
+  auto remap = [&variableIdMap] (const std::vector<int>& variableIds) {
+    std::vector<int> remappedIds;
+    remappedIds.reserve(variableIds.size());
+    for (int id : variableIds) {
+      remappedIds.push_back(variableIdMap.at(id));
+    }
+    return remappedIds;
+  };
+  return std::make_shared<MarkovKernelNode>(
+    remap(this->dependentVariableIds),
+    this->lambda_,
+    remap(this->requiredVariableIdsForAccess_));
+}
+
 }
 }
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "core/policies/linear_flow_base.h"
+#include "core/policies/poisson_process.h"
+#include "core/thread_pool.h"
+
+namespace pdmp {
+namespace dependencies_graph {
+
+/**
+ * Counters of the work done by a PartitionedPdmp.
+ */
+struct PartitionedPdmpStatistics {
+
+  // The number of accepted events, which were kept.
+  long numberOfEvents{0};
+
+  // The number of those events, which affected more than one partition and
+  // were simulated sequentially.
+  long numberOfCrossPartitionEvents{0};
+
+  // The number of accepted events, which were simulated speculatively and
+  // later rolled back.
+  long numberOfRolledBackEvents{0};
+
+  // The number of synchronisation rounds of the partitions.
+  long numberOfRounds{0};
+
+};
+
+/**
+ * A parallel simulator of a local PDMP on a dependencies graph, for
+ * large factor graphs, where a single chain should use several cores.
+ *
+ * The model variables are split into contiguous blocks of ids, one per
+ * partition (so variable ids are best ordered for locality first, see
+ * VariableOrdering), and each factor is assigned to the partition of its
+ * first variable. Each partition is simulated by its own thread with its
+ * own event queue, and variable positions are updated lazily, only when
+ * their velocities change.
+ *
+ * The events of a factor whose Markov kernel only affects its own
+ * partition are simulated in parallel. The events affecting several
+ * partitions (cross-partition events) are simulated one at a time, in the
+ * order of their times. Since a PDMP has no lookahead (an event can cause
+ * another one arbitrarily soon after), the partitions simulate ahead
+ * speculatively until their next cross-partition event, logging how to
+ * undo each change. Simulating a cross-partition event rolls back the
+ * partitions it affects to its time. The simulated trajectory is thus
+ * exactly the one of the sequential Pdmp, given the same random numbers.
+ *
+ * The flow has to be a LinearFlowBase flow. Factor and kernel lambdas
+ * should keep all their state (e.g. random number generators) inside the
+ * closure, as the nodes are copied to undo their changes; state shared
+ * between lambdas is not rolled back.
+ */
+template<class DependenciesGraph, class State, class Flow>
+class PartitionedPdmp {
+
+ public:
+
+  using RealType = typename State::RealType;
+
+  /**
+   * @param dependenciesGraph
+   *   The graph of the factors, variables and Markov kernels.
+   * @param numberOfPartitions
+   *   The number of partitions, each simulated by its own thread.
+   */
+  PartitionedPdmp(
+    std::shared_ptr<DependenciesGraph> dependenciesGraph,
+    int numberOfPartitions);
+
+  /**
+   * Sets the state of the process at the given time, and simulates the
+   * first events of all the factors.
+   */
+  void setState(const State& state, double time = 0.0);
+
+  /**
+   * Simulates the process until the given time, and returns the state at
+   * that time.
+   */
+  State simulateUntil(double time);
+
+  /**
+   * Returns the time, until which the process was simulated.
+   */
+  double getTime() const;
+
+  int getNumberOfPartitions() const;
+
+  /**
+   * Returns the partition, which simulates the events of the given factor.
+   */
+  int getPartitionOfFactor(int factorId) const;
+
+  /**
+   * Returns true, if the events of the given factor affect more than one
+   * partition.
+   */
+  bool isCrossPartitionFactor(int factorId) const;
+
+  const PartitionedPdmpStatistics& getStatistics() const;
+
+ private:
+
+  using FactorNodePtr = typename DependenciesGraph::FactorNodes::value_type;
+  using MarkovKernelNodePtr =
+    typename DependenciesGraph::MarkovKernelNodes::value_type;
+  using Subvector = typename DependenciesGraph::FactorNodes::value_type
+    ::element_type::Subvector;
+  using SharedPtrToEvent = std::shared_ptr<PoissonProcessEvent>;
+
+  // A change made by a speculatively simulated event, which can be undone.
+  struct UndoEntry {
+    double time;
+    std::function<void()> undo;
+  };
+
+  struct Partition {
+    PriorityQueueEventScheduler<SharedPtrToEvent> eventQueue;
+    // The changes made after the last committed time, in time order.
+    std::deque<UndoEntry> undoLog;
+    // The next accepted cross-partition event, at which the partition stopped.
+    SharedPtrToEvent pendingCrossPartitionEvent;
+    long numberOfEvents{0};
+    long numberOfRolledBackEvents{0};
+  };
+
+  // Finds the partitions of the factors and the partitions affected by the
+  // events of each factor.
+  void partitionFactorGraph();
+
+  // Simulates the events of a partition in time order, until its next
+  // cross-partition event or the given time.
+  void simulatePartition(int partitionId, double untilTime);
+
+  // Simulates the earliest pending cross-partition event, after rolling
+  // back the partitions it affects. Returns false if there is none.
+  bool simulateNextCrossPartitionEvent();
+
+  // Undoes the changes of a partition made after the given time.
+  void rollBack(int partitionId, double time);
+
+  // Drops the undo entries up to the given time, which can not be rolled
+  // back anymore.
+  void commit(double time);
+
+  // Applies the Markov kernel of a factor at the given time and resimulates
+  // the dependent factors. If undoLog is not null, the changes are logged.
+  void simulateEvent(
+    int factorId, double time, std::deque<UndoEntry>* undoLog);
+
+  // Simulates a new event of the factor from the given time.
+  void resimulateFactor(
+    int factorId, double time, std::deque<UndoEntry>* undoLog);
+
+  // Returns the values of the given variables at the given time.
+  Subvector getSubvectorAtTime(const std::vector<int>& ids, double time) const;
+
+  // Sets the value of a variable at the given time, bringing the position
+  // of its model variable up to date first.
+  void setVariableAtTime(
+    int variableId, RealType value, double time,
+    std::deque<UndoEntry>* undoLog);
+
+  // Runs the partitions in parallel until the given time.
+  void runPartitions(double untilTime);
+
+  std::shared_ptr<DependenciesGraph> dependenciesGraph_;
+  int numberOfPartitions_;
+  int numberOfModelVariables_;
+
+  // Working copies of the nodes, which are replaced by copies when
+  // speculatively modified, so that the originals can be restored.
+  std::vector<FactorNodePtr> factorNodes_;
+  std::vector<MarkovKernelNodePtr> markovKernelNodes_;
+
+  std::vector<std::vector<int>> factorDependencies_;
+  std::vector<std::vector<int>> modifiedSubvectorIndices_;
+  std::vector<int> partitionOfFactor_;
+  std::vector<std::vector<int>> affectedPartitions_;
+
+  // The state, whose positions are up to date at lastUpdateTimes_.
+  State state_;
+  std::vector<double> lastUpdateTimes_;
+  std::vector<SharedPtrToEvent> latestEvents_;
+  std::vector<Partition> partitions_;
+  double time_{0.0};
+
+  // The persistent threads simulating the partitions, reused by every call
+  // of simulateUntil.
+  std::unique_ptr<ThreadPool> threadPool_;
+
+  // The partitions stop at this time in each round, so that partitions
+  // without nearby cross-partition events do not get far ahead.
+  double horizon_{0.0};
+  double meanCrossPartitionEventInterval_{0.0};
+  double lastCrossPartitionEventTime_{0.0};
+
+  // Set by the first partition's thread between two barriers.
+  bool isDone_{false};
+  PartitionedPdmpStatistics statistics_;
+
+};
+
+}
+}
+
+#include "partitioned_pdmp.tcc"
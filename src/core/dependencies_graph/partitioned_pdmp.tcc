@@ -0,0 +1,533 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace pdmp {
+namespace dependencies_graph {
+
+namespace {
+
+// A reusable barrier for a fixed number of threads, which spins (yielding)
+// instead of sleeping, as the partitions synchronise very frequently.
+class SpinBarrier {
+
+ public:
+
+  explicit SpinBarrier(int numberOfThreads)
+    : numberOfThreads_(numberOfThreads) {
+  }
+
+  void wait() {
+    const int generation = generation_.load(std::memory_order_acquire);
+    if (numberOfWaitingThreads_.fetch_add(1, std::memory_order_acq_rel) + 1
+        == numberOfThreads_) {
+      numberOfWaitingThreads_.store(0, std::memory_order_relaxed);
+      generation_.fetch_add(1, std::memory_order_acq_rel);
+      return;
+    }
+    while (generation_.load(std::memory_order_acquire) == generation) {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+
+  const int numberOfThreads_;
+  std::atomic<int> numberOfWaitingThreads_{0};
+  std::atomic<int> generation_{0};
+
+};
+
+}
+
+template<class DependenciesGraph, class State, class Flow>
+PartitionedPdmp<DependenciesGraph, State, Flow>::PartitionedPdmp(
+  std::shared_ptr<DependenciesGraph> dependenciesGraph,
+  int numberOfPartitions)
+  : dependenciesGraph_(dependenciesGraph),
+    numberOfPartitions_(numberOfPartitions),
+    factorNodes_(
+      dependenciesGraph->factorNodes.begin(),
+      dependenciesGraph->factorNodes.end()),
+    markovKernelNodes_(
+      dependenciesGraph->markovKernelNodes.begin(),
+      dependenciesGraph->markovKernelNodes.end()) {
+
+  static_assert(
+    std::is_base_of<LinearFlowBase<Flow>, Flow>::value,
+    "PartitionedPdmp needs a linear flow, for the lazy position updates.");
+  if (numberOfPartitions < 1) {
+    throw std::invalid_argument(
+      "The number of partitions should be positive, but "
+      + std::to_string(numberOfPartitions) + " was given.");
+  }
+  const int stateSpaceDimension = dependenciesGraph_->variableNodes.size();
+  if (stateSpaceDimension % 2 != 0) {
+    throw std::invalid_argument(
+      "PartitionedPdmp needs a state of positions and velocities, but the "
+      "state space dimension " + std::to_string(stateSpaceDimension)
+      + " is odd.");
+  }
+  numberOfModelVariables_ = stateSpaceDimension / 2;
+  partitionFactorGraph();
+  threadPool_ = std::make_unique<ThreadPool>(numberOfPartitions);
+}
+
+template<class DependenciesGraph, class State, class Flow>
+void PartitionedPdmp<DependenciesGraph, State, Flow>::partitionFactorGraph() {
+  const int numberOfFactors = factorNodes_.size();
+  const int stateSpaceDimension = 2 * numberOfModelVariables_;
+  auto getPartitionOfVariable = [this] (int variableId) {
+    return static_cast<int>(
+      static_cast<long long>(variableId % numberOfModelVariables_)
+      * numberOfPartitions_ / numberOfModelVariables_);
+  };
+
+  factorDependencies_.resize(numberOfFactors);
+  modifiedSubvectorIndices_.resize(numberOfFactors);
+  partitionOfFactor_.resize(numberOfFactors);
+  std::vector<std::vector<int>> readingPartitions(stateSpaceDimension);
+  for (int factorId = 0; factorId < numberOfFactors; factorId++) {
+    auto dependencies =
+      dependenciesGraph_->template getFactorDependencies<Flow>(factorId);
+    if (std::find(dependencies.begin(), dependencies.end(), factorId)
+        == dependencies.end()) {
+      dependencies.push_back(factorId);
+    }
+    factorDependencies_[factorId] = std::move(dependencies);
+
+    const auto& factorIds = factorNodes_[factorId]->dependentVariableIds;
+    const auto& modifiedIds =
+      markovKernelNodes_[factorId]->dependentVariableIds;
+    const auto& requiredIds =
+      markovKernelNodes_[factorId]->getRequiredVariableIds();
+    if (!factorIds.empty()) {
+      partitionOfFactor_[factorId] = getPartitionOfVariable(factorIds[0]);
+    } else if (!modifiedIds.empty()) {
+      partitionOfFactor_[factorId] = getPartitionOfVariable(modifiedIds[0]);
+    } else {
+      partitionOfFactor_[factorId] = 0;
+    }
+
+    for (int id : modifiedIds) {
+      auto it = std::find(requiredIds.begin(), requiredIds.end(), id);
+      if (it == requiredIds.end()) {
+        throw std::invalid_argument(
+          "The Markov kernel of factor " + std::to_string(factorId)
+          + " modifies the variable " + std::to_string(id)
+          + ", which it does not access.");
+      }
+      modifiedSubvectorIndices_[factorId].push_back(it - requiredIds.begin());
+    }
+    for (const auto* ids : {&factorIds, &requiredIds}) {
+      for (int id : *ids) {
+        readingPartitions[id].push_back(partitionOfFactor_[factorId]);
+      }
+    }
+  }
+  for (auto& partitions : readingPartitions) {
+    std::sort(partitions.begin(), partitions.end());
+    partitions.erase(
+      std::unique(partitions.begin(), partitions.end()), partitions.end());
+  }
+
+  // An event affects the partitions of the factors it resimulates, and of
+  // the factors and kernels reading the variables it changes.
+  affectedPartitions_.resize(numberOfFactors);
+  for (int factorId = 0; factorId < numberOfFactors; factorId++) {
+    auto& affected = affectedPartitions_[factorId];
+    for (int dependentFactorId : factorDependencies_[factorId]) {
+      affected.push_back(partitionOfFactor_[dependentFactorId]);
+    }
+    for (int id : markovKernelNodes_[factorId]->dependentVariableIds) {
+      for (int changedId :
+           Flow::getDependentVariableIds(id, stateSpaceDimension)) {
+        affected.insert(
+          affected.end(),
+          readingPartitions[changedId].begin(),
+          readingPartitions[changedId].end());
+      }
+    }
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+  }
+}
+
+template<class DependenciesGraph, class State, class Flow>
+void PartitionedPdmp<DependenciesGraph, State, Flow>::setState(
+  const State& state, double time) {
+
+  if (state.position.size() != numberOfModelVariables_) {
+    throw std::invalid_argument(
+      "The state has " + std::to_string(state.position.size())
+      + " model variables, but the dependencies graph has "
+      + std::to_string(numberOfModelVariables_) + ".");
+  }
+  state_ = state;
+  lastUpdateTimes_.assign(numberOfModelVariables_, time);
+  time_ = time;
+  lastCrossPartitionEventTime_ = time;
+  partitions_.clear();
+  partitions_.resize(numberOfPartitions_);
+  latestEvents_.assign(factorNodes_.size(), nullptr);
+  for (int factorId = 0; factorId < factorNodes_.size(); factorId++) {
+    resimulateFactor(factorId, time, nullptr);
+  }
+}
+
+template<class DependenciesGraph, class State, class Flow>
+State PartitionedPdmp<DependenciesGraph, State, Flow>::simulateUntil(
+  double time) {
+
+  if (partitions_.empty()) {
+    throw std::logic_error(
+      "The state of the partitioned PDMP should be set before simulating.");
+  }
+  if (time < time_) {
+    throw std::invalid_argument(
+      "Can not simulate until time " + std::to_string(time)
+      + ", which is before the current time " + std::to_string(time_) + ".");
+  }
+
+  // The partitions simulate ahead for about the mean time between two
+  // cross-partition events, as their later events are likely rolled back.
+  double window = meanCrossPartitionEventInterval_;
+  if (window <= 0.0) {
+    window = std::numeric_limits<double>::infinity();
+    for (int factorId = 0; factorId < factorNodes_.size(); factorId++) {
+      if (isCrossPartitionFactor(factorId) && latestEvents_[factorId]) {
+        window = std::min(
+          window, latestEvents_[factorId]->result->time - time_);
+      }
+    }
+  }
+  horizon_ = std::min(time, time_ + window);
+  runPartitions(time);
+  commit(time);
+
+  for (auto& partition : partitions_) {
+    statistics_.numberOfEvents += partition.numberOfEvents;
+    statistics_.numberOfRolledBackEvents += partition.numberOfRolledBackEvents;
+    partition.numberOfEvents = 0;
+    partition.numberOfRolledBackEvents = 0;
+  }
+  time_ = time;
+  State state = state_;
+  for (int i = 0; i < numberOfModelVariables_; i++) {
+    state.position(i) += state.velocity(i) * (time - lastUpdateTimes_[i]);
+  }
+  return state;
+}
+
+template<class DependenciesGraph, class State, class Flow>
+void PartitionedPdmp<DependenciesGraph, State, Flow>::runPartitions(
+  double untilTime) {
+
+  isDone_ = false;
+  std::vector<std::exception_ptr> exceptions(numberOfPartitions_);
+  SpinBarrier barrier(numberOfPartitions_);
+  auto simulateRounds = [this, untilTime, &barrier, &exceptions] (int id) {
+    while (true) {
+      try {
+        this->simulatePartition(id, this->horizon_);
+      } catch (...) {
+        exceptions[id] = std::current_exception();
+      }
+      barrier.wait();
+      if (id == 0) {
+        this->statistics_.numberOfRounds++;
+        try {
+          if (!this->simulateNextCrossPartitionEvent()) {
+            // All the partitions reached the horizon.
+            if (this->horizon_ >= untilTime) {
+              this->isDone_ = true;
+            } else {
+              this->horizon_ = std::min(
+                untilTime,
+                this->horizon_ + std::max(
+                  this->meanCrossPartitionEventInterval_,
+                  (untilTime - this->horizon_) / 1024.0));
+            }
+          }
+        } catch (...) {
+          exceptions[id] = std::current_exception();
+        }
+        for (const auto& exception : exceptions) {
+          if (exception) {
+            this->isDone_ = true;
+          }
+        }
+      }
+      barrier.wait();
+      if (this->isDone_) {
+        return;
+      }
+    }
+  };
+
+  // The pool has a thread per partition, and a thread waiting at the barrier
+  // takes no other task, so every partition gets its own thread.
+  threadPool_->parallelFor(numberOfPartitions_, simulateRounds);
+  for (const auto& exception : exceptions) {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+}
+
+template<class DependenciesGraph, class State, class Flow>
+void PartitionedPdmp<DependenciesGraph, State, Flow>::simulatePartition(
+  int partitionId, double untilTime) {
+
+  auto& partition = partitions_[partitionId];
+  if (partition.pendingCrossPartitionEvent) {
+    return;
+  }
+  auto& eventQueue = partition.eventQueue;
+  auto* undoLog = &partition.undoLog;
+  double currentTime = undoLog->empty() ? time_ : undoLog->back().time;
+  while (!eventQueue.empty()) {
+    SharedPtrToEvent event = eventQueue.top();
+    const double time = event->result->time;
+    if (event->isValid && time >= untilTime) {
+      return;
+    }
+    eventQueue.pop();
+    if (event->isValid) {
+      currentTime = time;
+    }
+    undoLog->push_back(
+      {currentTime, [&eventQueue, event] () { eventQueue.push(event); }});
+    if (!event->isValid) {
+      continue;
+    }
+    const int factorId = event->factorId;
+    if (!event->result->shouldAccept()) {
+      // Rejected due to thinning step.
+      this->resimulateFactor(factorId, time, undoLog);
+      continue;
+    }
+    if (this->isCrossPartitionFactor(factorId)) {
+      partition.pendingCrossPartitionEvent = event;
+      return;
+    }
+    this->simulateEvent(factorId, time, undoLog);
+    partition.numberOfEvents++;
+    undoLog->push_back(
+      {time, [&partition] () {
+        partition.numberOfEvents--;
+        partition.numberOfRolledBackEvents++;
+      }});
+  }
+}
+
+template<class DependenciesGraph, class State, class Flow>
+bool PartitionedPdmp<DependenciesGraph, State, Flow>
+  ::simulateNextCrossPartitionEvent() {
+
+  int partitionId = -1;
+  double time = std::numeric_limits<double>::infinity();
+  for (int id = 0; id < numberOfPartitions_; id++) {
+    const auto& event = partitions_[id].pendingCrossPartitionEvent;
+    if (event && event->result->time < time) {
+      partitionId = id;
+      time = event->result->time;
+    }
+  }
+  if (partitionId < 0) {
+    return false;
+  }
+
+  const int factorId =
+    partitions_[partitionId].pendingCrossPartitionEvent->factorId;
+  partitions_[partitionId].pendingCrossPartitionEvent = nullptr;
+  for (int id : affectedPartitions_[factorId]) {
+    if (id != partitionId) {
+      rollBack(id, time);
+    }
+  }
+  simulateEvent(factorId, time, nullptr);
+  statistics_.numberOfEvents++;
+  statistics_.numberOfCrossPartitionEvents++;
+
+  const double interval = time - lastCrossPartitionEventTime_;
+  meanCrossPartitionEventInterval_ =
+    meanCrossPartitionEventInterval_ > 0.0
+      ? 0.9 * meanCrossPartitionEventInterval_ + 0.1 * interval
+      : interval;
+  lastCrossPartitionEventTime_ = time;
+  commit(time);
+  return true;
+}
+
+template<class DependenciesGraph, class State, class Flow>
+void PartitionedPdmp<DependenciesGraph, State, Flow>::rollBack(
+  int partitionId, double time) {
+
+  auto& partition = partitions_[partitionId];
+  auto& undoLog = partition.undoLog;
+  while (!undoLog.empty() && undoLog.back().time > time) {
+    undoLog.back().undo();
+    undoLog.pop_back();
+  }
+  // The pending event was put back to the queue, unless it happens at
+  // exactly the same time.
+  const auto& pendingEvent = partition.pendingCrossPartitionEvent;
+  if (pendingEvent && pendingEvent->result->time > time) {
+    partition.pendingCrossPartitionEvent = nullptr;
+  }
+}
+
+template<class DependenciesGraph, class State, class Flow>
+void PartitionedPdmp<DependenciesGraph, State, Flow>::commit(double time) {
+  for (auto& partition : partitions_) {
+    auto& undoLog = partition.undoLog;
+    while (!undoLog.empty() && undoLog.front().time <= time) {
+      undoLog.pop_front();
+    }
+  }
+}
+
+template<class DependenciesGraph, class State, class Flow>
+void PartitionedPdmp<DependenciesGraph, State, Flow>::simulateEvent(
+  int factorId, double time, std::deque<UndoEntry>* undoLog) {
+
+  auto& markovKernelNode = markovKernelNodes_[factorId];
+  if (undoLog) {
+    auto originalNode = markovKernelNode;
+    markovKernelNode = originalNode->getCopy();
+    undoLog->push_back(
+      {time, [this, factorId, originalNode] () {
+        this->markovKernelNodes_[factorId] = originalNode;
+      }});
+  }
+  const auto& requiredIds = markovKernelNode->getRequiredVariableIds();
+  Subvector newValues = markovKernelNode->jumpSubvector(
+    getSubvectorAtTime(requiredIds, time));
+  for (int index : modifiedSubvectorIndices_[factorId]) {
+    setVariableAtTime(requiredIds[index], newValues(index), time, undoLog);
+  }
+  for (int dependentFactorId : factorDependencies_[factorId]) {
+    resimulateFactor(dependentFactorId, time, undoLog);
+  }
+}
+
+template<class DependenciesGraph, class State, class Flow>
+void PartitionedPdmp<DependenciesGraph, State, Flow>::resimulateFactor(
+  int factorId, double time, std::deque<UndoEntry>* undoLog) {
+
+  auto& factorNode = factorNodes_[factorId];
+  if (undoLog) {
+    auto originalNode = factorNode;
+    factorNode = originalNode->getCopy();
+    undoLog->push_back(
+      {time, [this, factorId, originalNode] () {
+        this->factorNodes_[factorId] = originalNode;
+      }});
+  }
+  auto result = factorNode->getPoissonProcessResultOfSubvector(
+    getSubvectorAtTime(factorNode->dependentVariableIds, time), state_);
+  SharedPtrToEvent event = std::make_shared<PoissonProcessEvent>(
+    factorId, result->cloneAndAddTime(time));
+  SharedPtrToEvent previousEvent = latestEvents_[factorId];
+  if (previousEvent) {
+    previousEvent->isValid = false;
+  }
+  partitions_[partitionOfFactor_[factorId]].eventQueue.push(event);
+  latestEvents_[factorId] = event;
+  if (undoLog) {
+    undoLog->push_back(
+      {time, [this, factorId, event, previousEvent] () {
+        event->isValid = false;
+        if (previousEvent) {
+          previousEvent->isValid = true;
+        }
+        this->latestEvents_[factorId] = previousEvent;
+      }});
+  }
+}
+
+template<class DependenciesGraph, class State, class Flow>
+typename PartitionedPdmp<DependenciesGraph, State, Flow>::Subvector
+PartitionedPdmp<DependenciesGraph, State, Flow>::getSubvectorAtTime(
+  const std::vector<int>& ids, double time) const {
+
+  Subvector subvector(ids.size());
+  for (int i = 0; i < ids.size(); i++) {
+    const int id = ids[i];
+    if (id < numberOfModelVariables_) {
+      subvector(i) = state_.position(id)
+        + state_.velocity(id) * (time - lastUpdateTimes_[id]);
+    } else {
+      subvector(i) = state_.velocity(id - numberOfModelVariables_);
+    }
+  }
+  return subvector;
+}
+
+template<class DependenciesGraph, class State, class Flow>
+void PartitionedPdmp<DependenciesGraph, State, Flow>::setVariableAtTime(
+  int variableId, RealType value, double time,
+  std::deque<UndoEntry>* undoLog) {
+
+  const int i = variableId % numberOfModelVariables_;
+  if (undoLog) {
+    undoLog->push_back(
+      {time, [this, i, position = state_.position(i),
+              velocity = state_.velocity(i),
+              lastUpdateTime = lastUpdateTimes_[i]] () {
+        this->state_.position(i) = position;
+        this->state_.velocity(i) = velocity;
+        this->lastUpdateTimes_[i] = lastUpdateTime;
+      }});
+  }
+  state_.position(i) += state_.velocity(i) * (time - lastUpdateTimes_[i]);
+  lastUpdateTimes_[i] = time;
+  if (variableId < numberOfModelVariables_) {
+    state_.position(i) = value;
+  } else {
+    state_.velocity(i) = value;
+  }
+}
+
+template<class DependenciesGraph, class State, class Flow>
+double PartitionedPdmp<DependenciesGraph, State, Flow>::getTime() const {
+  return time_;
+}
+
+template<class DependenciesGraph, class State, class Flow>
+int PartitionedPdmp<DependenciesGraph, State, Flow>
+  ::getNumberOfPartitions() const {
+
+  return numberOfPartitions_;
+}
+
+template<class DependenciesGraph, class State, class Flow>
+int PartitionedPdmp<DependenciesGraph, State, Flow>::getPartitionOfFactor(
+  int factorId) const {
+
+  return partitionOfFactor_.at(factorId);
+}
+
+template<class DependenciesGraph, class State, class Flow>
+bool PartitionedPdmp<DependenciesGraph, State, Flow>::isCrossPartitionFactor(
+  int factorId) const {
+
+  return affectedPartitions_.at(factorId).size() > 1;
+}
+
+template<class DependenciesGraph, class State, class Flow>
+const PartitionedPdmpStatistics&
+PartitionedPdmp<DependenciesGraph, State, Flow>::getStatistics() const {
+  return statistics_;
+}
+
+}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "core/pdmp.h"
+
+namespace pdmp {
+
+/**
+ * Simulates several independent PDMPs on a single thread, e.g. chains of
+ * a model whose dependencies graph is much larger than the cache, where
+ * each event mostly waits for cache misses.
+ *
+ * The iterations are split into stages: the prefetch stages of the
+ * Poisson process policy (see
+ * dependencies_graph::PoissonProcess::prefetchExpiredFactors), which
+ * gather the factor nodes, variable ids and variable values needed by the
+ * next iteration, and the iteration itself. Each stage is run for all the
+ * processes before the next one, so that the memory loads started for one
+ * process overlap with the work on the others. The trajectory of each
+ * process is the same as when simulated on its own.
+ */
+template<class Pdmp, class State>
+class InterleavedPdmps {
+
+ public:
+
+  /**
+   * Called with the id of the process and the result of each simulated
+   * iteration.
+   */
+  using Observer =
+    std::function<void(int pdmpId, const IterationResult<State>&)>;
+
+  /**
+   * @param pdmps
+   *   The processes, which should not share any mutable state.
+   * @param initialStates
+   *   The initial state of each process.
+   */
+  InterleavedPdmps(std::vector<Pdmp> pdmps, std::vector<State> initialStates);
+
+  int getNumberOfPdmps() const;
+
+  /**
+   * Returns the state of the given process after its last iteration.
+   */
+  const State& getState(int pdmpId) const;
+
+  /**
+   * Simulates the given number of iterations of each process, notifying
+   * the observer (if any) of the iterations in the order of the processes.
+   */
+  void simulateIterations(
+    int numberOfIterations, const Observer& observer = nullptr);
+
+ private:
+
+  std::vector<Pdmp> pdmps_;
+  std::vector<State> states_;
+
+};
+
+}
+
+#include "interleaved_pdmps.tcc"
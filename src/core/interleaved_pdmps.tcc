@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace pdmp {
+
+template<class Pdmp, class State>
+InterleavedPdmps<Pdmp, State>::InterleavedPdmps(
+  std::vector<Pdmp> pdmps, std::vector<State> initialStates)
+  : pdmps_(std::move(pdmps)), states_(std::move(initialStates)) {
+
+  if (pdmps_.size() != states_.size()) {
+    throw std::invalid_argument(
+      "Each process needs an initial state, but "
+      + std::to_string(pdmps_.size()) + " processes and "
+      + std::to_string(states_.size()) + " states were given.");
+  }
+}
+
+template<class Pdmp, class State>
+int InterleavedPdmps<Pdmp, State>::getNumberOfPdmps() const {
+  return pdmps_.size();
+}
+
+template<class Pdmp, class State>
+const State& InterleavedPdmps<Pdmp, State>::getState(int pdmpId) const {
+  return states_.at(pdmpId);
+}
+
+template<class Pdmp, class State>
+void InterleavedPdmps<Pdmp, State>::simulateIterations(
+  int numberOfIterations, const Observer& observer) {
+
+  for (int iteration = 0; iteration < numberOfIterations; iteration++) {
+    for (int stage = 0; stage < Pdmp::kNumberOfPrefetchStages; stage++) {
+      for (int i = 0; i < pdmps_.size(); i++) {
+        pdmps_[i].prefetchExpiredFactors(states_[i], stage);
+      }
+    }
+    for (int i = 0; i < pdmps_.size(); i++) {
+      auto result = pdmps_[i].simulateOneIteration(std::move(states_[i]));
+      if (observer) {
+        observer(i, result);
+      }
+      states_[i] = std::move(result.state);
+    }
+  }
+}
+
+}
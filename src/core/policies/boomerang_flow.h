@@ -0,0 +1,47 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+namespace pdmp {
+
+/**
+ * A class for representing the elliptical flow of the Boomerang sampler
+ * with the standard Gaussian reference N(0, I). Each (position, velocity)
+ * pair rotates around the origin:
+ *   x(t) = x cos(t) + v sin(t),
+ *   v(t) = -x sin(t) + v cos(t),
+ * which leaves the reference distribution of (x, v) invariant. A reference
+ * N(mean, diag(scale^2)) is obtained by standardising the model variables.
+ */
+class BoomerangFlow {
+
+ public:
+
+  /**
+   * For a given state (position, velocity) and time t, calculates and returns
+   * the state rotated by the angle t.
+   */
+  template<class State, typename RealType>
+  static std::decay_t<State> advanceStateByFlow(State&& state, RealType time);
+
+  /**
+   * Returns the values of the given variables of the state rotated by the
+   * angle t, without rotating the other variables.
+   */
+  template<class State, typename RealType>
+  static auto advanceSubvectorByFlow(
+    const State& state, const std::vector<int>& variableIds, RealType time);
+
+  /**
+   * Returns variables, dependent on a given variable id for a given state
+   * space dimensionality. Each position variable and its associated velocity
+   * variable depend on each other.
+   */
+  static std::vector<int> getDependentVariableIds(int variableId, int dim);
+
+};
+
+}
+
+#include "boomerang_flow.tcc"
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+
+namespace pdmp {
+
+namespace {
+
+template<class State>
+struct RotateStateHelper {
+
+  template<typename RealType>
+  static State advanceStateByFlow(State&& state, RealType time) {
+    using std::cos;
+    using std::sin;
+    auto position = state.position;
+    state.position = position * cos(time) + state.velocity * sin(time);
+    state.velocity = state.velocity * cos(time) - position * sin(time);
+    return std::move(state);
+  }
+
+  template<typename RealType>
+  static State advanceStateByFlow(const State& state, RealType time) {
+    using std::cos;
+    using std::sin;
+    return State(state.position * cos(time) + state.velocity * sin(time),
+                 state.velocity * cos(time) - state.position * sin(time));
+  }
+
+};
+
+}
+
+template<class State, typename RealType>
+std::decay_t<State> BoomerangFlow
+  ::advanceStateByFlow(State&& state, RealType time) {
+
+  using State_t = std::decay_t<State>;
+  return RotateStateHelper<State_t>::advanceStateByFlow(
+    std::forward<State>(state), time);
+}
+
+template<class State, typename RealType>
+auto BoomerangFlow::advanceSubvectorByFlow(
+  const State& state, const std::vector<int>& variableIds, RealType time) {
+
+  using std::cos;
+  using std::sin;
+  auto values = state.getSubvector(variableIds);
+  const int numberOfPositions = state.position.size();
+  for (int i = 0; i < variableIds.size(); i++) {
+    if (variableIds[i] < numberOfPositions) {
+      const int id = variableIds[i];
+      values(i) = state.position(id) * cos(time)
+                  + state.velocity(id) * sin(time);
+    } else {
+      const int id = variableIds[i] - numberOfPositions;
+      values(i) = state.velocity(id) * cos(time)
+                  - state.position(id) * sin(time);
+    }
+  }
+  return values;
+}
+
+std::vector<int> BoomerangFlow::getDependentVariableIds(
+  int variableId, int dim) {
+
+  if (dim <= 0 || dim % 2 == 1) {
+    throw std::logic_error("BoomerangFlow can only be used on state spaces "
+                           "with positive and even dimensionalities.");
+  }
+  if (variableId < 0 || variableId >= dim) {
+    throw std::out_of_range("Variable id is out of range for dependent "
+                            "variables calculation.");
+  }
+  const int positionVariableId =
+    variableId < dim / 2 ? variableId : variableId - dim / 2;
+  return std::vector<int>{positionVariableId, positionVariableId + dim / 2};
+}
+
+}
@@ -20,6 +20,14 @@ class LinearFlowBase {
   template<class State, typename RealType>
   static std::decay_t<State> advanceStateByFlow(State&& state, RealType time);
 
+  /**
+   * Returns the values of the given variables of the state advanced by the
+   * flow for time t, without advancing the other variables.
+   */
+  template<class State, typename RealType>
+  static auto advanceSubvectorByFlow(
+    const State& state, const std::vector<int>& variableIds, RealType time);
+
   /**
    * Returns variables, dependent on a given variable id for a given state
    * space dimensionality. In particular, position variables depend on
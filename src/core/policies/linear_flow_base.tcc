@@ -37,6 +37,22 @@ std::decay_t<State> LinearFlowBase<Derived>
   return Derived::advanceStateByFlow(std::forward<State>(state), time);
 }
 
+template<class Derived>
+template<class State, typename RealType>
+auto LinearFlowBase<Derived>::advanceSubvectorByFlow(
+  const State& state, const std::vector<int>& variableIds, RealType time) {
+
+  auto values = state.getSubvector(variableIds);
+  const int numberOfPositions = state.position.size();
+  for (int i = 0; i < variableIds.size(); i++) {
+    // The velocities are not changed by the flow.
+    if (variableIds[i] < numberOfPositions) {
+      values(i) += state.velocity(variableIds[i]) * time;
+    }
+  }
+  return values;
+}
+
 template <class Derived>
 std::vector<int> LinearFlowBase<Derived>::getDependentVariableIds(
   int variableId, int dim) {
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <queue>
 #include <vector>
 
+#include "core/thread_pool.h"
+
 namespace pdmp {
 namespace dependencies_graph {
 
@@ -76,6 +79,18 @@ struct PriorityQueueEventScheduler
              EventType,
              std::vector<EventType>,
              std::greater<EventType>> {
+
+  /**
+   * Adds all the given events, and rebuilds the heap in linear time, which
+   * is faster than pushing them one by one when there are at least as many
+   * of them as scheduled events (e.g. the first events of all the factors).
+   */
+  void pushAll(std::vector<EventType>&& events) {
+    this->c.insert(this->c.end(), std::make_move_iterator(events.begin()),
+                   std::make_move_iterator(events.end()));
+    std::make_heap(this->c.begin(), this->c.end(), this->comp);
+  }
+
 };
 
 /**
@@ -93,11 +108,76 @@ class PoissonProcess {
 
   PoissonProcess(std::shared_ptr<DependenciesGraph> dependenciesGraph);
 
+  /**
+   * Returns the time until the next accepted event. The host class should
+   * implement the flow policy (usually the host Pdmp, which inherits it),
+   * which is used both to advance the state and to find the factors that
+   * depend on the variables changed by the event.
+   *
+   * The given state should be the one returned by the Markov kernel of the
+   * previous event. After the events of hub factors (see
+   * DependenciesGraph::setHubThreshold), only the factors depending on the
+   * variables whose values were actually changed by the kernel are
+   * resimulated, as the events of the others are unaffected.
+   */
   template<class State, class HostClass>
   auto getJumpTime(const State& state, const HostClass& hostClass);
 
   int getLastFactorId() const;
 
+  /**
+   * Discards the simulated events, so that the next getJumpTime simulates
+   * the events of all the factors anew from the given state, which may be
+   * unrelated to the previous one (e.g. after a replica exchange, see
+   * ParallelTempering). The event times then count from zero again.
+   */
+  void resetEvents();
+
+  /**
+   * Expires the pending events of the given factors, e.g. after their
+   * parameters were changed in place (see BpsBuilder::setGaussianParameters),
+   * so that the next getJumpTime resimulates them from the given state,
+   * which should still be the one returned by the Markov kernel of the
+   * previous event. The events of the other factors are kept. Throws
+   * std::out_of_range for unknown factor ids.
+   */
+  void invalidateFactors(const std::vector<int>& factorIds);
+
+  /**
+   * Prefetches the memory read by the next getJumpTime with the given state
+   * when resimulating the factors affected by the last event: the factor
+   * nodes and their latest events (stage 0), the ids of their variables
+   * (stage 1), and the values of these variables in the state (stage 2).
+   * Each stage only reads memory prefetched by the previous one, so
+   * running the stages of several independent processes in turn overlaps
+   * their cache misses (see InterleavedPdmps). At most
+   * kMaximumNumberOfPrefetchedFactors factors are prefetched, and nothing
+   * after a hub factor event. The simulated process is not changed.
+   */
+  template<class State>
+  void prefetchExpiredFactors(const State& state, int stage) const;
+
+  static const int kNumberOfPrefetchStages = 3;
+  static const int kMaximumNumberOfPrefetchedFactors = 64;
+
+  /**
+   * Resimulates the factors affected by an event using the given number of
+   * threads, when there are at least minimumNumberOfFactors of them (e.g.
+   * after the events of a wide factor, or of a factor modifying a variable
+   * shared by most factors). The event times of different factors are
+   * independent given the state, so the Poisson process lambdas of the
+   * factors should then only modify their own state (e.g. their own random
+   * number generators), which holds for the factors of the MCMC builders.
+   * A single thread switches the parallel resimulation off.
+   */
+  void setParallelResimulation(
+    int numberOfThreads,
+    int minimumNumberOfFactors = kDefaultMinimumNumberOfFactorsPerBatch);
+
+  // The default number of factors to resimulate, from which on the
+  // resimulation is split between threads.
+  static const int kDefaultMinimumNumberOfFactorsPerBatch = 1024;
+
  private:
 
   // Invalidates the last event of the given factor and simulates a new
@@ -106,18 +186,48 @@ class PoissonProcess {
   void resimulateEventForFactor(
     const State& state, const int& factorId, const double& startingTime);
 
+  // Invalidates the last event of the given factor and schedules the given
+  // simulated event instead.
+  void scheduleEventForFactor(
+    int factorId, std::shared_ptr<PoissonProcessResultBase> result);
+
+  // Schedules the events in batchResults_ for the factors in
+  // factorsToResimulate_, heapifying them with the scheduled events at once.
+  void scheduleBatchEvents();
+
+  // Sets factorsToResimulate_ to the factors depending on the variables
+  // changed by the Markov kernel of the last (hub factor) event.
+  template<class State, class HostClass>
+  void findFactorsChangedByLastJump(const State& state);
+
   // Resimulates all Poisson processes with ids in factorsToResimulate_.
-  // Set old events (from latestEvenets_ array) as invalid.
+  // Set old events (from latestEvenets_ array) as invalid. The events are
+  // simulated in parallel for large batches, and scheduled at once when
+  // they outnumber the scheduled events (e.g. the first events of all the
+  // factors).
   template<class State>
   void resimulateExpiredFactors(const State& state);
 
   EventScheduler<SharedPtrToEvent> eventScheduler_;
   std::shared_ptr<DependenciesGraph> dependenciesGraph_;
   std::vector<int> factorsToResimulate_;
+  // The factors expired by invalidateFactors since the last getJumpTime.
+  std::vector<int> invalidatedFactors_;
   std::vector<SharedPtrToEvent> latestEvents_;
   double currentTime_ = 0.0f;
   int lastFactorId_ = 0;
 
+  // The values of the variables modifiable by the Markov kernel of the last
+  // event, before the jump. Only recorded for hub factor events.
+  bool isLastJumpRecorded_ = false;
+  std::vector<double> valuesBeforeLastJump_;
+
+  // Shared by the copies of this policy, which should thus not simulate
+  // concurrently.
+  std::shared_ptr<ThreadPool> threadPool_;
+  int minimumNumberOfFactorsPerBatch_{kDefaultMinimumNumberOfFactorsPerBatch};
+  std::vector<std::shared_ptr<PoissonProcessResultBase>> batchResults_;
+
 };
 
 }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 
 namespace pdmp {
@@ -14,6 +18,13 @@ namespace {
 const auto dummyEvent = std::make_shared<PoissonProcessEvent>(
   -1, std::make_shared<PoissonProcessResult<>>(0.0f));
 
+// Hints the processor to start loading the cache line of the given address.
+void prefetch(const void* address) {
+#ifdef __GNUC__
+  __builtin_prefetch(address);
+#endif
+}
+
 }
 
 PoissonProcessResultBase::PoissonProcessResultBase(const double& time)
@@ -99,6 +110,9 @@ template<class State, class HostClass>
 auto PoissonProcess<DependenciesGraph, EventScheduler>::getJumpTime(
   const State& state, const HostClass& hostClass) {
 
+  if (this->isLastJumpRecorded_) {
+    this->template findFactorsChangedByLastJump<State, HostClass>(state);
+  }
   this->resimulateExpiredFactors(state);
   // Find the first valid event that is not rejected.
   while (true) {
@@ -117,9 +131,23 @@ auto PoissonProcess<DependenciesGraph, EventScheduler>::getJumpTime(
     }
     // Found an event that is valid and not rejected.
     this->lastFactorId_ = event->factorId;
-    this->factorsToResimulate_ =
-      this->dependenciesGraph_->getFactorDependencies(this->lastFactorId_);
     auto returnTime = event->result->time - this->currentTime_;
+    if (this->dependenciesGraph_->template isHubFactor<HostClass>(
+          this->lastFactorId_)) {
+      // Record the values the kernel may modify, and defer finding the
+      // factors to resimulate until the jump is done.
+      const auto& modifiableIds = this->dependenciesGraph_
+        ->markovKernelNodes[this->lastFactorId_]->dependentVariableIds;
+      auto values =
+        hostClass.advanceSubvectorByFlow(state, modifiableIds, returnTime);
+      this->valuesBeforeLastJump_.assign(
+        values.data(), values.data() + values.size());
+      this->isLastJumpRecorded_ = true;
+    } else {
+      this->factorsToResimulate_ =
+        this->dependenciesGraph_->template getFactorDependencies<HostClass>(
+          this->lastFactorId_);
+    }
     this->currentTime_ = event->result->time;
     return returnTime;
   }
@@ -130,37 +158,195 @@ int PoissonProcess<DependenciesGraph, EventScheduler>::getLastFactorId() const {
   return this->lastFactorId_;
 }
 
+template<class DependenciesGraph, template<class> class EventScheduler>
+void PoissonProcess<DependenciesGraph, EventScheduler>::resetEvents() {
+  eventScheduler_ = EventScheduler<SharedPtrToEvent>();
+  factorsToResimulate_.clear();
+  for (int i = 0; i < latestEvents_.size(); i++) {
+    factorsToResimulate_.push_back(i);
+    latestEvents_[i] = dummyEvent;
+  }
+  invalidatedFactors_.clear();
+  currentTime_ = 0.0;
+  isLastJumpRecorded_ = false;
+}
+
+template<class DependenciesGraph, template<class> class EventScheduler>
+void PoissonProcess<DependenciesGraph, EventScheduler>::invalidateFactors(
+  const std::vector<int>& factorIds) {
+
+  for (int factorId : factorIds) {
+    if (factorId < 0 || factorId >= latestEvents_.size()) {
+      throw std::out_of_range(
+        "Factor id " + std::to_string(factorId) + " is out of range.");
+    }
+  }
+  invalidatedFactors_.insert(
+    invalidatedFactors_.end(), factorIds.begin(), factorIds.end());
+}
+
+template<class DependenciesGraph, template<class> class EventScheduler>
+template<class State>
+void PoissonProcess<DependenciesGraph, EventScheduler>::prefetchExpiredFactors(
+  const State& state, int stage) const {
+
+  // The factors to resimulate are only known after the jump of a hub event.
+  if (this->isLastJumpRecorded_) {
+    return;
+  }
+  const auto& factorNodes = this->dependenciesGraph_->factorNodes;
+  const int numberOfFactors = std::min<int>(
+    this->factorsToResimulate_.size(), kMaximumNumberOfPrefetchedFactors);
+  for (int i = 0; i < numberOfFactors; i++) {
+    const int factorId = this->factorsToResimulate_[i];
+    if (stage == 0) {
+      prefetch(factorNodes[factorId].get());
+      prefetch(this->latestEvents_[factorId].get());
+    } else if (stage == 1) {
+      prefetch(factorNodes[factorId]->dependentVariableIds.data());
+    } else {
+      for (int id : factorNodes[factorId]->dependentVariableIds) {
+        prefetch(state.getElementAddress(id));
+      }
+    }
+  }
+}
+
+template<class DependenciesGraph, template<class> class EventScheduler>
+void PoissonProcess<DependenciesGraph, EventScheduler>::setParallelResimulation(
+  int numberOfThreads, int minimumNumberOfFactors) {
+
+  if (minimumNumberOfFactors < 1) {
+    throw std::invalid_argument(
+      "The minimum number of factors resimulated in parallel should be "
+      "positive, but " + std::to_string(minimumNumberOfFactors)
+      + " was given.");
+  }
+  this->threadPool_ = numberOfThreads > 1
+    ? std::make_shared<ThreadPool>(numberOfThreads)
+    : nullptr;
+  this->minimumNumberOfFactorsPerBatch_ = minimumNumberOfFactors;
+}
+
 template<class DependenciesGraph, template<class> class EventScheduler>
 template<class State>
 void PoissonProcess<DependenciesGraph, EventScheduler>
   ::resimulateEventForFactor(
      const State& state, const int& factorId, const double& startingTime) {
 
-  this->latestEvents_[factorId]->isValid = false;
   auto result = this->dependenciesGraph_->factorNodes.at(factorId)
     ->getPoissonProcessResult(state);
-  auto resultWithUpdatedTime = result->cloneAndAddTime(startingTime);
+  this->scheduleEventForFactor(
+    factorId, result->cloneAndAddTime(startingTime));
+}
+
+template<class DependenciesGraph, template<class> class EventScheduler>
+void PoissonProcess<DependenciesGraph, EventScheduler>::scheduleEventForFactor(
+  int factorId, std::shared_ptr<PoissonProcessResultBase> result) {
+
+  // The dummy event is shared by the processes of all threads, and never
+  // scheduled, so it is left untouched.
+  if (this->latestEvents_[factorId] != dummyEvent) {
+    this->latestEvents_[factorId]->isValid = false;
+  }
   SharedPtrToEvent newEvent = std::make_shared<PoissonProcessEvent>(
-    factorId, resultWithUpdatedTime);
+    factorId, result);
   this->eventScheduler_.push(newEvent);
   this->latestEvents_[factorId] = newEvent;
 }
 
+template<class DependenciesGraph, template<class> class EventScheduler>
+void PoissonProcess<DependenciesGraph, EventScheduler>::scheduleBatchEvents() {
+  std::vector<SharedPtrToEvent> events;
+  events.reserve(this->factorsToResimulate_.size());
+  for (int i = 0; i < this->factorsToResimulate_.size(); i++) {
+    const int factorId = this->factorsToResimulate_[i];
+    if (this->latestEvents_[factorId] != dummyEvent) {
+      this->latestEvents_[factorId]->isValid = false;
+    }
+    events.push_back(std::make_shared<PoissonProcessEvent>(
+      factorId, std::move(this->batchResults_[i])));
+    this->latestEvents_[factorId] = events.back();
+  }
+  this->eventScheduler_.pushAll(std::move(events));
+}
+
+template<class DependenciesGraph, template<class> class EventScheduler>
+template<class State, class HostClass>
+void PoissonProcess<DependenciesGraph, EventScheduler>
+  ::findFactorsChangedByLastJump(const State& state) {
+
+  const auto& modifiableIds = this->dependenciesGraph_
+    ->markovKernelNodes[this->lastFactorId_]->dependentVariableIds;
+  auto values = state.getSubvector(modifiableIds);
+  std::vector<int> changedIds;
+  for (int i = 0; i < modifiableIds.size(); i++) {
+    if (values(i) != this->valuesBeforeLastJump_[i]) {
+      changedIds.push_back(modifiableIds[i]);
+    }
+  }
+  // If all the values changed (e.g. after a BPS bounce or a refreshment),
+  // the cached dependencies of the factor are the ones needed.
+  this->factorsToResimulate_ = changedIds.size() == modifiableIds.size()
+    ? this->dependenciesGraph_->template getFactorDependencies<HostClass>(
+        this->lastFactorId_)
+    : this->dependenciesGraph_
+        ->template getFactorDependenciesOfVariables<HostClass>(changedIds);
+  this->isLastJumpRecorded_ = false;
+}
+
 template<class DependenciesGraph, template<class> class EventScheduler>
 template<class State>
 void PoissonProcess<DependenciesGraph, EventScheduler>
   ::resimulateExpiredFactors(const State& state) {
 
-  bool lastFactorResimulated = false;
-  for (const int& factorId : this->factorsToResimulate_) {
-    this->resimulateEventForFactor(state, factorId, this->currentTime_);
-    if (factorId == this->lastFactorId_) {
-      lastFactorResimulated = true;
+  if (!this->invalidatedFactors_.empty()) {
+    auto& factorIds = this->factorsToResimulate_;
+    factorIds.insert(factorIds.end(), this->invalidatedFactors_.begin(),
+                     this->invalidatedFactors_.end());
+    std::sort(factorIds.begin(), factorIds.end());
+    factorIds.erase(
+      std::unique(factorIds.begin(), factorIds.end()), factorIds.end());
+    this->invalidatedFactors_.clear();
+  }
+  if (std::find(this->factorsToResimulate_.begin(),
+                this->factorsToResimulate_.end(),
+                this->lastFactorId_) == this->factorsToResimulate_.end()) {
+    this->factorsToResimulate_.push_back(this->lastFactorId_);
+  }
+  const int numberOfFactors = this->factorsToResimulate_.size();
+  const bool isParallel = this->threadPool_
+    && numberOfFactors >= this->minimumNumberOfFactorsPerBatch_;
+  // Scheduling the events at once heapifies them with the scheduled events
+  // in linear time, instead of pushing them one by one.
+  const bool isBatchScheduled =
+    numberOfFactors > 1 && numberOfFactors >= this->eventScheduler_.size();
+  if (!isParallel && !isBatchScheduled) {
+    for (const int& factorId : this->factorsToResimulate_) {
+      this->resimulateEventForFactor(state, factorId, this->currentTime_);
     }
+    return;
+  }
+  this->batchResults_.resize(numberOfFactors);
+  auto simulateEvent = [this, &state] (int i) {
+    this->batchResults_[i] = this->dependenciesGraph_->factorNodes
+      .at(this->factorsToResimulate_[i])->getPoissonProcessResult(state)
+      ->cloneAndAddTime(this->currentTime_);
+  };
+  if (isParallel) {
+    this->threadPool_->parallelFor(numberOfFactors, simulateEvent);
+  } else {
+    for (int i = 0; i < numberOfFactors; i++) {
+      simulateEvent(i);
+    }
+  }
+  if (isBatchScheduled) {
+    this->scheduleBatchEvents();
+    return;
   }
-  if (!lastFactorResimulated) {
-    this->resimulateEventForFactor(
-      state, this->lastFactorId_, this->currentTime_);
+  for (int i = 0; i < numberOfFactors; i++) {
+    this->scheduleEventForFactor(
+      this->factorsToResimulate_[i], std::move(this->batchResults_[i]));
   }
 }
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include "core/policies/linear_flow_base.h"
+
+namespace pdmp {
+
+/**
+ * A class for representing the flow of a preconditioned PDMP with a mass
+ * matrix M. The position moves with constant velocity exactly as under
+ * LinearFlow, but the velocities are distributed as N(0, M^-1), so that
+ * each direction moves at a speed matching the scale of the target. The
+ * mass matrix itself is used by the refreshment and reflection kernels.
+ * Since the intensities along the flow are unchanged, Poisson process
+ * strategies for LinearFlow can be used with this flow.
+ */
+class PreconditionedLinearFlow
+  : public LinearFlowBase<PreconditionedLinearFlow> {
+
+ public:
+
+  /**
+   * For a given state (position, velocity) and time t, calculates and returns
+   * (position + velocity * t, velocity).
+   */
+  template<class State, typename RealType>
+  static std::decay_t<State> advanceStateByFlow(State&& state, RealType time);
+
+};
+
+}
+
+#include "preconditioned_linear_flow.tcc"
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <utility>
+
+#include "core/policies/linear_flow.h"
+
+namespace pdmp {
+
+template<class State, typename RealType>
+std::decay_t<State> PreconditionedLinearFlow
+  ::advanceStateByFlow(State&& state, RealType time) {
+
+  return LinearFlow::advanceStateByFlow(std::forward<State>(state), time);
+}
+
+}
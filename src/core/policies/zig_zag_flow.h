@@ -0,0 +1,31 @@
+#pragma once
+
+#include <type_traits>
+#include <vector>
+
+#include "core/policies/linear_flow_base.h"
+
+namespace pdmp {
+
+/**
+ * A class for representing the flow of the Zig-Zag process. The particle
+ * moves with a constant velocity exactly as under LinearFlow, but this is
+ * a separate type, so that distributions can provide Poisson process
+ * strategies for the coordinate-wise Zig-Zag intensities.
+ */
+class ZigZagFlow : public LinearFlowBase<ZigZagFlow> {
+
+ public:
+
+  /**
+   * For a given state (position, velocity) and time t, calculates and returns
+   * (position + velocity * t, velocity).
+   */
+  template<class State, typename RealType>
+  static std::decay_t<State> advanceStateByFlow(State&& state, RealType time);
+
+};
+
+}
+
+#include "zig_zag_flow.tcc"
@@ -57,6 +57,12 @@ struct PositionAndVelocityState {
    */
   RealType getElementAtIndex(int index) const;
 
+  /**
+   * Returns the address of the element at a given index, e.g. to prefetch
+   * it. The index is not checked.
+   */
+  const RealType* getElementAddress(int index) const;
+
   /**
    * Returns a subvector of this state for the given indices vector.
    */
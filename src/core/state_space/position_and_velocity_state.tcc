@@ -43,6 +43,14 @@ T PositionAndVelocityState<T, Dim>::getElementAtIndex(int index) const {
   }
 }
 
+template<typename T, int Dim>
+const T* PositionAndVelocityState<T, Dim>::getElementAddress(int index) const {
+  const int modelDimension = this->position.size();
+  return index < modelDimension
+    ? this->position.data() + index
+    : this->velocity.data() + (index - modelDimension);
+}
+
 template<typename T, int Dim>
 typename PositionAndVelocityState<T, Dim>::DynamicRealVector
 PositionAndVelocityState<T, Dim>::getSubvector(const std::vector<int>& ids) const {
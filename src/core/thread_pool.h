@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pdmp {
+
+/**
+ * A pool of persistent worker threads for splitting short batches of
+ * independent tasks, e.g. the resimulation of the factors affected by an
+ * event, where starting new threads would cost more than the tasks.
+ */
+class ThreadPool {
+
+ public:
+
+  /**
+   * Starts numberOfThreads - 1 worker threads, as the calling thread also
+   * executes tasks.
+   */
+  explicit ThreadPool(int numberOfThreads);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int getNumberOfThreads() const;
+
+  /**
+   * Calls task(i) for i = 0, ..., numberOfTasks - 1, split between the
+   * threads, and returns when all the calls are done. The calls should be
+   * independent of each other. If a call throws, the exception is rethrown
+   * here (the remaining calls might be skipped). Batches given from several
+   * threads at once are executed one after another, but a task should not
+   * call parallelFor of the same pool.
+   */
+  void parallelFor(int numberOfTasks, const std::function<void(int)>& task);
+
+ private:
+
+  // Executes chunks of tasks of the current batch, until none are left.
+  void executeTasks();
+
+  void worker();
+
+  std::vector<std::thread> workers_;
+  std::mutex batchMutex_;
+  std::mutex mutex_;
+  std::condition_variable batchStarted_;
+  std::condition_variable batchFinished_;
+
+  // The current batch, guarded by mutex_.
+  const std::function<void(int)>* task_{nullptr};
+  int numberOfTasks_{0};
+  int nextTask_{0};
+  int numberOfBusyWorkers_{0};
+  long batchId_{0};
+  bool isStopping_{false};
+  std::exception_ptr exception_;
+
+};
+
+}
+
+#include "thread_pool.tcc"
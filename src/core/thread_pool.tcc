@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace pdmp {
+
+ThreadPool::ThreadPool(int numberOfThreads) {
+  if (numberOfThreads < 1) {
+    throw std::invalid_argument(
+      "The number of threads should be positive, but "
+      + std::to_string(numberOfThreads) + " was given.");
+  }
+  for (int i = 1; i < numberOfThreads; i++) {
+    workers_.emplace_back(&ThreadPool::worker, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    isStopping_ = true;
+  }
+  batchStarted_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+int ThreadPool::getNumberOfThreads() const {
+  return workers_.size() + 1;
+}
+
+void ThreadPool::parallelFor(
+  int numberOfTasks, const std::function<void(int)>& task) {
+
+  if (workers_.empty()) {
+    for (int i = 0; i < numberOfTasks; i++) {
+      task(i);
+    }
+    return;
+  }
+  std::lock_guard<std::mutex> batchLock(batchMutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    numberOfTasks_ = numberOfTasks;
+    nextTask_ = 0;
+    exception_ = nullptr;
+    batchId_++;
+  }
+  batchStarted_.notify_all();
+  executeTasks();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  batchFinished_.wait(lock, [this] () { return numberOfBusyWorkers_ == 0; });
+  task_ = nullptr;
+  if (exception_) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+void ThreadPool::executeTasks() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Small chunks balance the load of tasks with very different costs.
+  const int chunkSize = std::max(
+    1, numberOfTasks_ / (8 * getNumberOfThreads()));
+  while (nextTask_ < numberOfTasks_ && !exception_) {
+    const int begin = nextTask_;
+    const int end = std::min(numberOfTasks_, begin + chunkSize);
+    nextTask_ = end;
+    const auto& task = *task_;
+    lock.unlock();
+    try {
+      for (int i = begin; i < end; i++) {
+        task(i);
+      }
+    } catch (...) {
+      lock.lock();
+      exception_ = std::current_exception();
+      break;
+    }
+    lock.lock();
+  }
+}
+
+void ThreadPool::worker() {
+  long lastBatchId = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      batchStarted_.wait(lock, [this, lastBatchId] () {
+        return isStopping_ || (task_ && batchId_ != lastBatchId);
+      });
+      if (isStopping_) {
+        return;
+      }
+      lastBatchId = batchId_;
+      numberOfBusyWorkers_++;
+    }
+    executeTasks();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      numberOfBusyWorkers_--;
+    }
+    batchFinished_.notify_one();
+  }
+}
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "core/policies/boomerang_flow.h"
+#include "core/state_space/position_and_velocity_state.h"
+#include "mcmc/pdmp_builder_base.h"
+#include "mcmc/distributions/distribution_base.h"
+
+namespace pdmp {
+namespace mcmc {
+
+namespace boomerang {
+
+using State = DynamicPositionAndVelocityState<double>;
+using Flow = BoomerangFlow;
+
+}
+
+/**
+ * A class for building PDMPs that simulate based on the Boomerang sampler
+ * with the standard Gaussian reference N(0, I).
+ *
+ * The simulated target is the reference multiplied by the added factors,
+ * i.e. the reference acts as a prior handled exactly by the flow, and events
+ * only come from the factors. Bounces and refreshments are the BPS ones for
+ * the identity reference covariance.
+ */
+class BoomerangBuilder
+  : protected PdmpBuilderBase<boomerang::State, boomerang::Flow> {
+
+ public:
+
+  /**
+   * Takes the number of probability model variables as input.
+   */
+  BoomerangBuilder(int numberOfModelVariables);
+
+  /**
+   * Adds a factor, with the given distribution, acting on the specified
+   * model variables. The distribution should provide a Poisson process
+   * strategy for the Boomerang flow.
+   *
+   * @param Ids
+   *   The variable ids (indexed from 0), on which this factor depends.
+   * @param distribution
+   */
+  template<class Distribution>
+  void addFactor(
+    const std::vector<int>& variableIds,
+    const DistributionBase<Distribution>& distribution,
+    double refreshRate = 1.0);
+
+  /**
+   * Returns the PDMP that can be used to simulated from the constructed
+   * probability model.
+   */
+  auto build();
+
+ private:
+
+  int numberOfModelVariables_;
+
+};
+
+}
+}
+
+#include "boomerang_builder.tcc"
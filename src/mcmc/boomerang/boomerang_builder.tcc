@@ -0,0 +1,56 @@
+#pragma once
+
+#include "mcmc/bps/bps_builder.h"
+#include "mcmc/bps/reflection_kernel.h"
+
+namespace pdmp {
+namespace mcmc {
+
+BoomerangBuilder::BoomerangBuilder(int numberOfModelVariables)
+  : PdmpBuilderBase<boomerang::State, boomerang::Flow>(
+      numberOfModelVariables * 2),
+    numberOfModelVariables_(numberOfModelVariables) {
+}
+
+template<class Distribution>
+void BoomerangBuilder::addFactor(
+    const std::vector<int>& variableIds,
+    const DistributionBase<Distribution>& distribution,
+    double refreshRate) {
+
+  const std::vector<int> variablesNeededByReflectionKernel =
+    getPositionAndVelocityVariables(variableIds, this->numberOfModelVariables_);
+  const std::vector<int> variablesToBeChangedByReflectionKernel =
+    getVelocityVariables(variableIds, this->numberOfModelVariables_);
+  const std::vector<int> variablesNeededByFactorNode =
+    variablesNeededByReflectionKernel;
+
+  auto reflectionKernel = getReflectionKernel(distribution.getLogPdfGradient());
+  auto poissonProcessStrategy = distribution.template getPoissonProcessStrategy<
+    boomerang::Flow>();
+
+  PdmpBuilderBase<boomerang::State, boomerang::Flow>::addFactorNode(
+    variablesNeededByFactorNode, poissonProcessStrategy);
+  PdmpBuilderBase<boomerang::State, boomerang::Flow>::addMarkovKernelNode(
+    variablesNeededByReflectionKernel,
+    variablesToBeChangedByReflectionKernel,
+    reflectionKernel);
+
+  // The velocities are refreshed from the reference N(0, I), exactly as for
+  // the BPS.
+  auto refreshmentStrategy = getRefreshmentStrategy(refreshRate);
+  auto refreshmentKernel = getRefreshmentKernel();
+  PdmpBuilderBase<boomerang::State, boomerang::Flow>::addFactorNode(
+    std::vector<int>{}, refreshmentStrategy);
+  PdmpBuilderBase<boomerang::State, boomerang::Flow>::addMarkovKernelNode(
+    variablesToBeChangedByReflectionKernel,
+    variablesToBeChangedByReflectionKernel,
+    refreshmentKernel);
+}
+
+auto BoomerangBuilder::build() {
+  return PdmpBuilderBase<boomerang::State, boomerang::Flow>::build();
+}
+
+}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Eigen/Core>
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * The boundary of the box {x : lower <= x <= upper}, e.g. of a positive
+ * parameter with the bounds 0 and infinity. Infinite bounds are allowed.
+ *
+ * Under a linear flow the wall hitting times are deterministic and known in
+ * closed form, so the boundary is a factor with an exact O(1) event time,
+ * at which the velocity of the hitting coordinate is reflected. This keeps
+ * the target restricted to the box invariant, without the stiff event rates
+ * of log-barriers.
+ *
+ * The initial state should be inside the box.
+ */
+class BoxBoundary {
+
+ public:
+
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+
+  /**
+   * Creates the boundary of the box with the given coordinate-wise bounds.
+   */
+  BoxBoundary(const RealVector& lowerBounds, const RealVector& upperBounds);
+
+  /**
+   * Returns the strategy simulating the time when the particle hits the
+   * boundary. The strategy expects the positions followed by the velocities
+   * of the box coordinates.
+   */
+  template<class Flow>
+  auto getPoissonProcessStrategy() const;
+
+  /**
+   * Returns the kernel reflecting the velocity of the coordinate which hit
+   * the boundary.
+   */
+  auto getReflectionKernel() const;
+
+  /**
+   * Returns the boundary of the interval of a single coordinate. A box is
+   * best split into its coordinates, so that a wall hit only affects the
+   * factors depending on the hitting coordinate.
+   */
+  BoxBoundary getCoordinateBoundary(int coordinate) const;
+
+  int getDimension() const;
+
+ private:
+
+  RealVector lowerBounds_;
+  RealVector upperBounds_;
+
+};
+
+}
+}
+
+#include "box_boundary.tcc"
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "core/policies/linear_flow.h"
+#include "core/policies/poisson_process.h"
+
+namespace {
+
+// Returns the time when the coordinate, moving with the given velocity,
+// hits one of its bounds.
+double getIntervalHittingTime(
+  double position, double velocity, double lowerBound, double upperBound) {
+
+  double time = std::numeric_limits<double>::infinity();
+  if (velocity > 0.0) {
+    time = (upperBound - position) / velocity;
+  } else if (velocity < 0.0) {
+    time = (lowerBound - position) / velocity;
+  }
+  // A coordinate on the boundary due to rounding moving outwards is
+  // reflected at once.
+  return std::max(0.0, time);
+}
+
+}
+
+namespace pdmp {
+namespace mcmc {
+
+BoxBoundary::BoxBoundary(
+  const RealVector& lowerBounds, const RealVector& upperBounds)
+  : lowerBounds_(lowerBounds),
+    upperBounds_(upperBounds) {
+
+  if (lowerBounds.size() != upperBounds.size()) {
+    throw std::invalid_argument(
+      "Box boundary was given " + std::to_string(lowerBounds.size())
+      + " lower bounds, but " + std::to_string(upperBounds.size())
+      + " upper bounds.");
+  }
+  if (!(lowerBounds.array() < upperBounds.array()).all()) {
+    throw std::invalid_argument(
+      "Box boundary lower bounds should be smaller than the upper bounds.");
+  }
+}
+
+template<>
+auto BoxBoundary::getPoissonProcessStrategy<LinearFlow>() const {
+  auto strategy =
+    [lowerBounds = lowerBounds_, upperBounds = upperBounds_]
+    (const auto& state, const auto&, const auto&) {
+      const int dimension = lowerBounds.size();
+      if (state.size() != 2 * dimension) {
+        throw std::runtime_error(
+          "Box boundary poisson process strategy was invoked with a vector "
+          "of size " + std::to_string(state.size()) + ", but the size should "
+          "be " + std::to_string(2 * dimension) + ".");
+      }
+      double time = std::numeric_limits<double>::infinity();
+      for (int i = 0; i < dimension; i++) {
+        time = std::min(time, getIntervalHittingTime(
+          state(i), state(dimension + i), lowerBounds(i), upperBounds(i)));
+      }
+      return dependencies_graph::wrapPoissonProcessResult(time);
+    };
+  return strategy;
+}
+
+auto BoxBoundary::getReflectionKernel() const {
+  auto kernel =
+    [lowerBounds = lowerBounds_, upperBounds = upperBounds_]
+    (auto&& stateVector) {
+      const int dimension = lowerBounds.size();
+      RealVector newVector = stateVector;
+      // The coordinate which hit the boundary is the one which would hit it
+      // first from here, which is robust to rounding of the positions.
+      int hittingCoordinate = 0;
+      double hittingTime = std::numeric_limits<double>::infinity();
+      for (int i = 0; i < dimension; i++) {
+        const double time = getIntervalHittingTime(
+          newVector(i), newVector(dimension + i),
+          lowerBounds(i), upperBounds(i));
+        if (time < hittingTime) {
+          hittingCoordinate = i;
+          hittingTime = time;
+        }
+      }
+      newVector(dimension + hittingCoordinate) *= -1.0;
+      return newVector;
+    };
+  return kernel;
+}
+
+BoxBoundary BoxBoundary::getCoordinateBoundary(int coordinate) const {
+  if (coordinate < 0 || coordinate >= getDimension()) {
+    throw std::out_of_range("Coordinate " + std::to_string(coordinate)
+                            + " is out of range. Should be 0 <= coordinate < "
+                            + std::to_string(getDimension()) + ".");
+  }
+  return BoxBoundary(lowerBounds_.segment(coordinate, 1),
+                     upperBounds_.segment(coordinate, 1));
+}
+
+int BoxBoundary::getDimension() const {
+  return lowerBounds_.size();
+}
+
+}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Eigen/Core>
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * The boundary of the half-space {x : <normal, x> <= offset}, e.g. of an
+ * ordering constraint x_1 <= x_2.
+ *
+ * Under a linear flow the hitting time of the hyperplane is deterministic
+ * and known in closed form, so the boundary is a factor with an exact O(1)
+ * event time, at which the velocity is specularly reflected off the
+ * hyperplane: v' = v - 2 <normal, v> / |normal|^2 * normal.
+ *
+ * The initial state should be inside the half-space.
+ */
+class HalfSpaceBoundary {
+
+ public:
+
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+
+  /**
+   * Creates the boundary of the half-space {x : <normal, x> <= offset}.
+   */
+  HalfSpaceBoundary(const RealVector& normal, double offset);
+
+  /**
+   * Returns the strategy simulating the time when the particle hits the
+   * boundary. The strategy expects the positions followed by the
+   * velocities.
+   */
+  template<class Flow>
+  auto getPoissonProcessStrategy() const;
+
+  /**
+   * Returns the kernel specularly reflecting the velocity off the boundary.
+   */
+  auto getReflectionKernel() const;
+
+  int getDimension() const;
+
+ private:
+
+  RealVector normal_;
+  double offset_;
+
+};
+
+}
+}
+
+#include "half_space_boundary.tcc"
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "core/policies/linear_flow.h"
+#include "core/policies/poisson_process.h"
+
+namespace pdmp {
+namespace mcmc {
+
+HalfSpaceBoundary::HalfSpaceBoundary(const RealVector& normal, double offset)
+  : normal_(normal),
+    offset_(offset) {
+
+  if (normal.size() == 0 || normal.squaredNorm() == 0.0) {
+    throw std::invalid_argument(
+      "Half-space boundary normal should be a non-zero vector.");
+  }
+}
+
+template<>
+auto HalfSpaceBoundary::getPoissonProcessStrategy<LinearFlow>() const {
+  auto strategy =
+    [normal = normal_, offset = offset_]
+    (const auto& state, const auto&, const auto&) {
+      const int dimension = normal.size();
+      if (state.size() != 2 * dimension) {
+        throw std::runtime_error(
+          "Half-space boundary poisson process strategy was invoked with a "
+          "vector of size " + std::to_string(state.size()) + ", but the size "
+          "should be " + std::to_string(2 * dimension) + ".");
+      }
+      const double normalVelocity = normal.dot(state.tail(dimension));
+      if (normalVelocity <= 0.0) {
+        // Moving away from, or parallel to, the boundary.
+        return dependencies_graph::wrapPoissonProcessResult(
+          std::numeric_limits<double>::infinity());
+      }
+      const double slack = offset - normal.dot(state.head(dimension));
+      return dependencies_graph::wrapPoissonProcessResult(
+        std::max(0.0, slack / normalVelocity));
+    };
+  return strategy;
+}
+
+auto HalfSpaceBoundary::getReflectionKernel() const {
+  auto kernel = [normal = normal_] (auto&& stateVector) {
+    const int dimension = normal.size();
+    RealVector newVector = stateVector;
+    const double normalVelocity = normal.dot(newVector.tail(dimension));
+    newVector.tail(dimension) -=
+      2.0 * normalVelocity / normal.squaredNorm() * normal;
+    return newVector;
+  };
+  return kernel;
+}
+
+int HalfSpaceBoundary::getDimension() const {
+  return normal_.size();
+}
+
+}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "core/pdmp.h"
+#include "core/state_space/position_and_velocity_state.h"
+#include "mcmc/distributions/gaussian.h"
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * Simulates many independent global Bouncy Particle Samplers targeting the
+ * same Gaussian distribution, e.g. hundreds of chains of a low-dimensional
+ * model, where the per-event overhead of a Pdmp per chain dominates.
+ *
+ * The positions and velocities of the chains are stored as d x N arrays
+ * (a row per variable, a column per chain), so each step simulates the
+ * next event of every chain with vectorized operations over the chains:
+ * the exact bounce times (the intensity is affine along the flow), the
+ * refreshment times, the flow, and the bounces and refreshments as masked
+ * updates. Each chain has its own clock and its own random number
+ * generator seeded by the chain id, so the trajectory of a chain does not
+ * depend on the other chains.
+ */
+class BatchedGaussianBps {
+
+ public:
+
+  using State = DynamicPositionAndVelocityState<double>;
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+  /**
+   * Called with the chain id and the iteration result (the state after the
+   * jump and the time since the previous event) of each simulated event.
+   * Use an analysis::BatchedChainsRunner to notify the usual observers
+   * (e.g. the output processors) of each chain instead.
+   */
+  using Observer =
+    std::function<void(int chainId, const IterationResult<State>&)>;
+
+  /**
+   * Creates the chains at the mean of the distribution, with standard
+   * normal velocities.
+   *
+   * @param distribution
+   *   The target distribution.
+   * @param refreshRate
+   *   The rate of the full refreshments of the velocities.
+   * @param numberOfChains
+   *   The number of chains.
+   * @param seed
+   *   The seed of the random number generators of the chains.
+   */
+  BatchedGaussianBps(
+    const GaussianDistribution& distribution, double refreshRate,
+    int numberOfChains, std::uint64_t seed);
+
+  int getNumberOfChains() const;
+
+  /**
+   * Sets the state of the given chain.
+   */
+  void setState(int chainId, const State& state);
+
+  /**
+   * Returns the state of the given chain after its last event.
+   */
+  State getState(int chainId) const;
+
+  /**
+   * Returns the time of the last event of the given chain.
+   */
+  double getTime(int chainId) const;
+
+  /**
+   * Simulates the given number of events of each chain, notifying the
+   * observer (if any) of each event in the order of the chains.
+   */
+  void simulateIterations(
+    int numberOfIterations, const Observer& observer = nullptr);
+
+ private:
+
+  using RealArray =
+    Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using RealRowArray = Eigen::Array<double, 1, Eigen::Dynamic>;
+
+  // Simulates the next event of each chain.
+  void simulateOneIteration();
+
+  // Checks that the chain id is in range.
+  void checkChainId(int chainId) const;
+
+  RealVector mean_;
+  RealMatrix precisionMatrix_;
+  double refreshRate_;
+
+  RealArray positions_;
+  RealArray velocities_;
+  RealRowArray times_;
+  RealRowArray lastIterationTimes_;
+  std::vector<std::mt19937_64> rngs_;
+
+};
+
+}
+}
+
+#include "batched_gaussian_bps.tcc"
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace pdmp {
+namespace mcmc {
+
+BatchedGaussianBps::BatchedGaussianBps(
+  const GaussianDistribution& distribution, double refreshRate,
+  int numberOfChains, std::uint64_t seed)
+  : mean_(distribution.getMean()),
+    precisionMatrix_(distribution.getPrecisionMatrix()),
+    refreshRate_(refreshRate) {
+
+  if (numberOfChains < 1) {
+    throw std::invalid_argument(
+      "The number of chains should be positive, but "
+      + std::to_string(numberOfChains) + " was given.");
+  }
+  if (refreshRate < 0.0) {
+    throw std::invalid_argument(
+      "Refresh rate should be non-negative, but is "
+      + std::to_string(refreshRate) + ".");
+  }
+  const int dimension = mean_.size();
+  positions_ = mean_.array().replicate(1, numberOfChains);
+  velocities_.resize(dimension, numberOfChains);
+  times_ = RealRowArray::Zero(numberOfChains);
+  lastIterationTimes_ = RealRowArray::Zero(numberOfChains);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  for (int k = 0; k < numberOfChains; k++) {
+    std::seed_seq seedSequence{
+      static_cast<std::uint32_t>(seed),
+      static_cast<std::uint32_t>(seed >> 32),
+      static_cast<std::uint32_t>(k)};
+    rngs_.emplace_back(seedSequence);
+    for (int i = 0; i < dimension; i++) {
+      velocities_(i, k) = normal(rngs_[k]);
+    }
+  }
+}
+
+int BatchedGaussianBps::getNumberOfChains() const {
+  return rngs_.size();
+}
+
+void BatchedGaussianBps::setState(int chainId, const State& state) {
+  checkChainId(chainId);
+  if (state.position.size() != mean_.size()) {
+    throw std::invalid_argument(
+      "The state has " + std::to_string(state.position.size())
+      + " model variables, but the distribution has "
+      + std::to_string(mean_.size()) + ".");
+  }
+  positions_.col(chainId) = state.position.array();
+  velocities_.col(chainId) = state.velocity.array();
+}
+
+BatchedGaussianBps::State BatchedGaussianBps::getState(int chainId) const {
+  checkChainId(chainId);
+  return State(positions_.col(chainId).matrix(),
+               velocities_.col(chainId).matrix());
+}
+
+double BatchedGaussianBps::getTime(int chainId) const {
+  checkChainId(chainId);
+  return times_(chainId);
+}
+
+void BatchedGaussianBps::simulateIterations(
+  int numberOfIterations, const Observer& observer) {
+
+  for (int iteration = 0; iteration < numberOfIterations; iteration++) {
+    simulateOneIteration();
+    if (observer) {
+      for (int k = 0; k < getNumberOfChains(); k++) {
+        observer(k, IterationResult<State>(
+          getState(k), lastIterationTimes_(k)));
+      }
+    }
+  }
+}
+
+void BatchedGaussianBps::simulateOneIteration() {
+  const int dimension = mean_.size();
+  const int numberOfChains = getNumberOfChains();
+
+  // The energy gradients P (x - mean) and the rates of change P v along
+  // the flow, for all the chains at once.
+  RealArray energyGradients = (precisionMatrix_ * (
+    positions_ - mean_.array().replicate(1, numberOfChains)).matrix()).array();
+  RealArray gradientRates =
+    (precisionMatrix_ * velocities_.matrix()).array();
+  // The bounce intensity along the flow is max(0, a + b t).
+  RealRowArray a = (velocities_ * energyGradients).colwise().sum();
+  RealRowArray b = (velocities_ * gradientRates).colwise().sum();
+
+  RealRowArray bounceExponentials(numberOfChains);
+  RealRowArray refreshExponentials(numberOfChains);
+  std::exponential_distribution<double> exponential(1.0);
+  for (int k = 0; k < numberOfChains; k++) {
+    bounceExponentials(k) = exponential(rngs_[k]);
+    refreshExponentials(k) = exponential(rngs_[k]);
+  }
+  // Inverts the integrated intensity for both signs of a at once.
+  RealRowArray bounceTimes = (b > 0.0).select(
+    (-a + (a.max(0.0).square() + 2.0 * b * bounceExponentials).sqrt()) / b,
+    std::numeric_limits<double>::infinity());
+  RealRowArray refreshTimes = refreshRate_ > 0.0
+    ? RealRowArray(refreshExponentials / refreshRate_)
+    : RealRowArray::Constant(
+        numberOfChains, std::numeric_limits<double>::infinity());
+  lastIterationTimes_ = bounceTimes.min(refreshTimes);
+  times_ += lastIterationTimes_;
+
+  const RealArray iterationTimes =
+    lastIterationTimes_.replicate(dimension, 1);
+  positions_ += velocities_ * iterationTimes;
+  energyGradients += gradientRates * iterationTimes;
+
+  // Reflect the velocities of the bouncing chains on the gradient.
+  RealRowArray reflectionScales = 2.0
+    * (velocities_ * energyGradients).colwise().sum()
+    / energyGradients.square().colwise().sum();
+  RealArray reflectedVelocities = velocities_
+    - energyGradients * reflectionScales.replicate(dimension, 1);
+  const auto isBounce = (bounceTimes <= refreshTimes).replicate(dimension, 1);
+  velocities_ = isBounce.select(reflectedVelocities, velocities_);
+
+  std::normal_distribution<double> normal(0.0, 1.0);
+  for (int k = 0; k < numberOfChains; k++) {
+    if (refreshTimes(k) < bounceTimes(k)) {
+      for (int i = 0; i < dimension; i++) {
+        velocities_(i, k) = normal(rngs_[k]);
+      }
+    }
+  }
+}
+
+void BatchedGaussianBps::checkChainId(int chainId) const {
+  if (chainId < 0 || chainId >= getNumberOfChains()) {
+    throw std::out_of_range(
+      "Chain id " + std::to_string(chainId) + " is out of range. Should be "
+      "0 <= id < " + std::to_string(getNumberOfChains()) + ".");
+  }
+}
+
+}
+}
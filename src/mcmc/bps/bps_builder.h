@@ -1,9 +1,17 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "core/policies/linear_flow.h"
 #include "core/state_space/position_and_velocity_state.h"
 #include "mcmc/pdmp_builder_base.h"
+#include "mcmc/boundaries/box_boundary.h"
+#include "mcmc/boundaries/half_space_boundary.h"
+#include "mcmc/bps/refresh_rate_controller.h"
 #include "mcmc/distributions/distribution_base.h"
+#include "mcmc/distributions/gaussian.h"
+#include "mcmc/subsampling/data_sum_factor.h"
 
 namespace pdmp {
 namespace mcmc {
@@ -15,18 +23,62 @@ using Flow = LinearFlow;
 
 }
 
+/**
+ * The Markov kernels, which can be used for the BPS bounces.
+ */
+enum class BounceKernelType {
+  // Reflects the velocity off the energy gradient.
+  Reflection,
+  // Reflects the velocity component along the energy gradient and resamples
+  // the orthogonal component (see getForwardEventChainKernel).
+  ForwardEventChain
+};
+
+/**
+ * The velocity refreshment settings of a factor. Implicitly constructible
+ * from the refresh rate alone, which gives the standard BPS refreshment.
+ */
+struct RefreshmentOptions {
+
+  RefreshmentOptions(
+    double rate = 1.0, double autocorrelation = 0.0, bool randomSubset = false);
+
+  // The rate of refreshment events. A rate of zero adds no refreshment
+  // factor at all, which is mostly useful with the forward event-chain
+  // bounce kernel.
+  double rate;
+
+  // The autoregressive coefficient rho in (-1, 1) of the partial refreshment
+  // v' = rho * v + sqrt(1 - rho^2) * xi, where xi ~ N(0, I). For rho = 0
+  // a fresh velocity is drawn.
+  double autocorrelation;
+
+  // If true, each refreshment event refreshes a single uniformly chosen
+  // velocity of the factor, so that only the factors depending on that
+  // variable need resimulating. The total refresh rate stays the same.
+  bool randomSubset;
+
+};
+
 /**
  * A class for building PDMPs that simulate based on the
  * Bouncy Particle Sampler algorithm.
+ *
+ * The refresh rates of all the refreshment factors are read from a shared
+ * RefreshRateController, so they can be tuned after building, e.g. by
+ * running a RefreshRateAdapter observer during burn-in.
  */
 class BpsBuilder : protected PdmpBuilderBase<bps::State, bps::Flow> {
 
  public:
 
   /**
-   * Takes the number of probability model variables as input.
+   * Takes the number of probability model variables as input, and the
+   * kernel used for all the bounces.
    */
-  BpsBuilder(int numberOfModelVariables);
+  BpsBuilder(
+    int numberOfModelVariables,
+    BounceKernelType bounceKernelType = BounceKernelType::Reflection);
 
   /**
    * Adds a factor, with the given distribution, acting on the specified
@@ -35,12 +87,130 @@ class BpsBuilder : protected PdmpBuilderBase<bps::State, bps::Flow> {
    * @param Ids
    *   The variable ids (indexed from 0), on which this factor depends.
    * @param distribution
+   * @param refreshment
+   *   The refreshment of the velocities of the given variables, or simply
+   *   its rate.
    */
   template<class Distribution>
   void addFactor(
     const std::vector<int>& variableIds,
     const DistributionBase<Distribution>& distribution,
-    double refreshRate = 1.0);
+    const RefreshmentOptions& refreshment = RefreshmentOptions());
+
+  /**
+   * Adds a Gaussian factor, acting on the specified model variables. If
+   * factor fusion is enabled (see setFactorsPerBlock), the factor may be
+   * fused with the Gaussian factors added just before it.
+   */
+  void addFactor(
+    const std::vector<int>& variableIds,
+    const GaussianDistribution& distribution,
+    const RefreshmentOptions& refreshment = RefreshmentOptions());
+
+  /**
+   * Adds a data-sum factor, acting on the specified model variables.
+   * Bounces use the same control variate gradient estimate which
+   * triggered the event.
+   *
+   * @param Ids
+   *   The variable ids (indexed from 0), on which this factor depends.
+   * @param dataSumFactor
+   * @param refreshment
+   *   The refreshment of the velocities of the given variables, or simply
+   *   its rate.
+   */
+  template<class DatumEnergyGradient>
+  void addFactor(
+    const std::vector<int>& variableIds,
+    const DataSumFactor<DatumEnergyGradient>& dataSumFactor,
+    const RefreshmentOptions& refreshment = RefreshmentOptions());
+
+  /**
+   * Adds many factors at once, the k-th with the k-th distribution acting on
+   * the k-th variable ids, e.g. for models with millions of factors. The
+   * factor, bounce kernel and refreshment nodes are constructed on the given
+   * number of threads (see PdmpBuilderBase::addFactorAndMarkovKernelNodes),
+   * and Gaussian factors added this way are not fused into blocks.
+   */
+  template<class Distribution>
+  void addFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const std::vector<Distribution>& distributions,
+    const RefreshmentOptions& refreshment = RefreshmentOptions(),
+    int numberOfThreads = 1);
+
+  /**
+   * Enables the fusion of up to the given number of consecutively added,
+   * overlapping Gaussian factors into a single Gaussian factor on the union
+   * of their variables, whose precision matrix is the sum of theirs. E.g.
+   * k consecutive pairwise factors of a chain become one banded factor on
+   * k + 1 variables. Fewer, larger factors mean fewer events and queue
+   * entries, but more expensive events, so the block size trades event
+   * count against per-event cost.
+   *
+   * Only the bounce factors are fused: each fused factor keeps its own
+   * refreshment factor, so the velocities are refreshed as without the
+   * fusion. Blocks whose summed precision matrix is singular are not fused.
+   * A block size of 1 (the default) disables the fusion.
+   */
+  void setFactorsPerBlock(int factorsPerBlock);
+
+  /**
+   * Tempers the target factors added after the call (distributions, fused
+   * Gaussian blocks and data-sum factors), so that the built PDMP targets
+   * pi^beta for the given inverse temperature beta in (0, 1] (see
+   * getTemperedStrategy), e.g. for the replicas of a ParallelTempering
+   * driver. Boundaries and refreshments are not tempered. Usually called
+   * right after construction.
+   */
+  void setInverseTemperature(double inverseTemperature);
+
+  /**
+   * Restricts the specified model variables to a box. Each coordinate gets
+   * its own boundary factor, so that hitting a wall costs a single O(1)
+   * event, which only affects the factors of the hitting coordinate.
+   *
+   * @param Ids
+   *   The variable ids (indexed from 0) of the box coordinates.
+   * @param boundary
+   */
+  void addBoundary(
+    const std::vector<int>& variableIds, const BoxBoundary& boundary);
+
+  /**
+   * Restricts the specified model variables to a half-space, whose
+   * boundary specularly reflects the velocity.
+   *
+   * @param Ids
+   *   The variable ids (indexed from 0), on which the constraint depends.
+   * @param boundary
+   */
+  void addBoundary(
+    const std::vector<int>& variableIds, const HalfSpaceBoundary& boundary);
+
+  /**
+   * Optional renumbering of the model variables for cache locality, with the
+   * mapping of the states to and from the user-facing variable ids
+   * (see PdmpBuilderBase::setVariableOrdering).
+   */
+  using PdmpBuilderBase<bps::State, bps::Flow>::setVariableOrdering;
+  using PdmpBuilderBase<bps::State, bps::Flow>::getVariablePermutation;
+  using PdmpBuilderBase<bps::State, bps::Flow>::getInternalState;
+  using PdmpBuilderBase<bps::State, bps::Flow>::getUserState;
+
+  /**
+   * Special handling of the events modifying high-degree variables, and a
+   * report of the degrees and event costs (see
+   * PdmpBuilderBase::setHubThreshold).
+   */
+  using PdmpBuilderBase<bps::State, bps::Flow>::setHubThreshold;
+  using PdmpBuilderBase<bps::State, bps::Flow>::getFactorGraphReport;
+
+  /**
+   * Parallel resimulation of the factors affected by wide events (see
+   * PdmpBuilderBase::setParallelResimulation).
+   */
+  using PdmpBuilderBase<bps::State, bps::Flow>::setParallelResimulation;
 
   /**
    * Returns the PDMP that can be used to simulated from the constructed
@@ -48,9 +218,160 @@ class BpsBuilder : protected PdmpBuilderBase<bps::State, bps::Flow> {
    */
   auto build();
 
+  /**
+   * Returns an immutable model, from which the PDMPs of many chains can be
+   * created, sharing the dependencies graph and the parameters of the
+   * factors (see PdmpBuilderBase::buildModel).
+   */
+  using Model = PdmpBuilderBase<bps::State, bps::Flow>::Model;
+  std::shared_ptr<const Model> buildModel();
+
+  /**
+   * Returns a parallel simulator of the PDMP, with the model variables split
+   * into the given number of partitions (see
+   * PdmpBuilderBase::buildPartitioned).
+   */
+  auto buildPartitioned(int numberOfPartitions);
+
+  /**
+   * Returns the controller of the refresh rates of the built PDMP.
+   */
+  std::shared_ptr<RefreshRateController> getRefreshRateController() const;
+
+  /**
+   * Returns the controller of the refresh rates of the given PDMP built by
+   * this builder, which also resimulates the pending refreshment events of
+   * the PDMP when the scale changes, e.g. for a RefreshRateAdapter. Throws
+   * std::logic_error if the factors are shared by several PDMPs or chains
+   * (see setGaussianParameters), whose refreshment events would not be
+   * resimulated.
+   */
+  template<class Pdmp>
+  std::shared_ptr<PdmpRefreshRateController<Pdmp>> getRefreshRateController(
+    Pdmp& pdmp) const;
+
+  /**
+   * Replaces the distribution of the k-th added Gaussian factor of the
+   * PDMP built by this builder, e.g. for sensitivity analyses over the
+   * parameters of the target, without rebuilding the PDMP. Only the pending
+   * event of the factor is resimulated, by the next iteration of the PDMP.
+   *
+   * The PDMP should be the only one built, as the factors of several PDMPs,
+   * of the chains of a model or of a partitioned PDMP are shared, and the
+   * others would keep events simulated for the previous distribution.
+   * Throws std::logic_error if the factors are shared in this way, or fused
+   * into a block (see setFactorsPerBlock), std::out_of_range for unknown
+   * factors and std::invalid_argument if the dimension of the distribution
+   * changes.
+   */
+  template<class Pdmp>
+  void setGaussianParameters(
+    Pdmp& pdmp, int gaussianFactorIndex,
+    const GaussianDistribution& distribution);
+
+  /**
+   * Sets the scale of the refresh rates (see RefreshRateController) of the
+   * given PDMP built by this builder, e.g. for sweeps over the refresh
+   * rate, without rebuilding the PDMP. Only the pending events of the
+   * refreshment factors are resimulated. As for setGaussianParameters,
+   * throws std::logic_error if the factors are shared by several PDMPs or
+   * chains.
+   */
+  template<class Pdmp>
+  void setRefreshRateScale(Pdmp& pdmp, double scale);
+
  private:
 
+  // Adds a factor and its bounce kernel, whose lambdas are created from the
+  // Poisson process strategy and the log probability gradient returned by
+  // createStrategyAndGradient.
+  template<class F>
+  void addBounceFactor(
+    const std::vector<int>& variableIds, const F& createStrategyAndGradient);
+
+  // Adds the factors and bounce kernels of the given variable ids at once,
+  // on the given number of threads. createStrategyAndGradient(k) returns
+  // the lambdas of the k-th factor (see addBounceFactor).
+  template<class F>
+  void addBounceFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const F& createStrategyAndGradient,
+    int numberOfThreads);
+
+  // Adds the factor, bounce kernel and refreshment nodes of a distribution.
+  template<class Distribution>
+  void addDistributionFactor(
+    const std::vector<int>& variableIds,
+    const DistributionBase<Distribution>& distribution,
+    const RefreshmentOptions& refreshment);
+
+  // Adds the nodes of a Gaussian factor, whose distribution can be replaced
+  // after building.
+  void addGaussianFactor(
+    const std::vector<int>& variableIds,
+    const GaussianDistribution& distribution,
+    const RefreshmentOptions& refreshment);
+
+  // Adds the factors and bounce kernels of many distributions at once (see
+  // addBounceFactors).
+  template<class Distribution>
+  void addDistributionFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const std::vector<Distribution>& distributions,
+    int numberOfThreads);
+
+  void addDistributionFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const std::vector<GaussianDistribution>& distributions,
+    int numberOfThreads);
+
+  // Adds the pending block of Gaussian factors as a single fused factor.
+  void flushFactorBlock();
+
+  // Adds the factor and the reflection kernel of a boundary.
+  template<class Boundary>
+  void addBoundaryFactor(
+    const std::vector<int>& variableIds, const Boundary& boundary);
+
+  // Adds the refreshment factors and their Markov kernels, which resample
+  // the velocities of the given model variables.
+  void addRefreshmentFactor(
+    const std::vector<int>& variableIds,
+    const RefreshmentOptions& refreshment);
+
+  // Adds the refreshment factors of many factors at once, on the given
+  // number of threads.
+  void addRefreshmentFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const RefreshmentOptions& refreshment,
+    int numberOfThreads);
+
   int numberOfModelVariables_;
+  BounceKernelType bounceKernelType_;
+  double inverseTemperature_{1.0};
+  std::shared_ptr<RefreshRateController> refreshRateController_;
+  // The factor ids of the refreshment factors, by their controller ids.
+  std::vector<int> refreshmentFactorIds_;
+
+  // The distributions of the Gaussian factors in the order of addition,
+  // shared with their nodes, and their factor ids. The distributions of the
+  // factors fused into a block are null.
+  struct GaussianFactor {
+    std::shared_ptr<GaussianDistribution> distribution;
+    int factorId;
+  };
+  std::vector<GaussianFactor> gaussianFactors_;
+
+  // Whether a PDMP was built, and whether the factors were shared by
+  // several PDMPs or chains.
+  bool isBuilt_{false};
+  bool areFactorsShared_{false};
+
+  // The Gaussian factors waiting to be fused into a block.
+  int factorsPerBlock_{1};
+  std::vector<std::vector<int>> pendingVariableIds_;
+  std::vector<GaussianDistribution> pendingDistributions_;
+  std::vector<RefreshmentOptions> pendingRefreshments_;
 
 };
 
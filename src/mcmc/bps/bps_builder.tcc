@@ -1,7 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 
+#include <Eigen/Cholesky>
 #include <Eigen/Core>
 
 #include "mcmc/utils.h"
@@ -25,16 +31,37 @@ auto getRefreshmentStrategy(double refreshRate) {
   return refreshmentStrategy;
 }
 
-auto getRefreshmentKernel() {
+// Reads the rate of the given refreshment factor from the controller at every
+// event, so that it follows the tuning of the rates.
+auto getRefreshmentStrategy(
+  std::shared_ptr<const RefreshRateController> controller, int factorId) {
+
+  auto rng = getRng();
+  auto refreshmentStrategy =
+    [rng, controller, factorId]
+    (const auto&, const auto&, const auto&) mutable {
+      return dependencies_graph::wrapPoissonProcessResult(
+        stan::math::exponential_rng(controller->getRate(factorId), rng));
+    };
+  return refreshmentStrategy;
+}
+
+// Draws v' = rho * v + sqrt(1 - rho^2) * xi, i.e. a fresh velocity if
+// rho = 0.
+auto getRefreshmentKernel(double autocorrelation = 0.0) {
   using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
   auto rng = getRng();
+  const double noiseScale = sqrt(1.0 - autocorrelation * autocorrelation);
   auto refreshmentKernel =
-    [rng] (const auto& state) mutable {
+    [rng, autocorrelation, noiseScale] (const auto& state) mutable {
       int stateSize = state.size();
       RealVector refreshed(stateSize);
       for (int i = 0; i < stateSize; i++) {
         refreshed(i) = stan::math::normal_rng(0.0, 1.0, rng);
       }
+      if (autocorrelation != 0.0) {
+        refreshed = autocorrelation * state + noiseScale * refreshed;
+      }
       return refreshed;
     };
   return refreshmentKernel;
@@ -69,58 +96,610 @@ static std::vector<int> getVelocityVariables(
 
 }
 
-BpsBuilder::BpsBuilder(int numberOfModelVariables)
+RefreshmentOptions::RefreshmentOptions(
+  double rate, double autocorrelation, bool randomSubset)
+  : rate(rate),
+    autocorrelation(autocorrelation),
+    randomSubset(randomSubset) {
+
+  if (rate < 0.0) {
+    throw std::invalid_argument(
+      "Refresh rate should be non-negative, but is " + std::to_string(rate)
+      + ".");
+  }
+  if (autocorrelation <= -1.0 || autocorrelation >= 1.0) {
+    throw std::invalid_argument(
+      "Refreshment autocorrelation should be in (-1, 1), but is "
+      + std::to_string(autocorrelation) + ".");
+  }
+}
+
+BpsBuilder::BpsBuilder(
+  int numberOfModelVariables, BounceKernelType bounceKernelType)
   : PdmpBuilderBase<bps::State, bps::Flow>(numberOfModelVariables * 2),
-    numberOfModelVariables_(numberOfModelVariables) {
+    numberOfModelVariables_(numberOfModelVariables),
+    bounceKernelType_(bounceKernelType),
+    refreshRateController_(std::make_shared<RefreshRateController>()) {
 }
 
 template<class Distribution>
 void BpsBuilder::addFactor(
     const std::vector<int>& variableIds,
     const DistributionBase<Distribution>& distribution,
-    double refreshRate) {
+    const RefreshmentOptions& refreshment) {
+
+  this->flushFactorBlock();
+  this->addDistributionFactor(variableIds, distribution, refreshment);
+}
+
+void BpsBuilder::addFactor(
+    const std::vector<int>& variableIds,
+    const GaussianDistribution& distribution,
+    const RefreshmentOptions& refreshment) {
+
+  if (factorsPerBlock_ == 1) {
+    this->addGaussianFactor(variableIds, distribution, refreshment);
+    return;
+  }
+
+  // The factor joins the pending block if the block has room and overlaps
+  // with the factor.
+  bool isOverlapping = false;
+  for (const auto& pendingIds : pendingVariableIds_) {
+    for (int variableId : variableIds) {
+      if (std::find(pendingIds.begin(), pendingIds.end(), variableId)
+          != pendingIds.end()) {
+        isOverlapping = true;
+      }
+    }
+  }
+  if (pendingVariableIds_.size() == factorsPerBlock_ || !isOverlapping) {
+    this->flushFactorBlock();
+  }
+  pendingVariableIds_.push_back(variableIds);
+  pendingDistributions_.push_back(distribution);
+  pendingRefreshments_.push_back(refreshment);
+}
+
+template<class Distribution>
+void BpsBuilder::addDistributionFactor(
+    const std::vector<int>& variableIds,
+    const DistributionBase<Distribution>& distribution,
+    const RefreshmentOptions& refreshment) {
+
+  this->addBounceFactor(
+    variableIds,
+    [distribution = static_cast<const Distribution&>(distribution)] () {
+      auto poissonProcessStrategy =
+        distribution.template getPoissonProcessStrategy<bps::Flow>();
+      return std::make_tuple(
+        poissonProcessStrategy, distribution.getLogPdfGradient());
+    });
+
+  this->addRefreshmentFactor(variableIds, refreshment);
+}
+
+void BpsBuilder::addGaussianFactor(
+    const std::vector<int>& variableIds,
+    const GaussianDistribution& distribution,
+    const RefreshmentOptions& refreshment) {
 
-  const std::vector<int> variablesNeededByReflectionKernel =
+  auto sharedDistribution =
+    std::make_shared<GaussianDistribution>(distribution);
+  gaussianFactors_.push_back(
+    GaussianFactor{sharedDistribution, numberOfFactorsAdded_});
+  this->addBounceFactor(
+    variableIds,
+    [distribution =
+       std::shared_ptr<const GaussianDistribution>(sharedDistribution)] () {
+      return std::make_tuple(
+        GaussianDistribution::getSharedPoissonProcessStrategy(distribution),
+        GaussianDistribution::getSharedLogPdfGradient(distribution));
+    });
+
+  this->addRefreshmentFactor(variableIds, refreshment);
+}
+
+template<class DatumEnergyGradient>
+void BpsBuilder::addFactor(
+    const std::vector<int>& variableIds,
+    const DataSumFactor<DatumEnergyGradient>& dataSumFactor,
+    const RefreshmentOptions& refreshment) {
+
+  this->flushFactorBlock();
+
+  this->addBounceFactor(
+    variableIds,
+    [dataSumFactor] () {
+      // The factor node stores the accepted gradient estimate in the cache,
+      // from which the bounce kernel reads it.
+      auto cache = std::make_shared<GradientEstimateCache>();
+      auto logProbGradient = [cache] (const auto&) {
+        Eigen::Matrix<double, Eigen::Dynamic, 1> gradient =
+          -1.0 * cache->energyGradient;
+        return gradient;
+      };
+      auto poissonProcessStrategy = dataSumFactor.template
+        getBpsPoissonProcessStrategy<bps::Flow>(cache);
+      return std::make_tuple(poissonProcessStrategy, logProbGradient);
+    });
+
+  this->addRefreshmentFactor(variableIds, refreshment);
+}
+
+template<class Distribution>
+void BpsBuilder::addFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const std::vector<Distribution>& distributions,
+    const RefreshmentOptions& refreshment,
+    int numberOfThreads) {
+
+  if (variableIds.size() != distributions.size()) {
+    throw std::invalid_argument(
+      "Got " + std::to_string(distributions.size()) + " distributions for "
+      + std::to_string(variableIds.size()) + " factors.");
+  }
+  this->flushFactorBlock();
+  this->addDistributionFactors(variableIds, distributions, numberOfThreads);
+  this->addRefreshmentFactors(variableIds, refreshment, numberOfThreads);
+}
+
+template<class Distribution>
+void BpsBuilder::addDistributionFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const std::vector<Distribution>& distributions,
+    int numberOfThreads) {
+
+  auto sharedDistributions =
+    std::make_shared<const std::vector<Distribution>>(distributions);
+  this->addBounceFactors(
+    variableIds,
+    [sharedDistributions] (int factorIndex) {
+      const Distribution& distribution = (*sharedDistributions)[factorIndex];
+      auto poissonProcessStrategy =
+        distribution.template getPoissonProcessStrategy<bps::Flow>();
+      return std::make_tuple(
+        poissonProcessStrategy, distribution.getLogPdfGradient());
+    },
+    numberOfThreads);
+}
+
+void BpsBuilder::addDistributionFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const std::vector<GaussianDistribution>& distributions,
+    int numberOfThreads) {
+
+  // As in addGaussianFactor, each factor reads its own shared distribution.
+  auto sharedDistributions = std::make_shared<
+    std::vector<std::shared_ptr<const GaussianDistribution>>>();
+  for (int k = 0; k < distributions.size(); k++) {
+    auto sharedDistribution =
+      std::make_shared<GaussianDistribution>(distributions[k]);
+    gaussianFactors_.push_back(
+      GaussianFactor{sharedDistribution, numberOfFactorsAdded_ + k});
+    sharedDistributions->push_back(sharedDistribution);
+  }
+  this->addBounceFactors(
+    variableIds,
+    [sharedDistributions] (int factorIndex) {
+      const auto& distribution = (*sharedDistributions)[factorIndex];
+      return std::make_tuple(
+        GaussianDistribution::getSharedPoissonProcessStrategy(distribution),
+        GaussianDistribution::getSharedLogPdfGradient(distribution));
+    },
+    numberOfThreads);
+}
+
+template<class F>
+void BpsBuilder::addBounceFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const F& createStrategyAndGradient,
+    int numberOfThreads) {
+
+  using FactorSpec = PdmpBuilderBase<bps::State, bps::Flow>::FactorSpec;
+  std::vector<FactorSpec> factorSpecs;
+  factorSpecs.reserve(variableIds.size());
+  for (const auto& ids : variableIds) {
+    const std::vector<int> variablesNeededByFactorNode =
+      getPositionAndVelocityVariables(ids, this->numberOfModelVariables_);
+    factorSpecs.push_back(FactorSpec{
+      variablesNeededByFactorNode,
+      variablesNeededByFactorNode,
+      getVelocityVariables(ids, this->numberOfModelVariables_)});
+  }
+  const double inverseTemperature = inverseTemperature_;
+
+  if (bounceKernelType_ == BounceKernelType::ForwardEventChain) {
+    PdmpBuilderBase<bps::State, bps::Flow>::addFactorAndMarkovKernelNodes(
+      factorSpecs,
+      [createStrategyAndGradient, inverseTemperature] (int factorIndex) {
+        auto strategyAndGradient = createStrategyAndGradient(factorIndex);
+        auto bounceKernel =
+          getForwardEventChainKernel(std::get<1>(strategyAndGradient));
+        return std::make_tuple(
+          getTemperedStrategy(
+            std::get<0>(strategyAndGradient), inverseTemperature),
+          bounceKernel);
+      },
+      numberOfThreads);
+  } else {
+    PdmpBuilderBase<bps::State, bps::Flow>::addFactorAndMarkovKernelNodes(
+      factorSpecs,
+      [createStrategyAndGradient, inverseTemperature] (int factorIndex) {
+        auto strategyAndGradient = createStrategyAndGradient(factorIndex);
+        auto bounceKernel =
+          getReflectionKernel(std::get<1>(strategyAndGradient));
+        return std::make_tuple(
+          getTemperedStrategy(
+            std::get<0>(strategyAndGradient), inverseTemperature),
+          bounceKernel);
+      },
+      numberOfThreads);
+  }
+}
+
+template<class F>
+void BpsBuilder::addBounceFactor(
+    const std::vector<int>& variableIds,
+    const F& createStrategyAndGradient) {
+
+  const std::vector<int> variablesNeededByFactorNode =
     getPositionAndVelocityVariables(variableIds, this->numberOfModelVariables_);
-  const std::vector<int> variablesToBeChangedByReflectionKernel =
+  const std::vector<int> variablesToBeChangedByBounceKernel =
     getVelocityVariables(variableIds, this->numberOfModelVariables_);
-  const std::vector<int> variablesNeededByFactorNode =
-    variablesNeededByReflectionKernel;
-
-  auto logPdf = distribution.getLogPdf();
-  auto logProbGradient = getGradientOfAFunctor(logPdf);
-  auto reflectionKernel = getReflectionKernel(logProbGradient);
-  auto poissonProcessStrategy = distribution.template getPoissonProcessStrategy<
-    bps::Flow>();
-
-  PdmpBuilderBase<bps::State, bps::Flow>::addFactorNode(
-    variablesNeededByFactorNode, poissonProcessStrategy);
-  PdmpBuilderBase<bps::State, bps::Flow>::addMarkovKernelNode(
-    variablesNeededByReflectionKernel,
-    variablesToBeChangedByReflectionKernel,
-    reflectionKernel);
-
-  // Now we need to add a the refreshment factor.
+  const double inverseTemperature = inverseTemperature_;
+
+  if (bounceKernelType_ == BounceKernelType::ForwardEventChain) {
+    PdmpBuilderBase<bps::State, bps::Flow>::addFactorAndMarkovKernelNodes(
+      variablesNeededByFactorNode,
+      variablesNeededByFactorNode,
+      variablesToBeChangedByBounceKernel,
+      [createStrategyAndGradient, inverseTemperature] () {
+        auto strategyAndGradient = createStrategyAndGradient();
+        auto bounceKernel =
+          getForwardEventChainKernel(std::get<1>(strategyAndGradient));
+        return std::make_tuple(
+          getTemperedStrategy(
+            std::get<0>(strategyAndGradient), inverseTemperature),
+          bounceKernel);
+      });
+  } else {
+    PdmpBuilderBase<bps::State, bps::Flow>::addFactorAndMarkovKernelNodes(
+      variablesNeededByFactorNode,
+      variablesNeededByFactorNode,
+      variablesToBeChangedByBounceKernel,
+      [createStrategyAndGradient, inverseTemperature] () {
+        auto strategyAndGradient = createStrategyAndGradient();
+        auto bounceKernel =
+          getReflectionKernel(std::get<1>(strategyAndGradient));
+        return std::make_tuple(
+          getTemperedStrategy(
+            std::get<0>(strategyAndGradient), inverseTemperature),
+          bounceKernel);
+      });
+  }
+}
+
+void BpsBuilder::setInverseTemperature(double inverseTemperature) {
+  if (!(inverseTemperature > 0.0 && inverseTemperature <= 1.0)) {
+    throw std::invalid_argument(
+      "Inverse temperature should be in (0, 1], but is "
+      + std::to_string(inverseTemperature) + ".");
+  }
+  // The pending Gaussian factors were added at the previous temperature.
+  this->flushFactorBlock();
+  inverseTemperature_ = inverseTemperature;
+}
+
+void BpsBuilder::addBoundary(
+    const std::vector<int>& variableIds, const BoxBoundary& boundary) {
+
+  this->flushFactorBlock();
+  if (variableIds.size() != boundary.getDimension()) {
+    throw std::invalid_argument(
+      "Box boundary of dimension " + std::to_string(boundary.getDimension())
+      + " was added on " + std::to_string(variableIds.size())
+      + " variables.");
+  }
+  for (int i = 0; i < variableIds.size(); i++) {
+    this->addBoundaryFactor(
+      std::vector<int>{variableIds[i]}, boundary.getCoordinateBoundary(i));
+  }
+}
+
+void BpsBuilder::addBoundary(
+    const std::vector<int>& variableIds, const HalfSpaceBoundary& boundary) {
+
+  this->flushFactorBlock();
+  if (variableIds.size() != boundary.getDimension()) {
+    throw std::invalid_argument(
+      "Half-space boundary of dimension "
+      + std::to_string(boundary.getDimension()) + " was added on "
+      + std::to_string(variableIds.size()) + " variables.");
+  }
+  this->addBoundaryFactor(variableIds, boundary);
+}
+
+template<class Boundary>
+void BpsBuilder::addBoundaryFactor(
+    const std::vector<int>& variableIds, const Boundary& boundary) {
+
+  const std::vector<int> variablesNeededByBoundary =
+    getPositionAndVelocityVariables(variableIds, this->numberOfModelVariables_);
+  const std::vector<int> variablesToBeChangedByReflection =
+    getVelocityVariables(variableIds, this->numberOfModelVariables_);
+
+  PdmpBuilderBase<bps::State, bps::Flow>::addFactorAndMarkovKernelNodes(
+    variablesNeededByBoundary,
+    variablesNeededByBoundary,
+    variablesToBeChangedByReflection,
+    [boundary] () {
+      auto poissonProcessStrategy =
+        boundary.template getPoissonProcessStrategy<bps::Flow>();
+      return std::make_tuple(
+        poissonProcessStrategy, boundary.getReflectionKernel());
+    });
+}
+
+void BpsBuilder::addRefreshmentFactor(
+    const std::vector<int>& variableIds,
+    const RefreshmentOptions& refreshment) {
+
+  // No refreshment factor, and hence no event queue entry, is needed.
+  if (refreshment.rate == 0.0) {
+    return;
+  }
+  // Refreshing a uniformly chosen variable at rate r is the superposition of
+  // refreshing each of the n variables independently at rate r / n.
+  if (refreshment.randomSubset && variableIds.size() > 1) {
+    for (int variableId : variableIds) {
+      this->addRefreshmentFactor(
+        std::vector<int>{variableId},
+        RefreshmentOptions(refreshment.rate / variableIds.size(),
+                           refreshment.autocorrelation));
+    }
+    return;
+  }
+
   // This could be further refactored into refreshment policy to allow
   // for more flexibility.
   const std::vector<int> variablesNeededByRefreshmentNode;
   const std::vector<int> variablesToBeChangedByRefreshmentKernel =
-    variablesToBeChangedByReflectionKernel;
+    getVelocityVariables(variableIds, this->numberOfModelVariables_);
 
-  auto refreshmentStrategy = getRefreshmentStrategy(refreshRate);
-  auto refreshmentKernel = getRefreshmentKernel();
+  std::shared_ptr<const RefreshRateController> controller =
+    refreshRateController_;
+  const int refreshmentFactorId =
+    refreshRateController_->registerFactor(refreshment.rate);
+  refreshmentFactorIds_.push_back(numberOfFactorsAdded_);
+  const double autocorrelation = refreshment.autocorrelation;
 
-  PdmpBuilderBase<bps::State, bps::Flow>::addFactorNode(
-    variablesNeededByRefreshmentNode, refreshmentStrategy);
-  PdmpBuilderBase<bps::State, bps::Flow>::addMarkovKernelNode(
+  PdmpBuilderBase<bps::State, bps::Flow>::addFactorAndMarkovKernelNodes(
+    variablesNeededByRefreshmentNode,
     variablesToBeChangedByRefreshmentKernel,
     variablesToBeChangedByRefreshmentKernel,
-    refreshmentKernel);
+    [controller, refreshmentFactorId, autocorrelation] () {
+      auto refreshmentStrategy =
+        getRefreshmentStrategy(controller, refreshmentFactorId);
+      return std::make_tuple(
+        refreshmentStrategy, getRefreshmentKernel(autocorrelation));
+    });
+}
+
+void BpsBuilder::addRefreshmentFactors(
+    const std::vector<std::vector<int>>& variableIds,
+    const RefreshmentOptions& refreshment,
+    int numberOfThreads) {
+
+  if (refreshment.rate == 0.0) {
+    return;
+  }
+  // As in addRefreshmentFactor, a random subset refreshment becomes a
+  // refreshment of each variable at the rate divided by the factor size.
+  using FactorSpec = PdmpBuilderBase<bps::State, bps::Flow>::FactorSpec;
+  std::vector<FactorSpec> factorSpecs;
+  std::vector<int> controllerIds;
+  auto addSpec = [&] (const std::vector<int>& ids, double rate) {
+    const std::vector<int> variablesToBeChangedByRefreshmentKernel =
+      getVelocityVariables(ids, this->numberOfModelVariables_);
+    factorSpecs.push_back(FactorSpec{
+      std::vector<int>{},
+      variablesToBeChangedByRefreshmentKernel,
+      variablesToBeChangedByRefreshmentKernel});
+    controllerIds.push_back(refreshRateController_->registerFactor(rate));
+    refreshmentFactorIds_.push_back(
+      numberOfFactorsAdded_ + factorSpecs.size() - 1);
+  };
+  for (const auto& ids : variableIds) {
+    if (refreshment.randomSubset && ids.size() > 1) {
+      for (int variableId : ids) {
+        addSpec(std::vector<int>{variableId}, refreshment.rate / ids.size());
+      }
+    } else {
+      addSpec(ids, refreshment.rate);
+    }
+  }
+
+  std::shared_ptr<const RefreshRateController> controller =
+    refreshRateController_;
+  auto sharedControllerIds =
+    std::make_shared<const std::vector<int>>(std::move(controllerIds));
+  const double autocorrelation = refreshment.autocorrelation;
+  PdmpBuilderBase<bps::State, bps::Flow>::addFactorAndMarkovKernelNodes(
+    factorSpecs,
+    [controller, sharedControllerIds, autocorrelation]
+    (int factorIndex) {
+      auto refreshmentStrategy = getRefreshmentStrategy(
+        controller, (*sharedControllerIds)[factorIndex]);
+      return std::make_tuple(
+        refreshmentStrategy, getRefreshmentKernel(autocorrelation));
+    },
+    numberOfThreads);
+}
+
+void BpsBuilder::setFactorsPerBlock(int factorsPerBlock) {
+  if (factorsPerBlock < 1) {
+    throw std::invalid_argument(
+      "The number of factors per block should be positive, but is "
+      + std::to_string(factorsPerBlock) + ".");
+  }
+  this->flushFactorBlock();
+  factorsPerBlock_ = factorsPerBlock;
+}
+
+void BpsBuilder::flushFactorBlock() {
+  if (pendingDistributions_.empty()) {
+    return;
+  }
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+  // The union of the variables, in the order of their first appearance.
+  std::vector<int> blockVariableIds;
+  for (const auto& variableIds : pendingVariableIds_) {
+    for (int variableId : variableIds) {
+      if (std::find(blockVariableIds.begin(), blockVariableIds.end(),
+                    variableId) == blockVariableIds.end()) {
+        blockVariableIds.push_back(variableId);
+      }
+    }
+  }
+
+  // The product of the factors has the summed precision P and the mean
+  // P^-1 sum_k P_k mean_k, with each factor embedded into the block.
+  const int blockSize = blockVariableIds.size();
+  RealMatrix precisionMatrix = RealMatrix::Zero(blockSize, blockSize);
+  RealVector precisionTimesMean = RealVector::Zero(blockSize);
+  for (int k = 0; k < pendingDistributions_.size(); k++) {
+    const auto& variableIds = pendingVariableIds_[k];
+    std::vector<int> blockIndices;
+    for (int variableId : variableIds) {
+      blockIndices.push_back(
+        std::find(blockVariableIds.begin(), blockVariableIds.end(), variableId)
+        - blockVariableIds.begin());
+    }
+    const RealMatrix& factorPrecision =
+      pendingDistributions_[k].getPrecisionMatrix();
+    const RealVector factorPrecisionTimesMean =
+      factorPrecision * pendingDistributions_[k].getMean();
+    for (int i = 0; i < blockIndices.size(); i++) {
+      precisionTimesMean(blockIndices[i]) += factorPrecisionTimesMean(i);
+      for (int j = 0; j < blockIndices.size(); j++) {
+        precisionMatrix(blockIndices[i], blockIndices[j]) +=
+          factorPrecision(i, j);
+      }
+    }
+  }
+
+  Eigen::LLT<RealMatrix> cholesky(precisionMatrix);
+  if (pendingDistributions_.size() == 1 || cholesky.info() != Eigen::Success) {
+    // Nothing to fuse, or the product is not a proper Gaussian.
+    for (int k = 0; k < pendingDistributions_.size(); k++) {
+      this->addGaussianFactor(
+        pendingVariableIds_[k], pendingDistributions_[k],
+        pendingRefreshments_[k]);
+    }
+  } else {
+    for (int k = 0; k < pendingDistributions_.size(); k++) {
+      gaussianFactors_.push_back(
+        GaussianFactor{nullptr, numberOfFactorsAdded_});
+    }
+    this->addDistributionFactor(
+      blockVariableIds,
+      GaussianDistribution::getFromPrecision(
+        cholesky.solve(precisionTimesMean), precisionMatrix),
+      RefreshmentOptions(0.0));
+    // The fused factors keep their refreshment factors, so that the fusion
+    // does not change how the velocities are refreshed.
+    for (int k = 0; k < pendingDistributions_.size(); k++) {
+      this->addRefreshmentFactor(
+        pendingVariableIds_[k], pendingRefreshments_[k]);
+    }
+  }
+
+  pendingVariableIds_.clear();
+  pendingDistributions_.clear();
+  pendingRefreshments_.clear();
 }
 
 auto BpsBuilder::build() {
+  this->flushFactorBlock();
+  areFactorsShared_ = areFactorsShared_ || isBuilt_;
+  isBuilt_ = true;
   return PdmpBuilderBase<bps::State, bps::Flow>::build();
 }
 
+std::shared_ptr<const BpsBuilder::Model> BpsBuilder::buildModel() {
+  this->flushFactorBlock();
+  areFactorsShared_ = true;
+  return PdmpBuilderBase<bps::State, bps::Flow>::buildModel();
+}
+
+auto BpsBuilder::buildPartitioned(int numberOfPartitions) {
+  this->flushFactorBlock();
+  areFactorsShared_ = true;
+  return PdmpBuilderBase<bps::State, bps::Flow>::buildPartitioned(
+    numberOfPartitions);
+}
+
+std::shared_ptr<RefreshRateController>
+BpsBuilder::getRefreshRateController() const {
+  return refreshRateController_;
+}
+
+template<class Pdmp>
+void BpsBuilder::setGaussianParameters(
+    Pdmp& pdmp, int gaussianFactorIndex,
+    const GaussianDistribution& distribution) {
+
+  if (areFactorsShared_) {
+    throw std::logic_error(
+      "The factors are shared by several PDMPs or chains, so the "
+      "distribution of a Gaussian factor can not be replaced in one of them.");
+  }
+  // The pending factors are not built yet.
+  this->flushFactorBlock();
+  if (gaussianFactorIndex < 0
+      || gaussianFactorIndex >= gaussianFactors_.size()) {
+    throw std::out_of_range(
+      "Gaussian factor index " + std::to_string(gaussianFactorIndex)
+      + " is out of range.");
+  }
+  const GaussianFactor& gaussianFactor = gaussianFactors_[gaussianFactorIndex];
+  if (!gaussianFactor.distribution) {
+    throw std::logic_error(
+      "Gaussian factor " + std::to_string(gaussianFactorIndex) + " was fused "
+      "into a block, so its distribution can not be replaced.");
+  }
+  const int dimension = gaussianFactor.distribution->getMean().size();
+  if (distribution.getMean().size() != dimension
+      || distribution.getPrecisionMatrix().rows() != dimension
+      || distribution.getPrecisionMatrix().cols() != dimension) {
+    throw std::invalid_argument(
+      "Gaussian factor " + std::to_string(gaussianFactorIndex) + " has "
+      "dimension " + std::to_string(dimension) + ", but the new distribution "
+      "has dimension " + std::to_string(distribution.getMean().size()) + ".");
+  }
+  *gaussianFactor.distribution = distribution;
+  pdmp.invalidateFactors({gaussianFactor.factorId});
+}
+
+template<class Pdmp>
+std::shared_ptr<PdmpRefreshRateController<Pdmp>>
+BpsBuilder::getRefreshRateController(Pdmp& pdmp) const {
+  if (areFactorsShared_) {
+    throw std::logic_error(
+      "The factors are shared by several PDMPs or chains, so the refresh "
+      "rates can not be changed in one of them.");
+  }
+  return std::make_shared<PdmpRefreshRateController<Pdmp>>(
+    refreshRateController_, pdmp, refreshmentFactorIds_);
+}
+
+template<class Pdmp>
+void BpsBuilder::setRefreshRateScale(Pdmp& pdmp, double scale) {
+  this->getRefreshRateController(pdmp)->setScale(scale);
+}
+
 }
 }
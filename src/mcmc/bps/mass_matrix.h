@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * Supported structures of the mass matrix.
+ */
+enum class MassMatrixType {
+  Diagonal,
+  Dense
+};
+
+/**
+ * The mass matrix M of a preconditioned BPS, shared between its refreshment
+ * and reflection kernels. Velocities are distributed as N(0, M^-1) and are
+ * reflected in the M-inner product, which preserves this distribution.
+ *
+ * A diagonal mass matrix keeps all kernels local to their factors. A dense
+ * mass matrix couples all velocities, so its kernels act on all of them.
+ */
+class MassMatrix {
+
+ public:
+
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+  /**
+   * Creates an identity mass matrix of the given dimension and type.
+   */
+  MassMatrix(int dimension, MassMatrixType type = MassMatrixType::Diagonal);
+
+  MassMatrixType getType() const;
+
+  int getDimension() const;
+
+  /**
+   * Returns the inverse mass matrix M^-1, i.e. the velocity covariance.
+   */
+  const RealMatrix& getInverse() const;
+
+  /**
+   * Sets the inverse mass matrix M^-1, usually an estimate of the target
+   * covariance. The off-diagonal entries are ignored by a diagonal mass
+   * matrix. Throws std::invalid_argument if the matrix has a wrong size or
+   * is not positive definite.
+   */
+  void setInverse(const RealMatrix& inverseMassMatrix);
+
+  /**
+   * Draws the velocities of the given model variables from N(0, M^-1).
+   * A dense mass matrix can only refresh all the velocities at once.
+   */
+  template<class Rng>
+  RealVector sampleVelocity(const std::vector<int>& variableIds, Rng& rng)
+    const;
+
+  /**
+   * Reflects the velocity off the energy gradient of the given model
+   * variables in the M-inner product:
+   *   v' = v - 2 <g, v> / (g^T M^-1 g) M^-1 g.
+   * The velocity holds the given variables for a diagonal mass matrix, and
+   * all the variables for a dense one.
+   */
+  RealVector reflectVelocity(
+    const std::vector<int>& variableIds,
+    const RealVector& velocity,
+    const RealVector& energyGradient) const;
+
+ private:
+
+  MassMatrixType type_;
+  RealMatrix inverse_;
+  // The lower Cholesky factor of M^-1, used for sampling velocities.
+  RealMatrix inverseCholeskyFactor_;
+
+};
+
+}
+}
+
+#include "mass_matrix.tcc"
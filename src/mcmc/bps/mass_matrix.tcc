@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include <Eigen/Cholesky>
+#include <stan/math/prim/scal.hpp>
+
+namespace pdmp {
+namespace mcmc {
+
+MassMatrix::MassMatrix(int dimension, MassMatrixType type)
+  : type_(type),
+    inverse_(RealMatrix::Identity(dimension, dimension)),
+    inverseCholeskyFactor_(RealMatrix::Identity(dimension, dimension)) {
+}
+
+MassMatrixType MassMatrix::getType() const {
+  return type_;
+}
+
+int MassMatrix::getDimension() const {
+  return inverse_.rows();
+}
+
+const MassMatrix::RealMatrix& MassMatrix::getInverse() const {
+  return inverse_;
+}
+
+void MassMatrix::setInverse(const RealMatrix& inverseMassMatrix) {
+  if (inverseMassMatrix.rows() != getDimension()
+      || inverseMassMatrix.cols() != getDimension()) {
+    throw std::invalid_argument(
+      "Inverse mass matrix should be of size " + std::to_string(getDimension())
+      + "x" + std::to_string(getDimension()) + ".");
+  }
+  RealMatrix inverse = type_ == MassMatrixType::Diagonal
+    ? RealMatrix(inverseMassMatrix.diagonal().asDiagonal())
+    : inverseMassMatrix;
+  Eigen::LLT<RealMatrix> cholesky(inverse);
+  if (cholesky.info() != Eigen::Success) {
+    throw std::invalid_argument(
+      "Inverse mass matrix should be positive definite.");
+  }
+  inverse_ = inverse;
+  inverseCholeskyFactor_ = cholesky.matrixL();
+}
+
+template<class Rng>
+MassMatrix::RealVector MassMatrix::sampleVelocity(
+  const std::vector<int>& variableIds, Rng& rng) const {
+
+  RealVector standardNormal(variableIds.size());
+  for (int i = 0; i < standardNormal.size(); i++) {
+    standardNormal(i) = stan::math::normal_rng(0.0, 1.0, rng);
+  }
+  if (type_ == MassMatrixType::Dense) {
+    if (variableIds.size() != getDimension()) {
+      throw std::logic_error(
+        "A dense mass matrix can only refresh all the velocities at once.");
+    }
+    RealVector velocity = inverseCholeskyFactor_ * standardNormal;
+    return velocity;
+  }
+  RealVector velocity(variableIds.size());
+  for (int i = 0; i < velocity.size(); i++) {
+    velocity(i) =
+      sqrt(inverse_(variableIds[i], variableIds[i])) * standardNormal(i);
+  }
+  return velocity;
+}
+
+MassMatrix::RealVector MassMatrix::reflectVelocity(
+  const std::vector<int>& variableIds,
+  const RealVector& velocity,
+  const RealVector& energyGradient) const {
+
+  // The direction of reflection M^-1 g, where g is zero outside the given
+  // variables, and the inner products <g, v> and g^T M^-1 g.
+  RealVector direction;
+  double velocityInnerProduct = 0.0;
+  double gradientSquaredNorm = 0.0;
+  if (type_ == MassMatrixType::Dense) {
+    direction = RealVector::Zero(getDimension());
+    for (int i = 0; i < variableIds.size(); i++) {
+      direction += inverse_.col(variableIds[i]) * energyGradient(i);
+      velocityInnerProduct += energyGradient(i) * velocity(variableIds[i]);
+    }
+    for (int i = 0; i < variableIds.size(); i++) {
+      gradientSquaredNorm += energyGradient(i) * direction(variableIds[i]);
+    }
+  } else {
+    direction = RealVector(variableIds.size());
+    for (int i = 0; i < variableIds.size(); i++) {
+      direction(i) =
+        inverse_(variableIds[i], variableIds[i]) * energyGradient(i);
+    }
+    velocityInnerProduct = energyGradient.dot(velocity);
+    gradientSquaredNorm = energyGradient.dot(direction);
+  }
+  RealVector reflectedVelocity =
+    velocity - 2.0 * velocityInnerProduct / gradientSquaredNorm * direction;
+  return reflectedVelocity;
+}
+
+}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/policies/preconditioned_linear_flow.h"
+#include "core/state_space/position_and_velocity_state.h"
+#include "mcmc/pdmp_builder_base.h"
+#include "mcmc/bps/bps_builder.h"
+#include "mcmc/bps/mass_matrix.h"
+#include "mcmc/distributions/distribution_base.h"
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * A class for building PDMPs that simulate based on the preconditioned
+ * Bouncy Particle Sampler, whose velocities are distributed as N(0, M^-1)
+ * for a mass matrix M.
+ *
+ * The mass matrix is shared by all the kernels of the built PDMP, so it can
+ * be adapted after building, e.g. by running a MassMatrixAdapter observer
+ * during burn-in. Adaptation should be stopped before collecting samples.
+ */
+class PreconditionedBpsBuilder
+  : protected PdmpBuilderBase<bps::State, PreconditionedLinearFlow> {
+
+ public:
+
+  /**
+   * Takes the number of probability model variables and the structure of
+   * the mass matrix, which is initialised to the identity.
+   */
+  PreconditionedBpsBuilder(
+    int numberOfModelVariables,
+    MassMatrixType massMatrixType = MassMatrixType::Diagonal);
+
+  /**
+   * Adds a factor, with the given distribution, acting on the specified
+   * model variables.
+   *
+   * @param Ids
+   *   The variable ids (indexed from 0), on which this factor depends.
+   * @param distribution
+   */
+  template<class Distribution>
+  void addFactor(
+    const std::vector<int>& variableIds,
+    const DistributionBase<Distribution>& distribution,
+    double refreshRate = 1.0);
+
+  /**
+   * Returns the mass matrix shared by the kernels of the built PDMP.
+   */
+  std::shared_ptr<MassMatrix> getMassMatrix() const;
+
+  /**
+   * Returns the PDMP that can be used to simulated from the constructed
+   * probability model.
+   */
+  auto build();
+
+ private:
+
+  // Adds the refreshment factor and its Markov kernel, which resamples the
+  // velocities of the given model variables (of all model variables for a
+  // dense mass matrix).
+  void addRefreshmentFactor(
+    const std::vector<int>& variableIds, double refreshRate);
+
+  // Returns the model variables whose velocities are modified by the
+  // kernels of a factor on the given variables.
+  std::vector<int> getCoupledVariables(const std::vector<int>& variableIds)
+    const;
+
+  int numberOfModelVariables_;
+  std::shared_ptr<MassMatrix> massMatrix_;
+
+};
+
+}
+}
+
+#include "preconditioned_bps_builder.tcc"
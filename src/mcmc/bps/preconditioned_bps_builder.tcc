@@ -0,0 +1,141 @@
+#pragma once
+
+#include <memory>
+#include <numeric>
+
+#include <Eigen/Core>
+
+#include "core/policies/linear_flow.h"
+#include "mcmc/utils.h"
+
+#include <stan/math/prim/scal.hpp>
+
+namespace pdmp {
+namespace mcmc {
+
+namespace {
+
+auto getPreconditionedRefreshmentKernel(
+  std::shared_ptr<const MassMatrix> massMatrix,
+  const std::vector<int>& variableIds) {
+
+  auto rng = getRng();
+  auto refreshmentKernel =
+    [rng, massMatrix, variableIds] (const auto&) mutable {
+      return massMatrix->sampleVelocity(variableIds, rng);
+    };
+  return refreshmentKernel;
+}
+
+// Reflects the velocities of the coupled variables in the M-inner product.
+template<class F>
+auto getPreconditionedReflectionKernel(
+  std::shared_ptr<const MassMatrix> massMatrix,
+  const std::vector<int>& variableIds,
+  int numberOfCoupledVariables,
+  const F& logProbGradient) {
+
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  auto kernel =
+    [massMatrix, variableIds, numberOfCoupledVariables, logProbGradient]
+    (const auto& stateVector) {
+      RealVector position = stateVector.head(variableIds.size());
+      RealVector velocity = stateVector.tail(numberOfCoupledVariables);
+      RealVector energyGradient = -1.0 * logProbGradient(position);
+
+      RealVector newVector(stateVector.size());
+      newVector << position, massMatrix->reflectVelocity(
+        variableIds, velocity, energyGradient);
+      return newVector;
+    };
+  return kernel;
+}
+
+}
+
+PreconditionedBpsBuilder::PreconditionedBpsBuilder(
+  int numberOfModelVariables, MassMatrixType massMatrixType)
+  : PdmpBuilderBase<bps::State, PreconditionedLinearFlow>(
+      numberOfModelVariables * 2),
+    numberOfModelVariables_(numberOfModelVariables),
+    massMatrix_(
+      std::make_shared<MassMatrix>(numberOfModelVariables, massMatrixType)) {
+}
+
+template<class Distribution>
+void PreconditionedBpsBuilder::addFactor(
+    const std::vector<int>& variableIds,
+    const DistributionBase<Distribution>& distribution,
+    double refreshRate) {
+
+  const std::vector<int> coupledVariables = getCoupledVariables(variableIds);
+  const std::vector<int> variablesNeededByFactorNode =
+    getPositionAndVelocityVariables(variableIds, this->numberOfModelVariables_);
+  // The reflection needs the positions of the factor variables and the
+  // velocities of all coupled variables.
+  std::vector<int> variablesNeededByReflectionKernel = variableIds;
+  const std::vector<int> variablesToBeChangedByReflectionKernel =
+    getVelocityVariables(coupledVariables, this->numberOfModelVariables_);
+  variablesNeededByReflectionKernel.insert(
+    variablesNeededByReflectionKernel.end(),
+    variablesToBeChangedByReflectionKernel.begin(),
+    variablesToBeChangedByReflectionKernel.end());
+
+  auto reflectionKernel = getPreconditionedReflectionKernel(
+    massMatrix_, variableIds, coupledVariables.size(),
+    distribution.getLogPdfGradient());
+  // The flow moves the position as the linear flow, so the intensities are
+  // the same.
+  auto poissonProcessStrategy = distribution.template getPoissonProcessStrategy<
+    LinearFlow>();
+
+  PdmpBuilderBase<bps::State, PreconditionedLinearFlow>::addFactorNode(
+    variablesNeededByFactorNode, poissonProcessStrategy);
+  PdmpBuilderBase<bps::State, PreconditionedLinearFlow>::addMarkovKernelNode(
+    variablesNeededByReflectionKernel,
+    variablesToBeChangedByReflectionKernel,
+    reflectionKernel);
+
+  this->addRefreshmentFactor(coupledVariables, refreshRate);
+}
+
+std::shared_ptr<MassMatrix> PreconditionedBpsBuilder::getMassMatrix() const {
+  return massMatrix_;
+}
+
+void PreconditionedBpsBuilder::addRefreshmentFactor(
+    const std::vector<int>& variableIds, double refreshRate) {
+
+  const std::vector<int> variablesNeededByRefreshmentNode;
+  const std::vector<int> variablesToBeChangedByRefreshmentKernel =
+    getVelocityVariables(variableIds, this->numberOfModelVariables_);
+
+  auto refreshmentStrategy = getRefreshmentStrategy(refreshRate);
+  auto refreshmentKernel =
+    getPreconditionedRefreshmentKernel(massMatrix_, variableIds);
+
+  PdmpBuilderBase<bps::State, PreconditionedLinearFlow>::addFactorNode(
+    variablesNeededByRefreshmentNode, refreshmentStrategy);
+  PdmpBuilderBase<bps::State, PreconditionedLinearFlow>::addMarkovKernelNode(
+    variablesToBeChangedByRefreshmentKernel,
+    variablesToBeChangedByRefreshmentKernel,
+    refreshmentKernel);
+}
+
+std::vector<int> PreconditionedBpsBuilder::getCoupledVariables(
+  const std::vector<int>& variableIds) const {
+
+  if (massMatrix_->getType() == MassMatrixType::Diagonal) {
+    return variableIds;
+  }
+  std::vector<int> allVariables(this->numberOfModelVariables_);
+  std::iota(allVariables.begin(), allVariables.end(), 0);
+  return allVariables;
+}
+
+auto PreconditionedBpsBuilder::build() {
+  return PdmpBuilderBase<bps::State, PreconditionedLinearFlow>::build();
+}
+
+}
+}
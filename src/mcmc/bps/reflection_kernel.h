@@ -11,6 +11,17 @@ namespace mcmc {
 template <class F>
 auto getReflectionKernel(const F& logProbGradient);
 
+/**
+ * Returns the forward event-chain bounce kernel associated with the gradient
+ * of some log probability density function. The velocity component along
+ * the gradient is reflected, as in the BPS, while the orthogonal component
+ * is resampled from its N(0, I) marginal. This randomises the velocity at
+ * every bounce, so little or no refreshment is needed. For factors on a
+ * single variable it coincides with the reflection kernel.
+ */
+template <class F>
+auto getForwardEventChainKernel(const F& logProbGradient);
+
 }
 }
 
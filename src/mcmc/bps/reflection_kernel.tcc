@@ -3,6 +3,9 @@
 #include <stdexcept>
 
 #include <Eigen/Core>
+#include <stan/math/prim/scal.hpp>
+
+#include "mcmc/utils.h"
 
 namespace pdmp {
 namespace mcmc {
@@ -29,5 +32,36 @@ auto getReflectionKernel(const F& logProbGradient) {
   return kernel;
 }
 
+template <class F>
+auto getForwardEventChainKernel(const F& logProbGradient) {
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  auto rng = getRng();
+  auto kernel = [logProbGradient, rng] (auto&& stateVector) mutable {
+    if (stateVector.size() % 2 != 0) {
+      throw std::runtime_error(
+        "The forward event-chain kernel was invoked on a vector of odd size.");
+    }
+    RealVector position = stateVector.head(stateVector.size() / 2);
+    RealVector velocity = stateVector.tail(stateVector.size() / 2);
+    RealVector direction = -1.0 * logProbGradient(position);
+    direction.normalize();
+
+    // Reflect the parallel component and draw the orthogonal component
+    // by projecting a standard normal vector.
+    RealVector noise(velocity.size());
+    for (int i = 0; i < noise.size(); i++) {
+      noise(i) = stan::math::normal_rng(0.0, 1.0, rng);
+    }
+    RealVector newVelocity =
+      -direction.dot(velocity) * direction
+      + (noise - direction.dot(noise) * direction);
+
+    RealVector newVector(stateVector.size());
+    newVector << position, newVelocity;
+    return newVector;
+  };
+  return kernel;
+}
+
 }
 }
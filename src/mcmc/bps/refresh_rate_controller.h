@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * The refresh rates of a BPS, shared between its refreshment factors.
+ * Each factor registers its base rate, and refreshes at that rate times a
+ * common scale, so that the scale can be tuned after building (e.g. by a
+ * RefreshRateAdapter observer) while keeping the ratios of the factor rates.
+ *
+ * Once the controller is frozen, the scale can no longer be changed, so the
+ * rates stay fixed for the production run.
+ */
+class RefreshRateController {
+
+ public:
+
+  /**
+   * Registers a refreshment factor with the given base rate and returns its
+   * id, which should be used to query its rate.
+   */
+  int registerFactor(double baseRate);
+
+  /**
+   * Returns the current refresh rate of the factor with the given id.
+   */
+  double getRate(int factorId) const;
+
+  /**
+   * Returns the number of registered refreshment factors.
+   */
+  int getNumberOfFactors() const;
+
+  double getScale() const;
+
+  /**
+   * Sets the common scale of all the refresh rates. Throws
+   * std::invalid_argument for non-positive scales and std::logic_error if
+   * the controller is frozen.
+   */
+  void setScale(double scale);
+
+  /**
+   * Fixes the current rates, so that the process is time-homogeneous again.
+   */
+  void freeze();
+
+  bool isFrozen() const;
+
+ private:
+
+  std::vector<double> baseRates_;
+  // Read by the refreshment strategies while an adapter may be updating it.
+  std::atomic<double> scale_{1.0};
+  std::atomic<bool> isFrozen_{false};
+
+};
+
+/**
+ * The refresh rates of one built PDMP. Changing the scale also expires the
+ * pending events of the PDMP's refreshment factors, which were simulated at
+ * the previous rates, so that the next refreshments already follow the new
+ * ones (e.g. in each window of a RefreshRateAdapter, and after it sets the
+ * tuned scale). The scale should only be changed between the iterations of
+ * the PDMP, e.g. from its observers.
+ */
+template<class Pdmp>
+class PdmpRefreshRateController {
+
+ public:
+
+  /**
+   * Takes the shared controller of the rates, the PDMP and the factor ids of
+   * its refreshment factors.
+   */
+  PdmpRefreshRateController(
+    std::shared_ptr<RefreshRateController> controller,
+    Pdmp& pdmp,
+    std::vector<int> refreshmentFactorIds);
+
+  double getRate(int factorId) const;
+
+  double getScale() const;
+
+  void setScale(double scale);
+
+  void freeze();
+
+  bool isFrozen() const;
+
+ private:
+
+  std::shared_ptr<RefreshRateController> controller_;
+  Pdmp* pdmp_;
+  std::vector<int> refreshmentFactorIds_;
+
+};
+
+}
+}
+
+#include "refresh_rate_controller.tcc"
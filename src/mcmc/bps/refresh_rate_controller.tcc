@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace pdmp {
+namespace mcmc {
+
+int RefreshRateController::registerFactor(double baseRate) {
+  if (baseRate < 0.0) {
+    throw std::invalid_argument(
+      "Base refresh rate should be non-negative, but is "
+      + std::to_string(baseRate) + ".");
+  }
+  baseRates_.push_back(baseRate);
+  return baseRates_.size() - 1;
+}
+
+double RefreshRateController::getRate(int factorId) const {
+  return baseRates_.at(factorId) * scale_.load(std::memory_order_relaxed);
+}
+
+int RefreshRateController::getNumberOfFactors() const {
+  return baseRates_.size();
+}
+
+double RefreshRateController::getScale() const {
+  return scale_.load();
+}
+
+void RefreshRateController::setScale(double scale) {
+  if (isFrozen_) {
+    throw std::logic_error(
+      "Cannot change the refresh rates after the controller was frozen.");
+  }
+  if (!(scale > 0.0)) {
+    throw std::invalid_argument(
+      "Refresh rate scale should be positive, but is " + std::to_string(scale)
+      + ".");
+  }
+  scale_ = scale;
+}
+
+void RefreshRateController::freeze() {
+  isFrozen_ = true;
+}
+
+bool RefreshRateController::isFrozen() const {
+  return isFrozen_;
+}
+
+template<class Pdmp>
+PdmpRefreshRateController<Pdmp>::PdmpRefreshRateController(
+  std::shared_ptr<RefreshRateController> controller,
+  Pdmp& pdmp,
+  std::vector<int> refreshmentFactorIds)
+  : controller_(controller),
+    pdmp_(&pdmp),
+    refreshmentFactorIds_(std::move(refreshmentFactorIds)) {
+}
+
+template<class Pdmp>
+double PdmpRefreshRateController<Pdmp>::getRate(int factorId) const {
+  return controller_->getRate(factorId);
+}
+
+template<class Pdmp>
+double PdmpRefreshRateController<Pdmp>::getScale() const {
+  return controller_->getScale();
+}
+
+template<class Pdmp>
+void PdmpRefreshRateController<Pdmp>::setScale(double scale) {
+  controller_->setScale(scale);
+  pdmp_->invalidateFactors(refreshmentFactorIds_);
+}
+
+template<class Pdmp>
+void PdmpRefreshRateController<Pdmp>::freeze() {
+  controller_->freeze();
+}
+
+template<class Pdmp>
+bool PdmpRefreshRateController<Pdmp>::isFrozen() const {
+  return controller_->isFrozen();
+}
+
+}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <Eigen/Core>
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * Supported element types of the columnar dataset files.
+ */
+enum class DatasetType : std::uint64_t {
+  Float64 = 0,
+  Float32 = 1
+};
+
+/**
+ * A read-only dataset, memory-mapped from a simple binary columnar file.
+ *
+ * The file layout is:
+ *   uint64 row count,
+ *   uint64 column count,
+ *   uint64 element type (see DatasetType),
+ *   the column-major payload of rows * columns elements.
+ *
+ * The views returned by this class point directly into the mapped file,
+ * so no data is copied. Since the file is mapped as shared, all factors and
+ * chains (even in different processes) reading the same file share the
+ * same page cache. To share a dataset between factors, hold it through a
+ * std::shared_ptr and keep it alive for as long as any view is used.
+ *
+ * Data-sum factors expect one datum per column, so observations should be
+ * stored as columns for the best memory locality.
+ */
+class MemoryMappedDataset {
+
+ public:
+
+  template<class Scalar>
+  using MatrixView = Eigen::Map<
+    const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>>;
+
+  template<class Scalar>
+  using ColumnView = Eigen::Map<const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>>;
+
+  /**
+   * Maps the file at the given path into memory.
+   * Throws std::runtime_error if the file cannot be mapped or its
+   * header is inconsistent with its size.
+   */
+  MemoryMappedDataset(const std::string& path);
+
+  ~MemoryMappedDataset();
+
+  MemoryMappedDataset(const MemoryMappedDataset&) = delete;
+  MemoryMappedDataset& operator=(const MemoryMappedDataset&) = delete;
+
+  int rows() const;
+
+  int cols() const;
+
+  DatasetType getType() const;
+
+  /**
+   * Returns a zero-copy view of the whole data matrix.
+   * Scalar must match the element type stored in the file.
+   */
+  template<class Scalar = double>
+  MatrixView<Scalar> getMatrix() const;
+
+  /**
+   * Returns a zero-copy view of the given column.
+   * Scalar must match the element type stored in the file.
+   */
+  template<class Scalar = double>
+  ColumnView<Scalar> getColumn(int columnId) const;
+
+ private:
+
+  // Throws if Scalar does not match the stored element type.
+  template<class Scalar>
+  const Scalar* getPayload() const;
+
+  void* mapping_{nullptr};
+  std::size_t mappingSize_{0};
+  std::uint64_t rows_{0};
+  std::uint64_t cols_{0};
+  DatasetType type_{DatasetType::Float64};
+};
+
+/**
+ * Writes the given matrix into a file readable by MemoryMappedDataset.
+ */
+template<class Derived>
+void writeColumnarDataset(
+  const std::string& path, const Eigen::MatrixBase<Derived>& matrix);
+
+}
+}
+
+#include "memory_mapped_dataset.tcc"
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const std::size_t kDatasetHeaderSize = 3 * sizeof(std::uint64_t);
+
+template<class Scalar>
+struct DatasetTypeOf;
+
+template<>
+struct DatasetTypeOf<double> {
+  static constexpr pdmp::mcmc::DatasetType value =
+    pdmp::mcmc::DatasetType::Float64;
+};
+
+template<>
+struct DatasetTypeOf<float> {
+  static constexpr pdmp::mcmc::DatasetType value =
+    pdmp::mcmc::DatasetType::Float32;
+};
+
+std::size_t getDatasetTypeSize(pdmp::mcmc::DatasetType type) {
+  switch (type) {
+    case pdmp::mcmc::DatasetType::Float64:
+      return sizeof(double);
+    case pdmp::mcmc::DatasetType::Float32:
+      return sizeof(float);
+  }
+  throw std::runtime_error("Unknown dataset element type.");
+}
+
+std::runtime_error getDatasetError(
+  const std::string& path, const std::string& message) {
+
+  return std::runtime_error(
+    "Could not load the dataset " + path + ": " + message);
+}
+
+}
+
+namespace pdmp {
+namespace mcmc {
+
+MemoryMappedDataset::MemoryMappedDataset(const std::string& path) {
+  int fileDescriptor = open(path.c_str(), O_RDONLY);
+  if (fileDescriptor < 0) {
+    throw getDatasetError(path, std::strerror(errno));
+  }
+
+  struct stat fileStatus;
+  if (fstat(fileDescriptor, &fileStatus) != 0) {
+    close(fileDescriptor);
+    throw getDatasetError(path, std::strerror(errno));
+  }
+  mappingSize_ = fileStatus.st_size;
+  if (mappingSize_ < kDatasetHeaderSize) {
+    close(fileDescriptor);
+    throw getDatasetError(path, "the file is too small to hold a header.");
+  }
+
+  mapping_ = mmap(
+    nullptr, mappingSize_, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+  // The mapping stays valid after closing the file descriptor.
+  close(fileDescriptor);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    throw getDatasetError(path, std::strerror(errno));
+  }
+
+  const std::uint64_t* header = static_cast<const std::uint64_t*>(mapping_);
+  rows_ = header[0];
+  cols_ = header[1];
+  type_ = static_cast<DatasetType>(header[2]);
+  if (type_ != DatasetType::Float64 && type_ != DatasetType::Float32) {
+    munmap(mapping_, mappingSize_);
+    throw getDatasetError(path, "unknown element type.");
+  }
+  if (rows_ > INT_MAX || cols_ > INT_MAX) {
+    munmap(mapping_, mappingSize_);
+    throw getDatasetError(
+      path, "the dimensions in its header exceed the int range.");
+  }
+  // The number of rows is bounded first, so that computing the payload size
+  // of a corrupt header can not overflow.
+  const std::size_t typeSize = getDatasetTypeSize(type_);
+  if (rows_ > (mappingSize_ - kDatasetHeaderSize) / typeSize
+                / std::max<std::uint64_t>(cols_, 1)
+      || kDatasetHeaderSize + rows_ * cols_ * typeSize != mappingSize_) {
+    munmap(mapping_, mappingSize_);
+    throw getDatasetError(
+      path, "the file size does not match the dimensions in its header.");
+  }
+}
+
+MemoryMappedDataset::~MemoryMappedDataset() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mappingSize_);
+  }
+}
+
+int MemoryMappedDataset::rows() const {
+  return rows_;
+}
+
+int MemoryMappedDataset::cols() const {
+  return cols_;
+}
+
+DatasetType MemoryMappedDataset::getType() const {
+  return type_;
+}
+
+template<class Scalar>
+MemoryMappedDataset::MatrixView<Scalar>
+MemoryMappedDataset::getMatrix() const {
+  return MatrixView<Scalar>(getPayload<Scalar>(), rows_, cols_);
+}
+
+template<class Scalar>
+MemoryMappedDataset::ColumnView<Scalar>
+MemoryMappedDataset::getColumn(int columnId) const {
+  if (columnId < 0 || columnId >= cols_) {
+    throw std::out_of_range("Column id " + std::to_string(columnId) + " is "
+                            "out of range. Should be 0 <= id < " +
+                            std::to_string(cols_) + ".");
+  }
+  return ColumnView<Scalar>(getPayload<Scalar>() + columnId * rows_, rows_);
+}
+
+template<class Scalar>
+const Scalar* MemoryMappedDataset::getPayload() const {
+  if (DatasetTypeOf<Scalar>::value != type_) {
+    throw std::logic_error(
+      "Requested a dataset view with an element type different from the one "
+      "stored in the file.");
+  }
+  return reinterpret_cast<const Scalar*>(
+    static_cast<const char*>(mapping_) + kDatasetHeaderSize);
+}
+
+template<class Derived>
+void writeColumnarDataset(
+  const std::string& path, const Eigen::MatrixBase<Derived>& matrix) {
+
+  using Scalar = typename Derived::Scalar;
+  const std::uint64_t header[3] = {
+    static_cast<std::uint64_t>(matrix.rows()),
+    static_cast<std::uint64_t>(matrix.cols()),
+    static_cast<std::uint64_t>(DatasetTypeOf<Scalar>::value)};
+
+  // Evaluate into a column-major matrix, so that the payload can be written
+  // in one go.
+  const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> payload = matrix;
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  file.write(
+    reinterpret_cast<const char*>(payload.data()),
+    payload.size() * sizeof(Scalar));
+  if (!file) {
+    throw std::runtime_error("Could not write the dataset " + path + ".");
+  }
+}
+
+}
+}
@@ -28,6 +28,12 @@ class DistributionBase {
    */
   auto getLogPdf() const;
 
+  /**
+   * Returns the gradient of the log probability density function of the
+   * represented distribution.
+   */
+  auto getLogPdfGradient() const;
+
   template<class Flow, class... Args>
   auto getPoissonProcessStrategy(Args&&... args) const;
 
@@ -8,6 +8,11 @@ auto DistributionBase<Derived>::getLogPdf() const {
   return static_cast<const Derived*>(this)->getLogPdf();
 }
 
+template<class Derived>
+auto DistributionBase<Derived>::getLogPdfGradient() const {
+  return static_cast<const Derived*>(this)->getLogPdfGradient();
+}
+
 
 template<class Derived>
 template<class Flow, class... Args>
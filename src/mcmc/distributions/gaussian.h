@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "mcmc/distributions/distribution_base.h"
 
 namespace pdmp {
@@ -16,13 +18,42 @@ class GaussianDistribution : public DistributionBase<GaussianDistribution> {
   GaussianDistribution(
     const RealVector& mean, const RealMatrix& covarianceMatrix);
 
+  /**
+   * Creates a Gaussian distribution with the given mean and precision
+   * matrix, avoiding the inversion of the covariance matrix.
+   */
+  static GaussianDistribution getFromPrecision(
+    const RealVector& mean, const RealMatrix& precisionMatrix);
+
+  const RealVector& getMean() const;
+
+  const RealMatrix& getPrecisionMatrix() const;
+
   auto getLogPdf() const;
 
+  auto getLogPdfGradient() const;
+
   template<class Flow>
   auto getPoissonProcessStrategy() const;
 
+  /**
+   * Return the linear flow Poisson process strategy and the log density
+   * gradient of the distribution held by the given pointer. They read its
+   * mean and precision matrix at every call instead of copying them, so
+   * that the distribution can be replaced in place after building (see
+   * BpsBuilder::setGaussianParameters).
+   */
+  static auto getSharedPoissonProcessStrategy(
+    std::shared_ptr<const GaussianDistribution> distribution);
+
+  static auto getSharedLogPdfGradient(
+    std::shared_ptr<const GaussianDistribution> distribution);
+
  private:
 
+  // Used by the factory creating the distribution from a precision matrix.
+  GaussianDistribution() = default;
+
   RealVector mean_;
   RealMatrix precisionMatrix_;
 
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
 #include <stdexcept>
 
 #include <Eigen/Core>
 #include <stan/math/prim/mat.hpp>
 
+#include "core/policies/boomerang_flow.h"
 #include "core/policies/linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
 #include "mcmc/utils.h"
 
 namespace {
@@ -19,6 +25,42 @@ double transformedInnerProduct(
   return x.transpose() * precisionMatrix * y;
 }
 
+// Simulates the first event time of the rate max(0, <v, P (x + vt - mean)>)
+// of the given position and velocity subvector under the linear flow.
+template<class Vector, class Rng>
+double getLinearFlowJumpTime(
+  const Vector& state,
+  const Eigen::Matrix<double, Eigen::Dynamic, 1>& mean,
+  const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& precisionMatrix,
+  std::uniform_real_distribution<double>& unif,
+  Rng& rng) {
+
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  if (state.size() % 2 != 0) {
+    throw std::runtime_error(
+      "Gaussian distribution poisson process strategy factory was invoked "
+      "using the linear flow policy, but the provided vector is of odd size"
+      " " + std::to_string(state.size()) + ".");
+  }
+  RealVector position = state.head(state.size() / 2) - mean;
+  RealVector velocity = state.tail(state.size() / 2);
+  double squaredVelocityNorm = transformedInnerProduct(
+    velocity, velocity, precisionMatrix);
+  if (squaredVelocityNorm == 0.0) {
+    // All the coordinates of the factor are at rest, e.g. stuck at zero.
+    return std::numeric_limits<double>::infinity();
+  }
+  double xv = transformedInnerProduct(position, velocity, precisionMatrix);
+  double logU = log(unif(rng));
+  if (xv >= 0) {
+    return (-xv + sqrt(xv * xv - 2.0 * squaredVelocityNorm * logU))
+           / squaredVelocityNorm;
+  } else {
+    return (-xv + sqrt(-2.0 * squaredVelocityNorm * logU))
+           / squaredVelocityNorm;
+  }
+}
+
 }
 
 namespace pdmp {
@@ -30,6 +72,23 @@ GaussianDistribution::GaussianDistribution(
     precisionMatrix_(covarianceMatrix.inverse()) {
 }
 
+GaussianDistribution GaussianDistribution::getFromPrecision(
+  const RealVector& mean, const RealMatrix& precisionMatrix) {
+
+  GaussianDistribution distribution;
+  distribution.mean_ = mean;
+  distribution.precisionMatrix_ = precisionMatrix;
+  return distribution;
+}
+
+auto GaussianDistribution::getMean() const -> const RealVector& {
+  return mean_;
+}
+
+auto GaussianDistribution::getPrecisionMatrix() const -> const RealMatrix& {
+  return precisionMatrix_;
+}
+
 auto GaussianDistribution::getLogPdf() const {
   auto logPdf =
     [mean = mean_, precisionMatrix = precisionMatrix_] (const auto& x) {
@@ -38,38 +97,142 @@ auto GaussianDistribution::getLogPdf() const {
   return logPdf;
 }
 
+auto GaussianDistribution::getLogPdfGradient() const {
+  auto gradient =
+    [mean = mean_, precisionMatrix = precisionMatrix_] (const auto& x) {
+      RealVector logPdfGradient = -1.0 * (precisionMatrix * (x - mean));
+      return logPdfGradient;
+    };
+  return gradient;
+}
+
 template<>
 auto GaussianDistribution::getPoissonProcessStrategy<LinearFlow>() const {
   auto rng = getRng();
   std::uniform_real_distribution<double> unif(0.0,1.0);
   auto strategy =
     [rng, unif, mean = mean_, precisionMatrix = precisionMatrix_]
+    (const auto& state, const auto&, const auto&) mutable {
+      return dependencies_graph::wrapPoissonProcessResult(
+        getLinearFlowJumpTime(state, mean, precisionMatrix, unif, rng));
+    };
+  return strategy;
+}
+
+auto GaussianDistribution::getSharedPoissonProcessStrategy(
+  std::shared_ptr<const GaussianDistribution> distribution) {
+
+  auto rng = getRng();
+  std::uniform_real_distribution<double> unif(0.0,1.0);
+  auto strategy =
+    [rng, unif, distribution]
+    (const auto& state, const auto&, const auto&) mutable {
+      return dependencies_graph::wrapPoissonProcessResult(
+        getLinearFlowJumpTime(
+          state, distribution->mean_, distribution->precisionMatrix_, unif,
+          rng));
+    };
+  return strategy;
+}
+
+auto GaussianDistribution::getSharedLogPdfGradient(
+  std::shared_ptr<const GaussianDistribution> distribution) {
+
+  auto gradient = [distribution] (const auto& x) {
+    RealVector logPdfGradient =
+      -1.0 * (distribution->precisionMatrix_ * (x - distribution->mean_));
+    return logPdfGradient;
+  };
+  return gradient;
+}
+
+// The Zig-Zag intensity is the superposition of the coordinate-wise
+// intensities max(0, v_i (P (x + vt - mean))_i), each affine in t before
+// taking the positive part, so the first event of each coordinate is
+// simulated exactly and the earliest one is returned.
+template<>
+auto GaussianDistribution::getPoissonProcessStrategy<ZigZagFlow>() const {
+  auto rng = getRng();
+  auto strategy =
+    [rng, mean = mean_, precisionMatrix = precisionMatrix_]
     (const auto& state, const auto&, const auto&) mutable {
       if (state.size() % 2 != 0) {
         throw std::runtime_error(
           "Gaussian distribution poisson process strategy factory was invoked "
-          "using the linear flow policy, but the provided vector is of odd size"
-          " " + std::to_string(state.size()) + ".");
+          "using the Zig-Zag flow policy, but the provided vector is of odd "
+          "size " + std::to_string(state.size()) + ".");
       }
       RealVector position = state.head(state.size() / 2) - mean;
       RealVector velocity = state.tail(state.size() / 2);
-      double squaredVelocityNorm = transformedInnerProduct(
-        velocity, velocity, precisionMatrix);
-      double xv = transformedInnerProduct(position, velocity, precisionMatrix);
-      double logU = log(unif(rng));
-      if (xv >= 0) {
-        return dependencies_graph::wrapPoissonProcessResult(
-          (-xv + sqrt(xv * xv - 2.0 * squaredVelocityNorm * logU))
-          / squaredVelocityNorm);
-      } else {
-        return dependencies_graph::wrapPoissonProcessResult(
-          (-xv + sqrt(-2.0 * squaredVelocityNorm * logU))
-          / squaredVelocityNorm);
+      RealVector initialRates =
+        velocity.cwiseProduct(precisionMatrix * position);
+      RealVector rateSlopes =
+        velocity.cwiseProduct(precisionMatrix * velocity);
+      double time = std::numeric_limits<double>::infinity();
+      for (int i = 0; i < velocity.size(); i++) {
+        time = std::min(time, getAffineIntensityJumpTime(
+          initialRates(i), rateSlopes(i),
+          stan::math::exponential_rng(1.0, rng)));
       }
+      return dependencies_graph::wrapPoissonProcessResult(time);
     };
   return strategy;
 }
 
-}
+// Under the Boomerang flow the rate <v(t), P (x(t) - mean)> is the
+// trigonometric polynomial
+//   (B - A) / 2 sin(2t) + C cos(2t) + a sin(t) - b cos(t),
+// with A = x^T P x, B = v^T P v, C = x^T P v, a = x^T P mean and
+// b = v^T P mean. It is bounded by the sum of the amplitudes of its two
+// harmonics, which is used for a single thinning step.
+template<>
+auto GaussianDistribution::getPoissonProcessStrategy<BoomerangFlow>() const {
+  auto rng = getRng();
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  auto strategy =
+    [rng, unif, mean = mean_, precisionMatrix = precisionMatrix_]
+    (const auto& state, const auto&, const auto&) mutable {
+      if (state.size() % 2 != 0) {
+        throw std::runtime_error(
+          "Gaussian distribution poisson process strategy factory was invoked "
+          "using the Boomerang flow policy, but the provided vector is of odd "
+          "size " + std::to_string(state.size()) + ".");
+      }
+      RealVector position = state.head(state.size() / 2);
+      RealVector velocity = state.tail(state.size() / 2);
+      RealVector precisionTimesMean = precisionMatrix * mean;
+      const double secondHarmonicSine = 0.5 * (
+        transformedInnerProduct(velocity, velocity, precisionMatrix)
+        - transformedInnerProduct(position, position, precisionMatrix));
+      const double secondHarmonicCosine =
+        transformedInnerProduct(position, velocity, precisionMatrix);
+      const double firstHarmonicSine = position.dot(precisionTimesMean);
+      const double firstHarmonicCosine = -velocity.dot(precisionTimesMean);
+      const double bound =
+        sqrt(secondHarmonicSine * secondHarmonicSine
+             + secondHarmonicCosine * secondHarmonicCosine)
+        + sqrt(firstHarmonicSine * firstHarmonicSine
+               + firstHarmonicCosine * firstHarmonicCosine);
+      const double time = getAffineIntensityJumpTime(
+        bound, 0.0, stan::math::exponential_rng(1.0, rng));
+      const double u = unif(rng);
+      auto thinningStep =
+        [secondHarmonicSine, secondHarmonicCosine, firstHarmonicSine,
+         firstHarmonicCosine, time, bound, u] () {
+          double intensity =
+            secondHarmonicSine * sin(2.0 * time)
+            + secondHarmonicCosine * cos(2.0 * time)
+            + firstHarmonicSine * sin(time)
+            + firstHarmonicCosine * cos(time);
+          return u * bound < intensity;
+        };
+      std::shared_ptr<dependencies_graph::PoissonProcessResultBase> result =
+        std::make_shared<dependencies_graph::PoissonProcessResult<
+          decltype(thinningStep)>>(time, thinningStep);
+      return result;
+    };
+  return strategy;
 }
 
+}
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <stan/math/prim/scal.hpp>
+
+#include "core/policies/linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
+#include "mcmc/utils.h"
+
+namespace {
+
+double getLaplaceSign(double x) {
+  return (0.0 < x) - (x < 0.0);
+}
+
+}
+
+namespace pdmp {
+namespace mcmc {
+
+LaplaceDistribution::LaplaceDistribution(double location, double scale)
+  : location_(location),
+    scale_(scale) {
+
+  if (scale <= 0.0) {
+    throw std::invalid_argument(
+      "Laplace distribution scale should be positive, but is "
+      + std::to_string(scale) + ".");
+  }
+}
+
+auto LaplaceDistribution::getLogPdf() const {
+  auto logPdf = [location = location_, scale = scale_] (const auto& x) {
+    using std::fabs;
+    return -fabs(x(0) - location) / scale;
+  };
+  return logPdf;
+}
+
+auto LaplaceDistribution::getLogPdfGradient() const {
+  auto gradient = [location = location_, scale = scale_] (const auto& x) {
+    RealVector logPdfGradient(1);
+    logPdfGradient(0) = -getLaplaceSign(x(0) - location) / scale;
+    return logPdfGradient;
+  };
+  return gradient;
+}
+
+template<>
+auto LaplaceDistribution::getPoissonProcessStrategy<LinearFlow>() const {
+  auto rng = getRng();
+  auto strategy =
+    [rng, location = location_, scale = scale_]
+    (const auto& state, const auto&, const auto&) mutable {
+      if (state.size() != 2) {
+        throw std::runtime_error(
+          "Laplace distribution poisson process strategy factory was invoked "
+          "with a vector of size " + std::to_string(state.size()) + ", but "
+          "the size should be 2.");
+      }
+      const double position = state(0) - location;
+      const double velocity = state(1);
+      if (velocity == 0.0) {
+        return dependencies_graph::wrapPoissonProcessResult(
+          std::numeric_limits<double>::infinity());
+      }
+      // The rate is zero until the particle crosses the location.
+      const double crossingTime =
+        position * velocity < 0.0 ? -position / velocity : 0.0;
+      return dependencies_graph::wrapPoissonProcessResult(
+        crossingTime + stan::math::exponential_rng(1.0, rng)
+                       * scale / std::abs(velocity));
+    };
+  return strategy;
+}
+
+// In one dimension the Zig-Zag and the BPS rates are the same.
+template<>
+auto LaplaceDistribution::getPoissonProcessStrategy<ZigZagFlow>() const {
+  return getPoissonProcessStrategy<LinearFlow>();
+}
+
+IndependentLaplaceDistribution::IndependentLaplaceDistribution(
+  const RealVector& locations, const RealVector& scales)
+  : locations_(locations),
+    scales_(scales) {
+
+  if (locations.size() != scales.size()) {
+    throw std::invalid_argument(
+      "Independent Laplace distribution was given "
+      + std::to_string(locations.size()) + " locations, but "
+      + std::to_string(scales.size()) + " scales.");
+  }
+  if (scales.size() > 0 && scales.minCoeff() <= 0.0) {
+    throw std::invalid_argument(
+      "Independent Laplace distribution scales should be positive.");
+  }
+}
+
+auto IndependentLaplaceDistribution::getLogPdf() const {
+  auto logPdf =
+    [locations = locations_, scales = scales_] (const auto& x) {
+      using std::fabs;
+      using Scalar = typename std::decay_t<decltype(x)>::Scalar;
+      Scalar logPdf = 0.0;
+      for (int i = 0; i < locations.size(); i++) {
+        logPdf -= fabs(x(i) - locations(i)) / scales(i);
+      }
+      return logPdf;
+    };
+  return logPdf;
+}
+
+auto IndependentLaplaceDistribution::getLogPdfGradient() const {
+  auto gradient =
+    [locations = locations_, scales = scales_] (const auto& x) {
+      RealVector logPdfGradient(locations.size());
+      for (int i = 0; i < locations.size(); i++) {
+        logPdfGradient(i) = -getLaplaceSign(x(i) - locations(i)) / scales(i);
+      }
+      return logPdfGradient;
+    };
+  return gradient;
+}
+
+auto IndependentLaplaceDistribution::getPiecewiseConstantStrategy(
+  bool perCoordinatePositivePart) const {
+
+  auto rng = getRng();
+  auto strategy =
+    [rng, locations = locations_, scales = scales_, perCoordinatePositivePart]
+    (const auto& state, const auto&, const auto&) mutable {
+      const int dimension = locations.size();
+      if (state.size() != 2 * dimension) {
+        throw std::runtime_error(
+          "Independent Laplace distribution poisson process strategy factory "
+          "was invoked with a vector of size " + std::to_string(state.size())
+          + ", but the size should be " + std::to_string(2 * dimension) + ".");
+      }
+      // Coordinate i contributes |v_i| / scale_i to the rate once it moves
+      // away from its location, and -|v_i| / scale_i (or 0 for Zig-Zag)
+      // while it moves towards it.
+      double initialIntensity = 0.0;
+      std::vector<std::pair<double, double>> breakpoints;
+      for (int i = 0; i < dimension; i++) {
+        const double position = state(i) - locations(i);
+        const double velocity = state(dimension + i);
+        if (velocity == 0.0) {
+          continue;
+        }
+        const double rate = std::abs(velocity) / scales(i);
+        if (position * velocity >= 0.0) {
+          initialIntensity += rate;
+        } else if (perCoordinatePositivePart) {
+          breakpoints.emplace_back(-position / velocity, rate);
+        } else {
+          initialIntensity -= rate;
+          breakpoints.emplace_back(-position / velocity, 2.0 * rate);
+        }
+      }
+      return dependencies_graph::wrapPoissonProcessResult(
+        getPiecewiseConstantIntensityJumpTime(
+          initialIntensity, std::move(breakpoints),
+          stan::math::exponential_rng(1.0, rng)));
+    };
+  return strategy;
+}
+
+template<>
+auto IndependentLaplaceDistribution::getPoissonProcessStrategy<LinearFlow>()
+  const {
+
+  return getPiecewiseConstantStrategy(false);
+}
+
+template<>
+auto IndependentLaplaceDistribution::getPoissonProcessStrategy<ZigZagFlow>()
+  const {
+
+  return getPiecewiseConstantStrategy(true);
+}
+
+}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <memory>
+
+#include "core/thread_pool.h"
+#include "mcmc/distributions/distribution_base.h"
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * The posterior factor of a Bayesian logistic regression model (without
+ * the prior), i.e. the likelihood of binary responses y_j given covariates
+ * a_j and regression coefficients x:
+ *   p(y | x) = prod_j sigmoid(a_j^T x)^y_j * (1 - sigmoid(a_j^T x))^(1 - y_j).
+ *
+ * The Hessian of the negative log-likelihood is bounded by Q = A A^T / 4,
+ * which is used for an affine bound of the event rate along the flow. Event
+ * times are simulated by exactly inverting the bound, followed by a single
+ * thinning step. For several observations Q is precomputed once and shared
+ * by the copies of the factor, while for a single observation a the bound
+ * v^T Q v = (a^T v)^2 / 4 is computed from a in O(d).
+ *
+ * A factor can hold the full dataset or any subset of it, e.g. a single
+ * observation (see getObservationFactor). The gradient of a factor holding
+ * a large dataset can be evaluated in parallel (see setParallelGradient).
+ */
+class LogisticRegressionDistribution
+  : public DistributionBase<LogisticRegressionDistribution> {
+
+ public:
+
+  using DataMatrix = Eigen::Map<const RealMatrix>;
+  using DataVector = Eigen::Map<const RealVector>;
+
+  /**
+   * Creates the distribution from a copy of the given data.
+   *
+   * @param covariates
+   *   A matrix holding the covariates of one observation per column.
+   * @param responses
+   *   The binary (0 or 1) responses for each observation.
+   */
+  LogisticRegressionDistribution(
+    const RealMatrix& covariates, const RealVector& responses);
+
+  /**
+   * Creates the distribution using views of data stored elsewhere (e.g. in
+   * a MemoryMappedDataset). The data is not copied, so the caller is
+   * responsible for keeping it alive while the distribution is in use.
+   */
+  LogisticRegressionDistribution(
+    const DataMatrix& covariates, const DataVector& responses);
+
+  auto getLogPdf() const;
+
+  auto getLogPdfGradient() const;
+
+  template<class Flow>
+  auto getPoissonProcessStrategy() const;
+
+  /**
+   * Makes the gradients (and thus the event simulation) of this
+   * distribution split the observations into chunks of the given size,
+   * whose partial gradients are computed using the given number of threads.
+   * The partial gradients are summed in a fixed order, so the gradients do
+   * not depend on the number of threads. A single thread switches the
+   * parallel evaluation off. Only affects the functors returned afterwards.
+   */
+  void setParallelGradient(
+    int numberOfThreads,
+    int observationsPerChunk = kDefaultObservationsPerChunk);
+
+  // The default number of observations per chunk of a parallel gradient.
+  static const int kDefaultObservationsPerChunk = 4096;
+
+  /**
+   * Returns the factor for the observation with the given index, sharing
+   * the data of this distribution.
+   */
+  LogisticRegressionDistribution getObservationFactor(int observationId) const;
+
+  /**
+   * Returns the number of observations in this factor.
+   */
+  int getNumberOfObservations() const;
+
+ private:
+
+  // Computes the bound on the Hessian of the negative log-likelihood, unless
+  // the factor holds a single observation.
+  void computeHessianBounds();
+
+  // Keeps the copied data alive, if the distribution owns its data.
+  std::shared_ptr<const RealMatrix> ownedCovariates_;
+  std::shared_ptr<const RealVector> ownedResponses_;
+
+  DataMatrix covariates_;
+  DataVector responses_;
+
+  // The bound Q = A A^T / 4 on the Hessian of the negative log-likelihood,
+  // and the same bound computed with absolute values of the covariates,
+  // bounding each Hessian entry in absolute value. Null for a single
+  // observation, whose rank-one bounds are computed from its covariates.
+  std::shared_ptr<const RealMatrix> hessianBound_;
+  std::shared_ptr<const RealMatrix> absoluteHessianBound_;
+
+  // The threads evaluating the gradient, if it is evaluated in parallel.
+  std::shared_ptr<ThreadPool> gradientThreadPool_;
+  int observationsPerChunk_{kDefaultObservationsPerChunk};
+
+};
+
+}
+}
+
+#include "logistic_regression.tcc"
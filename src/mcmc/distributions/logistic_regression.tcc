@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <Eigen/Core>
+#include <stan/math/prim/scal.hpp>
+
+#include "core/policies/linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
+#include "mcmc/utils.h"
+
+namespace pdmp {
+namespace mcmc {
+
+LogisticRegressionDistribution::LogisticRegressionDistribution(
+  const RealMatrix& covariates, const RealVector& responses)
+  : ownedCovariates_(std::make_shared<const RealMatrix>(covariates)),
+    ownedResponses_(std::make_shared<const RealVector>(responses)),
+    covariates_(
+      ownedCovariates_->data(), covariates.rows(), covariates.cols()),
+    responses_(ownedResponses_->data(), responses.size()) {
+
+  computeHessianBounds();
+}
+
+LogisticRegressionDistribution::LogisticRegressionDistribution(
+  const DataMatrix& covariates, const DataVector& responses)
+  : covariates_(covariates),
+    responses_(responses) {
+
+  computeHessianBounds();
+}
+
+void LogisticRegressionDistribution::computeHessianBounds() {
+  if (covariates_.cols() != responses_.size()) {
+    throw std::invalid_argument(
+      "Logistic regression was given " + std::to_string(covariates_.cols())
+      + " observations, but " + std::to_string(responses_.size())
+      + " responses.");
+  }
+  if (covariates_.cols() == 1) {
+    return;
+  }
+  hessianBound_ = std::make_shared<const RealMatrix>(
+    0.25 * covariates_ * covariates_.transpose());
+  RealMatrix absoluteCovariates = covariates_.cwiseAbs();
+  absoluteHessianBound_ = std::make_shared<const RealMatrix>(
+    0.25 * absoluteCovariates * absoluteCovariates.transpose());
+}
+
+auto LogisticRegressionDistribution::getLogPdf() const {
+  auto logPdf =
+    [covariates = covariates_, responses = responses_,
+     ownedCovariates = ownedCovariates_, ownedResponses = ownedResponses_]
+    (const auto& x) {
+      using Scalar = typename std::decay_t<decltype(x)>::Scalar;
+      Scalar logPdf = 0.0;
+      for (int j = 0; j < covariates.cols(); j++) {
+        Scalar linearPredictor = 0.0;
+        for (int i = 0; i < covariates.rows(); i++) {
+          linearPredictor += covariates(i, j) * x(i);
+        }
+        logPdf += responses(j) * linearPredictor
+                  - stan::math::log1p_exp(linearPredictor);
+      }
+      return logPdf;
+    };
+  return logPdf;
+}
+
+auto LogisticRegressionDistribution::getLogPdfGradient() const {
+  auto gradient =
+    [covariates = covariates_, responses = responses_,
+     ownedCovariates = ownedCovariates_, ownedResponses = ownedResponses_,
+     threadPool = gradientThreadPool_,
+     observationsPerChunk = observationsPerChunk_]
+    (const auto& x) {
+      // The gradient of the observations begin, ..., end - 1.
+      auto getPartialGradient = [&covariates, &responses, &x] (
+        int begin, int end) {
+          const auto chunkCovariates =
+            covariates.middleCols(begin, end - begin);
+          RealVector linearPredictors = chunkCovariates.transpose() * x;
+          RealVector residuals = responses.segment(begin, end - begin)
+            - linearPredictors.unaryExpr(
+                [] (double eta) { return 1.0 / (1.0 + exp(-eta)); });
+          RealVector logPdfGradient = chunkCovariates * residuals;
+          return logPdfGradient;
+        };
+      if (!threadPool) {
+        return getPartialGradient(0, covariates.cols());
+      }
+      return getSumOfChunksInParallel(
+        getPartialGradient, covariates.cols(), observationsPerChunk,
+        *threadPool);
+    };
+  return gradient;
+}
+
+void LogisticRegressionDistribution::setParallelGradient(
+  int numberOfThreads, int observationsPerChunk) {
+
+  if (numberOfThreads < 1 || observationsPerChunk < 1) {
+    throw std::invalid_argument(
+      "The number of threads and observations per chunk should be positive, "
+      "but " + std::to_string(numberOfThreads) + " and "
+      + std::to_string(observationsPerChunk) + " were given.");
+  }
+  gradientThreadPool_ = numberOfThreads > 1
+    ? std::make_shared<ThreadPool>(numberOfThreads)
+    : nullptr;
+  observationsPerChunk_ = observationsPerChunk;
+}
+
+// The BPS intensity <v, grad U(x + vt)> is bounded by
+// <v, grad U(x)> + t * v^T Q v, where v^T Q v = (a^T v)^2 / 4 for a single
+// observation a.
+template<>
+auto LogisticRegressionDistribution::getPoissonProcessStrategy<LinearFlow>()
+  const {
+
+  auto rng = getRng();
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  auto strategy =
+    [rng, unif, logPdfGradient = getLogPdfGradient(),
+     covariates = covariates_, hessianBound = hessianBound_]
+    (const auto& state, const auto&, const auto&) mutable {
+      if (state.size() % 2 != 0) {
+        throw std::runtime_error(
+          "Logistic regression poisson process strategy factory was invoked "
+          "using the linear flow policy, but the provided vector is of odd "
+          "size " + std::to_string(state.size()) + ".");
+      }
+      RealVector position = state.head(state.size() / 2);
+      RealVector velocity = state.tail(state.size() / 2);
+      const double a = -velocity.dot(logPdfGradient(position));
+      const double b = hessianBound
+        ? velocity.dot(*hessianBound * velocity)
+        : 0.25 * std::pow(covariates.col(0).dot(velocity), 2);
+      const double time = getAffineIntensityJumpTime(
+        a, b, stan::math::exponential_rng(1.0, rng));
+      const double bound = std::max(0.0, a + b * time);
+      const double u = unif(rng);
+      auto thinningStep =
+        [logPdfGradient, position, velocity, time, bound, u] () {
+          RealVector proposedPosition = position + velocity * time;
+          double intensity = std::max(
+            0.0, -velocity.dot(logPdfGradient(proposedPosition)));
+          return u * bound < intensity;
+        };
+      std::shared_ptr<dependencies_graph::PoissonProcessResultBase> result =
+        std::make_shared<dependencies_graph::PoissonProcessResult<
+          decltype(thinningStep)>>(time, thinningStep);
+      return result;
+    };
+  return strategy;
+}
+
+// The Zig-Zag intensity sum_i max(0, v_i * d_i U(x + vt)) is bounded by
+// sum_i max(0, v_i * d_i U(x)) + t * |v|^T B |v|, where B bounds the
+// absolute values of the Hessian entries, and |v|^T B |v| = (|a|^T |v|)^2 / 4
+// for a single observation a.
+template<>
+auto LogisticRegressionDistribution::getPoissonProcessStrategy<ZigZagFlow>()
+  const {
+
+  auto rng = getRng();
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  auto strategy =
+    [rng, unif, logPdfGradient = getLogPdfGradient(),
+     covariates = covariates_, absoluteHessianBound = absoluteHessianBound_]
+    (const auto& state, const auto&, const auto&) mutable {
+      if (state.size() % 2 != 0) {
+        throw std::runtime_error(
+          "Logistic regression poisson process strategy factory was invoked "
+          "using the Zig-Zag flow policy, but the provided vector is of odd "
+          "size " + std::to_string(state.size()) + ".");
+      }
+      RealVector position = state.head(state.size() / 2);
+      RealVector velocity = state.tail(state.size() / 2);
+      RealVector absoluteVelocity = velocity.cwiseAbs();
+      const double a = (-1.0 * velocity.cwiseProduct(
+        logPdfGradient(position))).cwiseMax(0.0).sum();
+      const double b = absoluteHessianBound
+        ? absoluteVelocity.dot(*absoluteHessianBound * absoluteVelocity)
+        : 0.25 * std::pow(
+            covariates.col(0).cwiseAbs().dot(absoluteVelocity), 2);
+      const double time = getAffineIntensityJumpTime(
+        a, b, stan::math::exponential_rng(1.0, rng));
+      const double bound = a + b * time;
+      const double u = unif(rng);
+      auto thinningStep =
+        [logPdfGradient, position, velocity, time, bound, u] () {
+          RealVector proposedPosition = position + velocity * time;
+          double intensity = (-1.0 * velocity.cwiseProduct(
+            logPdfGradient(proposedPosition))).cwiseMax(0.0).sum();
+          return u * bound < intensity;
+        };
+      std::shared_ptr<dependencies_graph::PoissonProcessResultBase> result =
+        std::make_shared<dependencies_graph::PoissonProcessResult<
+          decltype(thinningStep)>>(time, thinningStep);
+      return result;
+    };
+  return strategy;
+}
+
+LogisticRegressionDistribution
+LogisticRegressionDistribution::getObservationFactor(int observationId) const {
+  if (observationId < 0 || observationId >= covariates_.cols()) {
+    throw std::out_of_range("Observation id " + std::to_string(observationId)
+                            + " is out of range. Should be 0 <= id < "
+                            + std::to_string(covariates_.cols()) + ".");
+  }
+  LogisticRegressionDistribution observationFactor(
+    DataMatrix(covariates_.col(observationId).data(), covariates_.rows(), 1),
+    DataVector(responses_.data() + observationId, 1));
+  observationFactor.ownedCovariates_ = ownedCovariates_;
+  observationFactor.ownedResponses_ = ownedResponses_;
+  return observationFactor;
+}
+
+int LogisticRegressionDistribution::getNumberOfObservations() const {
+  return covariates_.cols();
+}
+
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "mcmc/distributions/distribution_base.h"
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * A univariate Student-t distribution with the given location, scale and
+ * degrees of freedom nu (nu = 1 gives the Cauchy distribution):
+ *   p(x) ~ (1 + (x - location)^2 / (nu * scale^2))^(-(nu + 1) / 2).
+ *
+ * The energy is unimodal along the flow, so the event rate is zero until
+ * the particle passes the location and then integrates to the increase of
+ * the energy. Event times are therefore obtained by exactly inverting the
+ * energy, without thinning.
+ */
+class StudentTDistribution : public DistributionBase<StudentTDistribution> {
+
+ public:
+
+  /**
+   * Creates a Student-t distribution with the given location, scale and
+   * degrees of freedom.
+   */
+  StudentTDistribution(double location, double scale, double degreesOfFreedom);
+
+  auto getLogPdf() const;
+
+  auto getLogPdfGradient() const;
+
+  template<class Flow>
+  auto getPoissonProcessStrategy() const;
+
+ private:
+
+  double location_;
+  double scale_;
+  double degreesOfFreedom_;
+
+};
+
+/**
+ * A multivariate Student-t distribution with the given mean, scale matrix S
+ * and degrees of freedom nu:
+ *   p(x) ~ (1 + (x - mean)^T S^-1 (x - mean) / nu)^(-(nu + d) / 2).
+ *
+ * The energy is a monotone function of a quadratic form, so BPS event times
+ * are simulated exactly as for the Gaussian distribution. For the Zig-Zag
+ * process each coordinate rate is bounded by a constant, and event times are
+ * simulated by superposition of these bounds and a single thinning step.
+ */
+class MultivariateStudentTDistribution
+  : public DistributionBase<MultivariateStudentTDistribution> {
+
+ public:
+
+  /**
+   * Creates a multivariate Student-t distribution with the given mean, scale
+   * matrix and degrees of freedom.
+   */
+  MultivariateStudentTDistribution(
+    const RealVector& mean, const RealMatrix& scaleMatrix,
+    double degreesOfFreedom);
+
+  auto getLogPdf() const;
+
+  auto getLogPdfGradient() const;
+
+  template<class Flow>
+  auto getPoissonProcessStrategy() const;
+
+ private:
+
+  RealVector mean_;
+  RealMatrix precisionMatrix_;
+  double degreesOfFreedom_;
+
+  // Constant bounds on the absolute values of the energy partial derivatives.
+  RealVector energyGradientBounds_;
+
+};
+
+}
+}
+
+#include "student_t.tcc"
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <Eigen/Core>
+#include <stan/math/prim/scal.hpp>
+
+#include "core/policies/linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
+#include "mcmc/utils.h"
+
+namespace pdmp {
+namespace mcmc {
+
+StudentTDistribution::StudentTDistribution(
+  double location, double scale, double degreesOfFreedom)
+  : location_(location),
+    scale_(scale),
+    degreesOfFreedom_(degreesOfFreedom) {
+
+  if (scale <= 0.0 || degreesOfFreedom <= 0.0) {
+    throw std::invalid_argument(
+      "Student-t distribution scale and degrees of freedom should be "
+      "positive.");
+  }
+}
+
+auto StudentTDistribution::getLogPdf() const {
+  auto logPdf =
+    [location = location_, scale = scale_, nu = degreesOfFreedom_]
+    (const auto& x) {
+      using std::log1p;
+      auto z = (x(0) - location) / scale;
+      return -0.5 * (nu + 1.0) * log1p(z * z / nu);
+    };
+  return logPdf;
+}
+
+auto StudentTDistribution::getLogPdfGradient() const {
+  auto gradient =
+    [location = location_, scale = scale_, nu = degreesOfFreedom_]
+    (const auto& x) {
+      const double z = x(0) - location;
+      RealVector logPdfGradient(1);
+      logPdfGradient(0) = -(nu + 1.0) * z / (nu * scale * scale + z * z);
+      return logPdfGradient;
+    };
+  return gradient;
+}
+
+template<>
+auto StudentTDistribution::getPoissonProcessStrategy<LinearFlow>() const {
+  auto rng = getRng();
+  auto strategy =
+    [rng, location = location_, scale = scale_, nu = degreesOfFreedom_]
+    (const auto& state, const auto&, const auto&) mutable {
+      if (state.size() != 2) {
+        throw std::runtime_error(
+          "Student-t distribution poisson process strategy factory was "
+          "invoked with a vector of size " + std::to_string(state.size())
+          + ", but the size should be 2.");
+      }
+      const double speed = std::abs(state(1));
+      if (speed == 0.0) {
+        return dependencies_graph::wrapPoissonProcessResult(
+          std::numeric_limits<double>::infinity());
+      }
+      // The signed distance from the location in the direction of motion.
+      const double distance = (state(1) > 0.0 ? 1.0 : -1.0)
+                              * (state(0) - location);
+      const double squaredScale = nu * scale * scale;
+      // The energy only increases after passing the location. Solve
+      // U(eventDistance) - U(max(0, distance)) = exponential.
+      const double startDistance = std::max(0.0, distance);
+      const double eventDistance = sqrt(
+        (squaredScale + startDistance * startDistance)
+        * exp(2.0 * stan::math::exponential_rng(1.0, rng) / (nu + 1.0))
+        - squaredScale);
+      return dependencies_graph::wrapPoissonProcessResult(
+        (eventDistance - distance) / speed);
+    };
+  return strategy;
+}
+
+// In one dimension the Zig-Zag and the BPS rates are the same.
+template<>
+auto StudentTDistribution::getPoissonProcessStrategy<ZigZagFlow>() const {
+  return getPoissonProcessStrategy<LinearFlow>();
+}
+
+MultivariateStudentTDistribution::MultivariateStudentTDistribution(
+  const RealVector& mean, const RealMatrix& scaleMatrix,
+  double degreesOfFreedom)
+  : mean_(mean),
+    precisionMatrix_(scaleMatrix.inverse()),
+    degreesOfFreedom_(degreesOfFreedom) {
+
+  if (degreesOfFreedom <= 0.0) {
+    throw std::invalid_argument(
+      "Student-t distribution degrees of freedom should be positive.");
+  }
+  if (scaleMatrix.rows() != mean.size() || scaleMatrix.cols() != mean.size()) {
+    throw std::invalid_argument(
+      "Multivariate Student-t distribution was given a mean of size "
+      + std::to_string(mean.size()) + ", but a scale matrix of size "
+      + std::to_string(scaleMatrix.rows()) + "x"
+      + std::to_string(scaleMatrix.cols()) + ".");
+  }
+  // By Cauchy-Schwarz |(P z)_i| <= sqrt(P_ii) sqrt(q) for q = z^T P z, and
+  // sqrt(q) / (nu + q) <= 1 / (2 sqrt(nu)).
+  energyGradientBounds_ =
+    (degreesOfFreedom + mean.size()) / (2.0 * sqrt(degreesOfFreedom))
+    * precisionMatrix_.diagonal().cwiseSqrt();
+}
+
+auto MultivariateStudentTDistribution::getLogPdf() const {
+  auto logPdf =
+    [mean = mean_, precisionMatrix = precisionMatrix_,
+     nu = degreesOfFreedom_] (const auto& x) {
+      using std::log1p;
+      using Scalar = typename std::decay_t<decltype(x)>::Scalar;
+      const int dimension = mean.size();
+      Eigen::Matrix<Scalar, Eigen::Dynamic, 1> z(dimension);
+      for (int i = 0; i < dimension; i++) {
+        z(i) = x(i) - mean(i);
+      }
+      Scalar quadraticForm = 0.0;
+      for (int i = 0; i < dimension; i++) {
+        for (int j = 0; j < dimension; j++) {
+          quadraticForm += z(i) * precisionMatrix(i, j) * z(j);
+        }
+      }
+      return -0.5 * (nu + dimension) * log1p(quadraticForm / nu);
+    };
+  return logPdf;
+}
+
+auto MultivariateStudentTDistribution::getLogPdfGradient() const {
+  auto gradient =
+    [mean = mean_, precisionMatrix = precisionMatrix_,
+     nu = degreesOfFreedom_] (const auto& x) {
+      RealVector precisionTimesZ = precisionMatrix * (x - mean);
+      const double quadraticForm = (x - mean).dot(precisionTimesZ);
+      RealVector logPdfGradient =
+        -(nu + mean.size()) / (nu + quadraticForm) * precisionTimesZ;
+      return logPdfGradient;
+    };
+  return gradient;
+}
+
+template<>
+auto MultivariateStudentTDistribution::getPoissonProcessStrategy<LinearFlow>()
+  const {
+
+  auto rng = getRng();
+  auto strategy =
+    [rng, mean = mean_, precisionMatrix = precisionMatrix_,
+     nu = degreesOfFreedom_]
+    (const auto& state, const auto&, const auto&) mutable {
+      if (state.size() != 2 * mean.size()) {
+        throw std::runtime_error(
+          "Multivariate Student-t distribution poisson process strategy "
+          "factory was invoked with a vector of size "
+          + std::to_string(state.size()) + ", but the size should be "
+          + std::to_string(2 * mean.size()) + ".");
+      }
+      RealVector position = state.head(mean.size()) - mean;
+      RealVector velocity = state.tail(mean.size());
+      RealVector precisionTimesVelocity = precisionMatrix * velocity;
+      // Along the flow q(t) = q0 + 2at + bt^2, and the energy
+      // (nu + d) / 2 * log(nu + q(t)) only increases after the minimum of q.
+      const double a = position.dot(precisionTimesVelocity);
+      const double b = velocity.dot(precisionTimesVelocity);
+      const double q0 = position.dot(precisionMatrix * position);
+      if (b <= 0.0) {
+        return dependencies_graph::wrapPoissonProcessResult(
+          std::numeric_limits<double>::infinity());
+      }
+      const double qMin = a >= 0.0 ? q0 : q0 - a * a / b;
+      const double qEvent =
+        (nu + qMin)
+        * exp(2.0 * stan::math::exponential_rng(1.0, rng) / (nu + mean.size()))
+        - nu;
+      return dependencies_graph::wrapPoissonProcessResult(
+        (-a + sqrt(std::max(0.0, a * a + b * (qEvent - q0)))) / b);
+    };
+  return strategy;
+}
+
+template<>
+auto MultivariateStudentTDistribution::getPoissonProcessStrategy<ZigZagFlow>()
+  const {
+
+  auto rng = getRng();
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  auto strategy =
+    [rng, unif, logPdfGradient = getLogPdfGradient(),
+     energyGradientBounds = energyGradientBounds_]
+    (const auto& state, const auto&, const auto&) mutable {
+      const int dimension = energyGradientBounds.size();
+      if (state.size() != 2 * dimension) {
+        throw std::runtime_error(
+          "Multivariate Student-t distribution poisson process strategy "
+          "factory was invoked with a vector of size "
+          + std::to_string(state.size()) + ", but the size should be "
+          + std::to_string(2 * dimension) + ".");
+      }
+      RealVector position = state.head(dimension);
+      RealVector velocity = state.tail(dimension);
+      // Superposition of the constant bounds |v_i| * bound_i.
+      const double bound =
+        velocity.cwiseAbs().dot(energyGradientBounds);
+      const double time = getAffineIntensityJumpTime(
+        bound, 0.0, stan::math::exponential_rng(1.0, rng));
+      const double u = unif(rng);
+      auto thinningStep =
+        [logPdfGradient, position, velocity, time, bound, u] () {
+          RealVector proposedPosition = position + velocity * time;
+          double intensity = (-1.0 * velocity.cwiseProduct(
+            logPdfGradient(proposedPosition))).cwiseMax(0.0).sum();
+          return u * bound < intensity;
+        };
+      std::shared_ptr<dependencies_graph::PoissonProcessResultBase> result =
+        std::make_shared<dependencies_graph::PoissonProcessResult<
+          decltype(thinningStep)>>(time, thinningStep);
+      return result;
+    };
+  return strategy;
+}
+
+}
+}
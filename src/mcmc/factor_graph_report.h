@@ -0,0 +1,67 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * The degree and the event cost of a single variable of a factor graph.
+ */
+struct HubReport {
+
+  // The id of the variable.
+  int variableId;
+
+  // The number of factors depending on the variable.
+  int degree;
+
+  // The number of Markov kernels, which can modify the variable.
+  int numberOfModifyingKernels;
+
+  // The mean and the maximum number of factors depending on the kernels
+  // which can modify the variable, i.e. the number of factors resimulated
+  // after their events unless these are hub events. The mean is taken over
+  // the kernels, not weighted by their event rates.
+  double meanDependentFactorsPerKernel;
+  int maxDependentFactorsPerKernel;
+
+};
+
+/**
+ * A summary of the shape of a factor graph, for spotting the high-degree
+ * variables (hubs) that dominate the cost of the events touching them.
+ */
+struct FactorGraphReport {
+
+  // The number of variables with each degree.
+  std::map<int, int> degreeDistribution;
+
+  // The mean number of factors depending on a kernel, over the kernels.
+  double meanDependentFactorsPerKernel;
+
+  // The variables with the highest degrees, by decreasing degree.
+  std::vector<HubReport> hubs;
+
+};
+
+/**
+ * Computes the report of a dependencies graph, listing the given number of
+ * highest-degree variables.
+ */
+template<class Flow, class DependenciesGraph>
+FactorGraphReport getFactorGraphReport(
+  DependenciesGraph& dependenciesGraph, int numberOfHubs);
+
+/**
+ * Prints the report in a human readable form.
+ */
+void printFactorGraphReport(
+  const FactorGraphReport& report, std::ostream& out);
+
+}
+}
+
+#include "factor_graph_report.tcc"
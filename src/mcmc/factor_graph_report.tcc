@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace pdmp {
+namespace mcmc {
+
+template<class Flow, class DependenciesGraph>
+FactorGraphReport getFactorGraphReport(
+  DependenciesGraph& dependenciesGraph, int numberOfHubs) {
+
+  if (numberOfHubs < 0) {
+    throw std::invalid_argument(
+      "The number of hubs should be non-negative, but "
+      + std::to_string(numberOfHubs) + " was given.");
+  }
+  const auto& variableNodes = dependenciesGraph.variableNodes;
+  const auto& markovKernelNodes = dependenciesGraph.markovKernelNodes;
+  const int numberOfVariables = variableNodes.size();
+  const int numberOfFactors = markovKernelNodes.size();
+
+  FactorGraphReport report;
+  for (const auto& variableNode : variableNodes) {
+    report.degreeDistribution[variableNode->dependentFactorIds.size()]++;
+  }
+
+  // The dependent factors of the kernels modifying each variable.
+  std::vector<HubReport> variableReports(numberOfVariables);
+  for (int i = 0; i < numberOfVariables; i++) {
+    variableReports[i] = HubReport{
+      i, static_cast<int>(variableNodes[i]->dependentFactorIds.size()),
+      0, 0.0, 0};
+  }
+  double totalDependentFactors = 0.0;
+  for (int factorId = 0; factorId < numberOfFactors; factorId++) {
+    const int cost = dependenciesGraph.template getFactorDependencies<Flow>(
+      factorId).size();
+    totalDependentFactors += cost;
+    for (int id : markovKernelNodes[factorId]->dependentVariableIds) {
+      auto& variableReport = variableReports[id];
+      variableReport.numberOfModifyingKernels++;
+      variableReport.meanDependentFactorsPerKernel += cost;
+      variableReport.maxDependentFactorsPerKernel = std::max(
+        variableReport.maxDependentFactorsPerKernel, cost);
+    }
+  }
+  report.meanDependentFactorsPerKernel =
+    numberOfFactors > 0 ? totalDependentFactors / numberOfFactors : 0.0;
+  for (auto& variableReport : variableReports) {
+    if (variableReport.numberOfModifyingKernels > 0) {
+      variableReport.meanDependentFactorsPerKernel /=
+        variableReport.numberOfModifyingKernels;
+    }
+  }
+
+  std::stable_sort(
+    variableReports.begin(), variableReports.end(),
+    [] (const HubReport& lhs, const HubReport& rhs) {
+      return lhs.degree > rhs.degree;
+    });
+  variableReports.resize(std::min(numberOfHubs, numberOfVariables));
+  report.hubs = std::move(variableReports);
+  return report;
+}
+
+void printFactorGraphReport(
+  const FactorGraphReport& report, std::ostream& out) {
+
+  out << "degree, number of variables" << std::endl;
+  for (const auto& entry : report.degreeDistribution) {
+    out << entry.first << ", " << entry.second << std::endl;
+  }
+  out << "mean dependent factors per kernel: "
+      << report.meanDependentFactorsPerKernel << std::endl;
+  out << "variable id, degree, modifying kernels, "
+      << "mean dependent factors per kernel, "
+      << "max dependent factors per kernel" << std::endl;
+  for (const auto& hub : report.hubs) {
+    out << hub.variableId << ", " << hub.degree << ", "
+        << hub.numberOfModifyingKernels << ", "
+        << hub.meanDependentFactorsPerKernel << ", "
+        << hub.maxDependentFactorsPerKernel << std::endl;
+  }
+}
+
+}
+}
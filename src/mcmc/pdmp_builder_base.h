@@ -4,10 +4,14 @@
 #include "core/dependencies_graph/dependencies_graph.h"
 #include "core/dependencies_graph/factor_node.h"
 #include "core/dependencies_graph/markov_kernel_node.h"
+#include "core/dependencies_graph/partitioned_pdmp.h"
 #include "core/dependencies_graph/variable_node.h"
 #include "core/policies/linear_flow.h"
 #include "core/policies/markov_kernel.h"
 #include "core/policies/poisson_process.h"
+#include "mcmc/factor_graph_report.h"
+#include "mcmc/pdmp_model.h"
+#include "mcmc/variable_ordering.h"
 
 namespace pdmp {
 namespace mcmc {
@@ -27,6 +31,11 @@ class PdmpBuilderBase {
   using VariableNode = dependencies_graph::VariableNode;
   using DependenciesGraph = dependencies_graph::DependenciesGraph<
     MarkovKernelNodeBase, VariableNode, FactorNodeBase>;
+  using Model = PdmpModel<State, Flow, DependenciesGraph>;
+
+  // The default number of factors resimulated per event, from which on the
+  // events are treated as hub events (see setHubThreshold).
+  static const int kDefaultHubThreshold = 32;
 
   PdmpBuilderBase(int stateSpaceDimension);
 
@@ -72,18 +81,187 @@ class PdmpBuilderBase {
     const std::vector<int>& variableIdsModifiableByKernel,
     F kernel);
 
+  /**
+   * Adds a factor node and its Markov kernel node, whose lambdas are
+   * created by the given function. Unlike the nodes added one by one, these
+   * can be part of a shared model (see buildModel), which calls the function
+   * again for each chain, so that each chain gets its own lambda state, e.g.
+   * random number generators and caches shared by the two lambdas.
+   *
+   * @param dependentVariableIds
+   *   The variables needed by the Poisson process simulation of the factor.
+   * @param variableIdsNeededByKernel
+   * @param variableIdsModifiableByKernel
+   *   The variables accessed and modified by the Markov kernel (see
+   *   addMarkovKernelNode).
+   * @param createLambdas
+   *   A callable object returning a tuple of the Poisson process strategy
+   *   and the Markov kernel lambdas. It is kept by the model, so it should
+   *   capture its parameters by value.
+   */
+  template<class F>
+  void addFactorAndMarkovKernelNodes(
+    const std::vector<int>& dependentVariableIds,
+    const std::vector<int>& variableIdsNeededByKernel,
+    const std::vector<int>& variableIdsModifiableByKernel,
+    F createLambdas);
+
+  /**
+   * The variables of a factor node and its Markov kernel node (see
+   * addFactorAndMarkovKernelNodes).
+   */
+  struct FactorSpec {
+    std::vector<int> dependentVariableIds;
+    std::vector<int> variableIdsNeededByKernel;
+    std::vector<int> variableIdsModifiableByKernel;
+  };
+
+  /**
+   * Adds the factor and Markov kernel nodes of many factors at once, e.g.
+   * for models with millions of factors, where adding them one by one
+   * dominates the startup. The nodes are created on the given number of
+   * threads, in chunks of kNumberOfFactorsPerChunk factors, each with its
+   * own ScopedRngSeed drawn from getRng(), so the created lambdas do not
+   * depend on the number of threads.
+   *
+   * @param factorSpecs
+   *   The variables of the nodes of each factor.
+   * @param createLambdas
+   *   A callable object, returning the tuple of the Poisson process
+   *   strategy and the Markov kernel lambdas of the factor with the given
+   *   index in factorSpecs. It is called concurrently, and kept by the
+   *   model (see buildModel).
+   * @param numberOfThreads
+   */
+  template<class F>
+  void addFactorAndMarkovKernelNodes(
+    const std::vector<FactorSpec>& factorSpecs,
+    F createLambdas,
+    int numberOfThreads);
+
+  static const int kNumberOfFactorsPerChunk = 1024;
+
+  /**
+   * Sets the ordering of the variables in the state vectors of the built
+   * PDMP. For large, sparse factor graphs, renumbering the variables such
+   * that the ones sharing factors are close to each other makes the state
+   * subvector reads and writes of each event touch few cache lines.
+   *
+   * The state is assumed to hold the positions followed by the velocities,
+   * and the same permutation is applied to both halves. The lambdas are given
+   * the same subvectors as without reordering, so they must not rely on the
+   * global variable ids. The states passed to and returned by the built PDMP
+   * are in the internal ordering (see getInternalState and getUserState).
+   */
+  void setVariableOrdering(VariableOrdering ordering);
+
+  /**
+   * Returns the internal id of each variable of the built PDMP, indexed by
+   * the user-facing variable id.
+   */
+  const std::vector<int>& getVariablePermutation() const;
+
+  /**
+   * Maps a state with the user-facing variable ids to the internal ordering
+   * of the built PDMP, e.g. to give it an initial state.
+   */
+  State getInternalState(const State& userState) const;
+
+  /**
+   * Maps a state of the built PDMP back to the user-facing variable ids.
+   */
+  State getUserState(const State& internalState) const;
+
+  /**
+   * Sets the number of dependent factors, from which on the events of a
+   * factor are treated as hub events. These are typically the events
+   * modifying a variable shared by most factors, e.g. a global
+   * hyperparameter of a hierarchical model. After a hub event, the built
+   * PDMP only resimulates the factors depending on the variables whose
+   * values were actually changed by the Markov kernel (e.g. a single
+   * velocity for a Zig-Zag flip), instead of all the factors depending on
+   * the variables the kernel may modify. When all these variables were
+   * changed (e.g. after a BPS bounce), the usual cached dependencies are
+   * resimulated, so the threshold only costs comparing the modified values.
+   */
+  void setHubThreshold(int numberOfDependentFactors);
+
+  /**
+   * Returns the degree distribution of the variables added so far, and the
+   * number of factors depending on the kernels modifying the given number of
+   * highest-degree variables.
+   */
+  FactorGraphReport getFactorGraphReport(int numberOfHubs = 10) const;
+
+  /**
+   * Makes the built PDMP resimulate the factors affected by an event using
+   * the given number of threads, when there are at least
+   * minimumNumberOfFactors of them (see
+   * dependencies_graph::PoissonProcess::setParallelResimulation).
+   */
+  void setParallelResimulation(
+    int numberOfThreads,
+    int minimumNumberOfFactors = dependencies_graph::PoissonProcess<
+      DependenciesGraph>::kDefaultMinimumNumberOfFactorsPerBatch);
 
   /**
    * Returns a PDMP based on the dependencies graph created.
    */
   auto build();
 
+  /**
+   * Returns an immutable model, which can be shared by many chains (see
+   * PdmpModel), so that running k chains costs one model and k chain
+   * states instead of k built PDMPs. All the nodes have to be added by
+   * addFactorAndMarkovKernelNodes.
+   */
+  std::shared_ptr<const Model> buildModel();
+
+  /**
+   * Returns a parallel simulator of the PDMP, which splits the model
+   * variables into the given number of partitions, each simulated by its
+   * own thread (see dependencies_graph::PartitionedPdmp). Variables with
+   * nearby ids should interact, e.g. after setting the reverse
+   * Cuthill-McKee ordering.
+   */
+  dependencies_graph::PartitionedPdmp<DependenciesGraph, State, Flow>
+  buildPartitioned(int numberOfPartitions);
+
  protected:
 
   int numberOfFactorsAdded_{0};
   std::vector<std::shared_ptr<VariableNode>> variableNodes_;
   std::vector<std::shared_ptr<FactorNodeBase>> factorNodes_;
   std::vector<std::shared_ptr<MarkovKernelNodeBase>> markovKernelNodes_;
+
+ private:
+
+  // The node factory of each factor id, or an empty function for the nodes
+  // added one by one.
+  std::vector<typename Model::NodeFactory> nodeFactories_;
+
+  // Returns the factor and Markov kernel nodes with the given variables and
+  // the lambdas in the given tuple.
+  template<class Lambdas>
+  static std::pair<
+    std::shared_ptr<FactorNodeBase>, std::shared_ptr<MarkovKernelNodeBase>>
+  createNodes(
+    const std::vector<int>& dependentVariableIds,
+    const std::vector<int>& variableIdsNeededByKernel,
+    const std::vector<int>& variableIdsModifiableByKernel,
+    Lambdas&& lambdas);
+
+  // Computes the permutation of the state variables for the set ordering.
+  void computeVariablePermutation();
+
+  // Creates the dependencies graph of the nodes in the set ordering.
+  std::shared_ptr<DependenciesGraph> getDependenciesGraph();
+
+  int hubThreshold_{kDefaultHubThreshold};
+  int numberOfResimulationThreads_{1};
+  int minimumNumberOfFactorsPerBatch_{1};
+  VariableOrdering variableOrdering_{VariableOrdering::AsAdded};
+  std::vector<int> variablePermutation_;
 };
 
 }
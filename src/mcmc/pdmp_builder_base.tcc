@@ -1,6 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
 #include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "core/thread_pool.h"
+#include "mcmc/utils.h"
 
 namespace pdmp {
 namespace mcmc {
@@ -12,6 +21,8 @@ PdmpBuilderBase<State, Flow>::PdmpBuilderBase(
   for (int i = 0; i < stateSpaceDimension; i++) {
     variableNodes_.push_back(std::make_shared<VariableNode>());
   }
+  variablePermutation_.resize(stateSpaceDimension);
+  std::iota(variablePermutation_.begin(), variablePermutation_.end(), 0);
 }
 
 template<class State, class Flow>
@@ -26,6 +37,7 @@ void PdmpBuilderBase<State, Flow>::addFactorNode(
       State, decltype(poissonProcessStrategy), Flow, decltype(intensity)>>(
         dependentVariableIds, poissonProcessStrategy, intensity);
   factorNodes_.push_back(factorNode);
+  nodeFactories_.emplace_back();
 
   // Update the variable nodes, on which the current factor depends.
   for (int i = 0; i < dependentVariableIds.size(); i++) {
@@ -51,14 +63,285 @@ void PdmpBuilderBase<State, Flow>::addMarkovKernelNode(
 }
 
 template<class State, class Flow>
-auto PdmpBuilderBase<State, Flow>::build() {
-  auto dependenciesGraph = std::make_shared<DependenciesGraph>(
+template<class F>
+void PdmpBuilderBase<State, Flow>::addFactorAndMarkovKernelNodes(
+  const std::vector<int>& dependentVariableIds,
+  const std::vector<int>& variableIdsNeededByKernel,
+  const std::vector<int>& variableIdsModifiableByKernel,
+  F createLambdas) {
+
+  auto nodeFactory =
+    [dependentVariableIds, variableIdsNeededByKernel,
+     variableIdsModifiableByKernel, createLambdas] () {
+      return createNodes(
+        dependentVariableIds, variableIdsNeededByKernel,
+        variableIdsModifiableByKernel, createLambdas());
+    };
+
+  auto nodes = nodeFactory();
+  factorNodes_.push_back(nodes.first);
+  markovKernelNodes_.push_back(nodes.second);
+  nodeFactories_.push_back(nodeFactory);
+  for (int variableId : dependentVariableIds) {
+    variableNodes_.at(variableId)->dependentFactorIds.push_back(
+      numberOfFactorsAdded_);
+  }
+  numberOfFactorsAdded_++;
+}
+
+template<class State, class Flow>
+template<class F>
+void PdmpBuilderBase<State, Flow>::addFactorAndMarkovKernelNodes(
+  const std::vector<FactorSpec>& factorSpecs,
+  F createLambdas,
+  int numberOfThreads) {
+
+  for (const auto& factorSpec : factorSpecs) {
+    for (int variableId : factorSpec.dependentVariableIds) {
+      if (variableId < 0 || variableId >= variableNodes_.size()) {
+        throw std::out_of_range(
+          "Variable id " + std::to_string(variableId) + " is out of range.");
+      }
+    }
+  }
+  ThreadPool threadPool(numberOfThreads);
+  const int numberOfFactors = factorSpecs.size();
+  const int firstFactorId = factorNodes_.size();
+  const int firstMarkovKernelId = markovKernelNodes_.size();
+  factorNodes_.resize(firstFactorId + numberOfFactors);
+  markovKernelNodes_.resize(firstMarkovKernelId + numberOfFactors);
+  nodeFactories_.resize(firstFactorId + numberOfFactors);
+
+  // The factories of all the factors share the specs and createLambdas.
+  auto sharedFactorSpecs =
+    std::make_shared<const std::vector<FactorSpec>>(factorSpecs);
+  auto sharedCreateLambdas = std::make_shared<const F>(std::move(createLambdas));
+  const std::uint64_t seed = getRng()();
+  const int numberOfChunks =
+    (numberOfFactors + kNumberOfFactorsPerChunk - 1) / kNumberOfFactorsPerChunk;
+  threadPool.parallelFor(
+    numberOfChunks,
+    [&, firstFactorId, firstMarkovKernelId] (int chunk) {
+      ScopedRngSeed scopedSeed(seed + chunk);
+      const int end = std::min(
+        numberOfFactors, (chunk + 1) * kNumberOfFactorsPerChunk);
+      for (int i = chunk * kNumberOfFactorsPerChunk; i < end; i++) {
+        auto nodeFactory = [sharedFactorSpecs, sharedCreateLambdas, i] () {
+          const FactorSpec& factorSpec = (*sharedFactorSpecs)[i];
+          return createNodes(
+            factorSpec.dependentVariableIds,
+            factorSpec.variableIdsNeededByKernel,
+            factorSpec.variableIdsModifiableByKernel,
+            (*sharedCreateLambdas)(i));
+        };
+        auto nodes = nodeFactory();
+        factorNodes_[firstFactorId + i] = std::move(nodes.first);
+        markovKernelNodes_[firstMarkovKernelId + i] = std::move(nodes.second);
+        nodeFactories_[firstFactorId + i] = std::move(nodeFactory);
+      }
+    });
+
+  for (int i = 0; i < numberOfFactors; i++) {
+    for (int variableId : factorSpecs[i].dependentVariableIds) {
+      variableNodes_[variableId]->dependentFactorIds.push_back(
+        numberOfFactorsAdded_ + i);
+    }
+  }
+  numberOfFactorsAdded_ += numberOfFactors;
+}
+
+template<class State, class Flow>
+template<class Lambdas>
+std::pair<
+  std::shared_ptr<typename PdmpBuilderBase<State, Flow>::FactorNodeBase>,
+  std::shared_ptr<typename PdmpBuilderBase<State, Flow>::MarkovKernelNodeBase>>
+PdmpBuilderBase<State, Flow>::createNodes(
+  const std::vector<int>& dependentVariableIds,
+  const std::vector<int>& variableIdsNeededByKernel,
+  const std::vector<int>& variableIdsModifiableByKernel,
+  Lambdas&& lambdas) {
+
+  using PoissonProcessLambda =
+    std::tuple_element_t<0, std::decay_t<Lambdas>>;
+  using MarkovKernelLambda = std::tuple_element_t<1, std::decay_t<Lambdas>>;
+  std::shared_ptr<FactorNodeBase> factorNode = std::make_shared<
+    dependencies_graph::FactorNode<State, PoissonProcessLambda, Flow>>(
+      dependentVariableIds, std::get<0>(lambdas));
+  std::shared_ptr<MarkovKernelNodeBase> markovKernelNode =
+    std::make_shared<
+      dependencies_graph::MarkovKernelNode<State, MarkovKernelLambda>>(
+        variableIdsModifiableByKernel,
+        std::get<1>(lambdas),
+        variableIdsNeededByKernel);
+  return std::make_pair(factorNode, markovKernelNode);
+}
+
+template<class State, class Flow>
+void PdmpBuilderBase<State, Flow>::setVariableOrdering(
+  VariableOrdering ordering) {
+
+  variableOrdering_ = ordering;
+}
+
+template<class State, class Flow>
+const std::vector<int>&
+PdmpBuilderBase<State, Flow>::getVariablePermutation() const {
+  return variablePermutation_;
+}
+
+template<class State, class Flow>
+State PdmpBuilderBase<State, Flow>::getInternalState(
+  const State& userState) const {
+
+  std::vector<int> userIds(variablePermutation_.size());
+  std::iota(userIds.begin(), userIds.end(), 0);
+  return userState.constructStateWithModifiedVariables(
+    variablePermutation_, userState.getSubvector(userIds));
+}
+
+template<class State, class Flow>
+State PdmpBuilderBase<State, Flow>::getUserState(
+  const State& internalState) const {
+
+  std::vector<int> userIds(variablePermutation_.size());
+  std::iota(userIds.begin(), userIds.end(), 0);
+  return internalState.constructStateWithModifiedVariables(
+    userIds, internalState.getSubvector(variablePermutation_));
+}
+
+template<class State, class Flow>
+void PdmpBuilderBase<State, Flow>::setHubThreshold(
+  int numberOfDependentFactors) {
+
+  if (numberOfDependentFactors < 1) {
+    throw std::invalid_argument(
+      "The hub threshold should be positive, but "
+      + std::to_string(numberOfDependentFactors) + " was given.");
+  }
+  hubThreshold_ = numberOfDependentFactors;
+}
+
+template<class State, class Flow>
+void PdmpBuilderBase<State, Flow>::setParallelResimulation(
+  int numberOfThreads, int minimumNumberOfFactors) {
+
+  if (numberOfThreads < 1 || minimumNumberOfFactors < 1) {
+    throw std::invalid_argument(
+      "The number of threads and the minimum number of factors resimulated "
+      "in parallel should be positive, but " + std::to_string(numberOfThreads)
+      + " and " + std::to_string(minimumNumberOfFactors) + " were given.");
+  }
+  numberOfResimulationThreads_ = numberOfThreads;
+  minimumNumberOfFactorsPerBatch_ = minimumNumberOfFactors;
+}
+
+template<class State, class Flow>
+FactorGraphReport PdmpBuilderBase<State, Flow>::getFactorGraphReport(
+  int numberOfHubs) const {
+
+  DependenciesGraph dependenciesGraph(
     markovKernelNodes_, variableNodes_, factorNodes_);
-  auto args = std::make_tuple(dependenciesGraph);
-  return Pdmp<
+  return mcmc::getFactorGraphReport<Flow>(dependenciesGraph, numberOfHubs);
+}
+
+template<class State, class Flow>
+void PdmpBuilderBase<State, Flow>::computeVariablePermutation() {
+  const int stateSpaceDimension = variableNodes_.size();
+  std::iota(variablePermutation_.begin(), variablePermutation_.end(), 0);
+  if (variableOrdering_ == VariableOrdering::AsAdded) {
+    return;
+  }
+  if (stateSpaceDimension % 2 != 0) {
+    throw std::runtime_error(
+      "Variable reordering needs a state of positions and velocities, but "
+      "the state space dimension " + std::to_string(stateSpaceDimension)
+      + " is odd.");
+  }
+
+  // Order the model variables by the graph of the factors, with positions
+  // and velocities of a variable counting as one.
+  const int numberOfModelVariables = stateSpaceDimension / 2;
+  std::vector<std::vector<int>> factorModelVariableIds;
+  factorModelVariableIds.reserve(factorNodes_.size());
+  for (const auto& factorNode : factorNodes_) {
+    std::vector<int> modelVariableIds;
+    for (int id : factorNode->dependentVariableIds) {
+      modelVariableIds.push_back(id % numberOfModelVariables);
+    }
+    factorModelVariableIds.push_back(std::move(modelVariableIds));
+  }
+  auto modelVariablePermutation = getReverseCuthillMcKeePermutation(
+    getAdjacencyLists(factorModelVariableIds, numberOfModelVariables));
+  for (int i = 0; i < stateSpaceDimension; i++) {
+    variablePermutation_[i] =
+      modelVariablePermutation[i % numberOfModelVariables]
+      + (i / numberOfModelVariables) * numberOfModelVariables;
+  }
+}
+
+template<class State, class Flow>
+std::shared_ptr<typename PdmpBuilderBase<State, Flow>::DependenciesGraph>
+PdmpBuilderBase<State, Flow>::getDependenciesGraph() {
+  computeVariablePermutation();
+  auto variableNodes = variableNodes_;
+  auto factorNodes = factorNodes_;
+  auto markovKernelNodes = markovKernelNodes_;
+  if (variableOrdering_ != VariableOrdering::AsAdded) {
+    // The factor ids are not changed, so the variable nodes only move.
+    for (int i = 0; i < variableNodes_.size(); i++) {
+      variableNodes[variablePermutation_[i]] = variableNodes_[i];
+    }
+    for (auto& factorNode : factorNodes) {
+      factorNode = factorNode->getCopyWithRemappedVariableIds(
+        variablePermutation_);
+    }
+    for (auto& markovKernelNode : markovKernelNodes) {
+      markovKernelNode = markovKernelNode->getCopyWithRemappedVariableIds(
+        variablePermutation_);
+    }
+  }
+  auto dependenciesGraph = std::make_shared<DependenciesGraph>(
+    markovKernelNodes, variableNodes, factorNodes);
+  dependenciesGraph->setHubThreshold(hubThreshold_);
+  return dependenciesGraph;
+}
+
+template<class State, class Flow>
+auto PdmpBuilderBase<State, Flow>::build() {
+  auto args = std::make_tuple(getDependenciesGraph());
+  Pdmp<
     dependencies_graph::PoissonProcess<DependenciesGraph>,
     dependencies_graph::MarkovKernel<DependenciesGraph>,
-    Flow>(args, args);
+    Flow> pdmp(args, args);
+  if (numberOfResimulationThreads_ > 1) {
+    pdmp.setParallelResimulation(
+      numberOfResimulationThreads_, minimumNumberOfFactorsPerBatch_);
+  }
+  return pdmp;
+}
+
+template<class State, class Flow>
+std::shared_ptr<const typename PdmpBuilderBase<State, Flow>::Model>
+PdmpBuilderBase<State, Flow>::buildModel() {
+  for (int factorId = 0; factorId < nodeFactories_.size(); factorId++) {
+    if (!nodeFactories_[factorId]) {
+      throw std::logic_error(
+        "The nodes of factor " + std::to_string(factorId) + " were not added "
+        "by addFactorAndMarkovKernelNodes, so they can not be created for "
+        "the chains of a shared model.");
+    }
+  }
+  return std::make_shared<const Model>(
+    getDependenciesGraph(), nodeFactories_, variablePermutation_,
+    numberOfResimulationThreads_, minimumNumberOfFactorsPerBatch_);
+}
+
+template<class State, class Flow>
+dependencies_graph::PartitionedPdmp<
+  typename PdmpBuilderBase<State, Flow>::DependenciesGraph, State, Flow>
+PdmpBuilderBase<State, Flow>::buildPartitioned(int numberOfPartitions) {
+  return dependencies_graph::PartitionedPdmp<DependenciesGraph, State, Flow>(
+    getDependenciesGraph(), numberOfPartitions);
 }
 
 }
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/pdmp.h"
+#include "core/policies/markov_kernel.h"
+#include "core/policies/poisson_process.h"
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * An immutable model built by a PdmpBuilderBase, from which the PDMPs of
+ * many chains can be created, e.g. on different threads. The dependencies
+ * graph structure (the variable nodes and the dependencies of the
+ * factors) and the parameters captured by the node factories are shared by
+ * all the chains. Each chain owns only its state, its event queue and its
+ * factor and Markov kernel nodes, whose lambdas hold its random number
+ * generators and thinning caches.
+ */
+template<class State, class Flow, class DependenciesGraph>
+class PdmpModel {
+
+ public:
+
+  using FactorNodePtr = typename DependenciesGraph::FactorNodes::value_type;
+  using MarkovKernelNodePtr =
+    typename DependenciesGraph::MarkovKernelNodes::value_type;
+
+  /**
+   * Creates the factor node and the Markov kernel node of a factor id, with
+   * fresh lambdas.
+   */
+  using NodeFactory =
+    std::function<std::pair<FactorNodePtr, MarkovKernelNodePtr>()>;
+
+  using Chain = Pdmp<
+    dependencies_graph::PoissonProcess<DependenciesGraph>,
+    dependencies_graph::MarkovKernel<DependenciesGraph>,
+    Flow>;
+
+  /**
+   * @param dependenciesGraph
+   *   The graph of the model, whose factor dependencies are cached here.
+   * @param nodeFactories
+   *   The node factory of each factor id.
+   * @param variablePermutation
+   *   The internal id of each variable, to which the nodes created by the
+   *   factories are remapped.
+   * @param numberOfResimulationThreads
+   * @param minimumNumberOfFactorsPerBatch
+   *   The parallel resimulation settings of the chains (see
+   *   dependencies_graph::PoissonProcess::setParallelResimulation).
+   */
+  PdmpModel(
+    std::shared_ptr<DependenciesGraph> dependenciesGraph,
+    std::vector<NodeFactory> nodeFactories,
+    std::vector<int> variablePermutation,
+    int numberOfResimulationThreads,
+    int minimumNumberOfFactorsPerBatch);
+
+  /**
+   * Returns the PDMP of a new chain of the model. The lambdas of its nodes
+   * draw their random number generators as seeded by ScopedRngSeed(seed),
+   * so chains created with the same seed simulate the same trajectory.
+   * Can be called concurrently.
+   */
+  Chain createChain(std::uint64_t seed) const;
+
+  int getNumberOfFactors() const;
+
+  /**
+   * Returns the internal id of each variable of the chains, indexed by the
+   * user-facing variable id (see PdmpBuilderBase::setVariableOrdering).
+   */
+  const std::vector<int>& getVariablePermutation() const;
+
+ private:
+
+  const std::shared_ptr<DependenciesGraph> dependenciesGraph_;
+  const std::vector<NodeFactory> nodeFactories_;
+  const std::vector<int> variablePermutation_;
+  const bool isReordered_;
+  const int numberOfResimulationThreads_;
+  const int minimumNumberOfFactorsPerBatch_;
+
+};
+
+}
+}
+
+#include "pdmp_model.tcc"
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "mcmc/utils.h"
+
+namespace pdmp {
+namespace mcmc {
+
+namespace {
+
+bool isIdentityPermutation(const std::vector<int>& permutation) {
+  for (int i = 0; i < permutation.size(); i++) {
+    if (permutation[i] != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+template<class State, class Flow, class DependenciesGraph>
+PdmpModel<State, Flow, DependenciesGraph>::PdmpModel(
+  std::shared_ptr<DependenciesGraph> dependenciesGraph,
+  std::vector<NodeFactory> nodeFactories,
+  std::vector<int> variablePermutation,
+  int numberOfResimulationThreads,
+  int minimumNumberOfFactorsPerBatch)
+  : dependenciesGraph_(std::move(dependenciesGraph)),
+    nodeFactories_(std::move(nodeFactories)),
+    variablePermutation_(std::move(variablePermutation)),
+    isReordered_(!isIdentityPermutation(variablePermutation_)),
+    numberOfResimulationThreads_(numberOfResimulationThreads),
+    minimumNumberOfFactorsPerBatch_(minimumNumberOfFactorsPerBatch) {
+
+  if (nodeFactories_.size() != dependenciesGraph_->factorNodes.size()) {
+    throw std::invalid_argument(
+      "The model has " + std::to_string(dependenciesGraph_->factorNodes.size())
+      + " factors, but " + std::to_string(nodeFactories_.size())
+      + " node factories were given.");
+  }
+  // The chains only read the shared cache afterwards.
+  dependenciesGraph_->template cacheAllFactorDependencies<Flow>();
+}
+
+template<class State, class Flow, class DependenciesGraph>
+typename PdmpModel<State, Flow, DependenciesGraph>::Chain
+PdmpModel<State, Flow, DependenciesGraph>::createChain(
+  std::uint64_t seed) const {
+
+  typename DependenciesGraph::FactorNodes factorNodes;
+  typename DependenciesGraph::MarkovKernelNodes markovKernelNodes;
+  factorNodes.reserve(nodeFactories_.size());
+  markovKernelNodes.reserve(nodeFactories_.size());
+  {
+    ScopedRngSeed rngSeed(seed);
+    for (const auto& nodeFactory : nodeFactories_) {
+      FactorNodePtr factorNode;
+      MarkovKernelNodePtr markovKernelNode;
+      std::tie(factorNode, markovKernelNode) = nodeFactory();
+      if (isReordered_) {
+        factorNode =
+          factorNode->getCopyWithRemappedVariableIds(variablePermutation_);
+        markovKernelNode = markovKernelNode->getCopyWithRemappedVariableIds(
+          variablePermutation_);
+      }
+      factorNodes.push_back(std::move(factorNode));
+      markovKernelNodes.push_back(std::move(markovKernelNode));
+    }
+  }
+  auto args = std::make_tuple(std::make_shared<DependenciesGraph>(
+    *dependenciesGraph_, markovKernelNodes, factorNodes));
+  Chain chain(args, args);
+  if (numberOfResimulationThreads_ > 1) {
+    chain.setParallelResimulation(
+      numberOfResimulationThreads_, minimumNumberOfFactorsPerBatch_);
+  }
+  return chain;
+}
+
+template<class State, class Flow, class DependenciesGraph>
+int PdmpModel<State, Flow, DependenciesGraph>::getNumberOfFactors() const {
+  return nodeFactories_.size();
+}
+
+template<class State, class Flow, class DependenciesGraph>
+const std::vector<int>&
+PdmpModel<State, Flow, DependenciesGraph>::getVariablePermutation() const {
+  return variablePermutation_;
+}
+
+}
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <memory>
+
+#include <Eigen/Core>
+
+#include "core/policies/poisson_process.h"
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * Holds the energy gradient estimate used by the last accepted event of a
+ * data-sum factor, so that the associated Markov kernel bounces with
+ * exactly the same estimate which fired the event.
+ */
+struct GradientEstimateCache {
+  Eigen::Matrix<double, Eigen::Dynamic, 1> energyGradient;
+};
+
+/**
+ * A factor representing a potential of the form U(x) = sum_j U_j(x), where
+ * each term U_j is associated with a single datum (e.g. the negative
+ * log-likelihood of the j-th observation).
+ *
+ * Event times are simulated by thinning a single uniformly chosen datum J,
+ * using the control variate gradient estimate
+ *   G_J(x) = grad U(x*) + N * (grad U_J(x) - grad U_J(x*)),
+ * around a fixed reference point x* (ideally close to a posterior mode).
+ * The gradient at the reference point and the dominating Poisson process
+ * bound are precomputed once during construction, so each simulated
+ * event costs O(1) in the number of data points N.
+ *
+ * The data is not copied: it is accessed through a column-major map, where
+ * the j-th column holds the j-th datum. The caller is responsible for
+ * keeping the underlying storage alive while the factor is in use.
+ */
+template<class DatumEnergyGradient>
+class DataSumFactor {
+
+ public:
+
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+  using DataMatrix = Eigen::Map<const RealMatrix>;
+
+  /**
+   * @param data
+   *   A matrix holding one datum per column.
+   * @param datumEnergyGradient
+   *   A callable object, which given a position and a datum (column of the
+   *   data matrix) returns the gradient of U_j at that position.
+   * @param datumLipschitzConstant
+   *   A callable object, which given a datum returns the Lipschitz constant
+   *   of the gradient of U_j (with respect to the Euclidean norm).
+   * @param referencePoint
+   *   The reference point x* of the control variates.
+   */
+  template<class DatumLipschitzConstant>
+  DataSumFactor(
+    const DataMatrix& data,
+    const DatumEnergyGradient& datumEnergyGradient,
+    const DatumLipschitzConstant& datumLipschitzConstant,
+    const RealVector& referencePoint);
+
+  /**
+   * Returns the control variate estimate of the energy gradient at the
+   * given position, using the datum with the given index.
+   */
+  RealVector getEnergyGradientEstimate(
+    const RealVector& position, int datumIndex) const;
+
+  /**
+   * Returns the exact energy gradient at the reference point.
+   */
+  const RealVector& getReferenceEnergyGradient() const;
+
+  /**
+   * Returns the number of data points in this factor.
+   */
+  int getNumberOfData() const;
+
+  /**
+   * Returns a Poisson process strategy for the Bouncy Particle Sampler,
+   * whose intensity is the positive part of <v, G_J(x + vt)>.
+   * Accepted estimates are stored in the given cache.
+   */
+  template<class Flow>
+  auto getBpsPoissonProcessStrategy(
+    std::shared_ptr<GradientEstimateCache> cache) const;
+
+  /**
+   * Returns a Poisson process strategy for the Zig-Zag sampler, whose
+   * intensity is sum_i max(0, v_i * G_J(x + vt)_i).
+   * Accepted estimates are stored in the given cache.
+   */
+  template<class Flow>
+  auto getZigZagPoissonProcessStrategy(
+    std::shared_ptr<GradientEstimateCache> cache) const;
+
+ private:
+
+  // Returns a thinning strategy for the given intensity, which takes
+  // a velocity and a gradient estimate. Both BPS and Zig-Zag intensities
+  // are dominated by intensity(v, grad U(x*)) + N * L * |v| * |x + vt - x*|.
+  template<class Intensity>
+  auto getThinningStrategy(
+    std::shared_ptr<GradientEstimateCache> cache,
+    const Intensity& intensity) const;
+
+  DataMatrix data_;
+  DatumEnergyGradient datumEnergyGradient_;
+  RealVector referencePoint_;
+  RealVector referenceEnergyGradient_;
+
+  // The maximal Lipschitz constant over all data terms.
+  double lipschitzConstant_;
+};
+
+/**
+ * A helper for creating data-sum factors without specifying the gradient
+ * functor type explicitly.
+ */
+template<class DatumEnergyGradient, class DatumLipschitzConstant>
+auto makeDataSumFactor(
+  const typename DataSumFactor<DatumEnergyGradient>::DataMatrix& data,
+  const DatumEnergyGradient& datumEnergyGradient,
+  const DatumLipschitzConstant& datumLipschitzConstant,
+  const typename DataSumFactor<DatumEnergyGradient>::RealVector&
+    referencePoint);
+
+}
+}
+
+#include "data_sum_factor.tcc"
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <stan/math/prim/scal.hpp>
+
+#include "mcmc/utils.h"
+
+namespace pdmp {
+namespace mcmc {
+
+template<class DatumEnergyGradient>
+template<class DatumLipschitzConstant>
+DataSumFactor<DatumEnergyGradient>::DataSumFactor(
+  const DataMatrix& data,
+  const DatumEnergyGradient& datumEnergyGradient,
+  const DatumLipschitzConstant& datumLipschitzConstant,
+  const RealVector& referencePoint)
+  : data_(data),
+    datumEnergyGradient_(datumEnergyGradient),
+    referencePoint_(referencePoint),
+    referenceEnergyGradient_(RealVector::Zero(referencePoint.size())),
+    lipschitzConstant_(0.0) {
+
+  if (data.cols() == 0) {
+    throw std::invalid_argument(
+      "A data-sum factor needs to be constructed with at least one datum.");
+  }
+
+  // Precompute the exact gradient at the reference point and the maximal
+  // Lipschitz constant. This is the only place where we loop over all data.
+  for (int j = 0; j < data_.cols(); j++) {
+    referenceEnergyGradient_ += datumEnergyGradient_(
+      referencePoint_, data_.col(j));
+    lipschitzConstant_ = std::max(
+      lipschitzConstant_, (double) datumLipschitzConstant(data_.col(j)));
+  }
+}
+
+template<class DatumEnergyGradient>
+typename DataSumFactor<DatumEnergyGradient>::RealVector
+DataSumFactor<DatumEnergyGradient>::getEnergyGradientEstimate(
+  const RealVector& position, int datumIndex) const {
+
+  const int N = data_.cols();
+  RealVector estimate = referenceEnergyGradient_
+    + N * (datumEnergyGradient_(position, data_.col(datumIndex))
+           - datumEnergyGradient_(referencePoint_, data_.col(datumIndex)));
+  return estimate;
+}
+
+template<class DatumEnergyGradient>
+const typename DataSumFactor<DatumEnergyGradient>::RealVector&
+DataSumFactor<DatumEnergyGradient>::getReferenceEnergyGradient() const {
+  return referenceEnergyGradient_;
+}
+
+template<class DatumEnergyGradient>
+int DataSumFactor<DatumEnergyGradient>::getNumberOfData() const {
+  return data_.cols();
+}
+
+template<class DatumEnergyGradient>
+template<class Flow>
+auto DataSumFactor<DatumEnergyGradient>::getBpsPoissonProcessStrategy(
+  std::shared_ptr<GradientEstimateCache> cache) const {
+
+  auto intensity = [] (const RealVector& velocity, const RealVector& gradient) {
+    return std::max(0.0, velocity.dot(gradient));
+  };
+  return getThinningStrategy(cache, intensity);
+}
+
+template<class DatumEnergyGradient>
+template<class Flow>
+auto DataSumFactor<DatumEnergyGradient>::getZigZagPoissonProcessStrategy(
+  std::shared_ptr<GradientEstimateCache> cache) const {
+
+  auto intensity = [] (const RealVector& velocity, const RealVector& gradient) {
+    return velocity.cwiseProduct(gradient).cwiseMax(0.0).sum();
+  };
+  return getThinningStrategy(cache, intensity);
+}
+
+template<class DatumEnergyGradient>
+template<class Intensity>
+auto DataSumFactor<DatumEnergyGradient>::getThinningStrategy(
+  std::shared_ptr<GradientEstimateCache> cache,
+  const Intensity& intensity) const {
+
+  auto rng = getRng();
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  std::uniform_int_distribution<int> datumSampler(0, data_.cols() - 1);
+  const double scaledLipschitzConstant = data_.cols() * lipschitzConstant_;
+  auto factor = std::make_shared<const DataSumFactor>(*this);
+
+  auto strategy =
+    [rng, unif, datumSampler, scaledLipschitzConstant, factor, cache, intensity]
+    (const auto& state, const auto&, const auto&) mutable {
+      if (state.size() % 2 != 0) {
+        throw std::runtime_error(
+          "Data-sum factor poisson process strategy was invoked on a vector "
+          "of odd size " + std::to_string(state.size()) + ".");
+      }
+      RealVector position = state.head(state.size() / 2);
+      RealVector velocity = state.tail(state.size() / 2);
+
+      // The dominating intensity is a + b * t, which we invert exactly.
+      const double velocityNorm = velocity.norm();
+      const double a = intensity(velocity, factor->referenceEnergyGradient_)
+        + scaledLipschitzConstant * velocityNorm
+          * (position - factor->referencePoint_).norm();
+      const double b = scaledLipschitzConstant * velocityNorm * velocityNorm;
+      const double exponential = stan::math::exponential_rng(1.0, rng);
+      const double time = getAffineIntensityJumpTime(a, b, exponential);
+
+      // The datum and the uniform variable for thinning are independent of
+      // the proposed time, so we sample them now.
+      const int datumIndex = datumSampler(rng);
+      const double u = unif(rng);
+      const double bound = a + b * time;
+      auto thinningStep =
+        [factor, cache, intensity, position, velocity, time, datumIndex, u,
+         bound] () {
+          RealVector proposedPosition = position + velocity * time;
+          RealVector estimate = factor->getEnergyGradientEstimate(
+            proposedPosition, datumIndex);
+          if (u * bound < intensity(velocity, estimate)) {
+            cache->energyGradient = std::move(estimate);
+            return true;
+          }
+          return false;
+        };
+      std::shared_ptr<dependencies_graph::PoissonProcessResultBase> result =
+        std::make_shared<dependencies_graph::PoissonProcessResult<
+          decltype(thinningStep)>>(time, thinningStep);
+      return result;
+    };
+  return strategy;
+}
+
+template<class DatumEnergyGradient, class DatumLipschitzConstant>
+auto makeDataSumFactor(
+  const typename DataSumFactor<DatumEnergyGradient>::DataMatrix& data,
+  const DatumEnergyGradient& datumEnergyGradient,
+  const DatumLipschitzConstant& datumLipschitzConstant,
+  const typename DataSumFactor<DatumEnergyGradient>::RealVector&
+    referencePoint) {
+
+  return DataSumFactor<DatumEnergyGradient>(
+    data, datumEnergyGradient, datumLipschitzConstant, referencePoint);
+}
+
+}
+}
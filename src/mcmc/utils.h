@@ -1,6 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
+#include <utility>
+#include <vector>
+
+#include "core/thread_pool.h"
 
 namespace pdmp {
 namespace mcmc {
@@ -10,6 +15,78 @@ namespace mcmc {
  */
 std::mt19937_64 getRng();
 
+/**
+ * While an object of this class exists, getRng() called on the same thread
+ * returns engines seeded in sequence from the given seed, instead of by a
+ * random device. This makes the models built on the thread reproducible,
+ * e.g. in the chains of a ParallelChainRunner.
+ */
+class ScopedRngSeed {
+
+ public:
+
+  explicit ScopedRngSeed(std::uint64_t seed);
+
+  ~ScopedRngSeed();
+
+  ScopedRngSeed(const ScopedRngSeed&) = delete;
+  ScopedRngSeed& operator=(const ScopedRngSeed&) = delete;
+
+ private:
+
+  std::mt19937_64 seeds_;
+  std::mt19937_64* previousSeeds_;
+
+};
+
+/**
+ * Returns the first event time of a Poisson process with intensity
+ * max(0, a + b * t), by exactly inverting the integrated intensity at the
+ * given Exp(1) random variable.
+ * Returns infinity if there is no event, e.g. if the intensity is
+ * identically zero, or decreases to zero before the integral reaches the
+ * exponential variable.
+ */
+double getAffineIntensityJumpTime(double a, double b, double exponential);
+
+/**
+ * Returns the first event time of a Poisson process with a piecewise
+ * constant, non-decreasing intensity, by exactly inverting the integrated
+ * intensity at the given Exp(1) random variable. The intensity equals
+ * initialIntensity at time 0 and increases by the given increment at each
+ * (time, increment) breakpoint. Negative intensities are treated as zero.
+ * Returns infinity if the intensity stays zero.
+ */
+double getPiecewiseConstantIntensityJumpTime(
+  double initialIntensity,
+  std::vector<std::pair<double, double>> breakpoints,
+  double exponential);
+
+/**
+ * Returns the sum of partialSum(begin, end) over the consecutive ranges of
+ * [0, numberOfTerms) with chunkSize terms (the last one possibly fewer),
+ * e.g. the partial gradients of chunks of observations. The ranges are
+ * summed on the threads of the given pool, and the partial sums are added
+ * in the order of the ranges, so the result does not depend on the number
+ * of threads.
+ */
+template<class PartialSum>
+auto getSumOfChunksInParallel(
+  const PartialSum& partialSum, int numberOfTerms, int chunkSize,
+  ThreadPool& threadPool);
+
+/**
+ * Returns the Poisson process strategy of a factor of the tempered target
+ * pi^beta, given the strategy of the factor of pi and the inverse
+ * temperature beta in (0, 1]. Each event of the given strategy is thinned
+ * once more with probability beta, so the intensity is scaled by beta; the
+ * bounce and flip kernels do not depend on the scale of the gradient, and
+ * can be kept as they are. For beta = 1 the events are passed through,
+ * and no random engine is taken from getRng().
+ */
+template<class Strategy>
+auto getTemperedStrategy(const Strategy& strategy, double inverseTemperature);
+
 /**
  * Returns a gradient functor of a given functor.
  */
@@ -2,17 +2,152 @@
 
 #include <Eigen/Core>
 #include <stan/math/rev/mat.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "core/policies/poisson_process.h"
 
 namespace pdmp {
 namespace mcmc {
 
+namespace {
+
+// The seeds of the innermost ScopedRngSeed of the thread, if any.
+thread_local std::mt19937_64* threadRngSeeds = nullptr;
+
+}
+
 std::mt19937_64 getRng() {
+  if (threadRngSeeds) {
+    return std::mt19937_64((*threadRngSeeds)());
+  }
   std::random_device rd;
   std::mt19937_64 rng(rd());
   return rng;
 }
 
+ScopedRngSeed::ScopedRngSeed(std::uint64_t seed)
+  : seeds_(seed), previousSeeds_(threadRngSeeds) {
+
+  threadRngSeeds = &seeds_;
+}
+
+ScopedRngSeed::~ScopedRngSeed() {
+  threadRngSeeds = previousSeeds_;
+}
+
+double getAffineIntensityJumpTime(double a, double b, double exponential) {
+  if (b == 0.0) {
+    return a > 0.0 ? exponential / a : std::numeric_limits<double>::infinity();
+  }
+  if (b < 0.0) {
+    // The intensity vanishes after time -a / b, having integrated to
+    // a^2 / (-2b).
+    if (a <= 0.0 || exponential >= a * a / (-2.0 * b)) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return (a - sqrt(a * a + 2.0 * b * exponential)) / (-b);
+  }
+  if (a >= 0.0) {
+    return (-a + sqrt(a * a + 2.0 * b * exponential)) / b;
+  }
+  // The intensity is zero until time -a / b.
+  return -a / b + sqrt(2.0 * exponential / b);
+}
+
+double getPiecewiseConstantIntensityJumpTime(
+  double initialIntensity,
+  std::vector<std::pair<double, double>> breakpoints,
+  double exponential) {
+
+  std::sort(breakpoints.begin(), breakpoints.end());
+  double intensity = initialIntensity;
+  double time = 0.0;
+  for (const auto& breakpoint : breakpoints) {
+    if (intensity > 0.0) {
+      const double segmentIntegral = intensity * (breakpoint.first - time);
+      if (segmentIntegral >= exponential) {
+        return time + exponential / intensity;
+      }
+      exponential -= segmentIntegral;
+    }
+    time = breakpoint.first;
+    intensity += breakpoint.second;
+  }
+  return intensity > 0.0 ? time + exponential / intensity
+                         : std::numeric_limits<double>::infinity();
+}
+
+template<class PartialSum>
+auto getSumOfChunksInParallel(
+  const PartialSum& partialSum, int numberOfTerms, int chunkSize,
+  ThreadPool& threadPool) {
+
+  using Sum = std::decay_t<decltype(partialSum(0, 0))>;
+  const int numberOfChunks =
+    std::max(1, (numberOfTerms + chunkSize - 1) / chunkSize);
+  // Each chunk writes its own partial sum, so no locking is needed.
+  std::vector<Sum> partialSums(numberOfChunks);
+  threadPool.parallelFor(
+    numberOfChunks,
+    [&partialSum, &partialSums, numberOfTerms, chunkSize] (int i) {
+      const int begin = i * chunkSize;
+      partialSums[i] =
+        partialSum(begin, std::min(numberOfTerms, begin + chunkSize));
+    });
+  Sum sum = partialSums[0];
+  for (int i = 1; i < numberOfChunks; i++) {
+    sum += partialSums[i];
+  }
+  return sum;
+}
+
+template<class Strategy>
+auto getTemperedStrategy(const Strategy& strategy, double inverseTemperature) {
+  if (!(inverseTemperature > 0.0 && inverseTemperature <= 1.0)) {
+    throw std::invalid_argument(
+      "Inverse temperature should be in (0, 1], but is "
+      + std::to_string(inverseTemperature) + ".");
+  }
+  // A small engine suffices for the extra thinning, and keeps the factors
+  // of untempered models as they were.
+  std::minstd_rand rng(inverseTemperature < 1.0 ? getRng()() : 1u);
+
+  // The strategy is copied by value without the const of the reference, as
+  // strategies with random engines are mutable.
+  auto temperedStrategy =
+    [strategy = strategy, inverseTemperature, rng] (
+        const auto& stateSubvector, auto& factorNode, const auto& state)
+        mutable {
+      std::shared_ptr<dependencies_graph::PoissonProcessResultBase> result =
+        strategy(stateSubvector, factorNode, state);
+      if (inverseTemperature == 1.0) {
+        return result;
+      }
+      std::uniform_real_distribution<double> unif(0.0, 1.0);
+      const bool isKept = unif(rng) < inverseTemperature;
+      // The given strategy's own thinning is only run for the kept events,
+      // as it may be expensive or update caches read by the kernels.
+      auto thinningStep = [result, isKept] () {
+        return isKept && result->shouldAccept();
+      };
+      std::shared_ptr<dependencies_graph::PoissonProcessResultBase>
+        temperedResult = std::make_shared<
+          dependencies_graph::PoissonProcessResult<decltype(thinningStep)>>(
+            result->time, thinningStep);
+      return temperedResult;
+    };
+
+  return temperedStrategy;
+}
+
 std::mutex stanGradientMutex;
 
 template<class F>
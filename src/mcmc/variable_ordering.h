@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+namespace pdmp {
+namespace mcmc {
+
+/**
+ * The orderings, in which the builders can lay out the model variables in
+ * the state vector.
+ */
+enum class VariableOrdering {
+  // Keeps the variable ids given by the user.
+  AsAdded,
+  // Renumbers the variables with the reverse Cuthill-McKee ordering of the
+  // factor graph, so that variables sharing factors lie close to each other.
+  ReverseCuthillMcKee
+};
+
+// The largest clique, whose variables getAdjacencyLists connects pairwise.
+const int kMaxExpandedCliqueSize = 64;
+
+/**
+ * Returns the adjacency lists of the graph, in which two of the
+ * numberOfVariables variables are neighbours if they appear together in one
+ * of the given cliques (e.g. the variable ids of the factors). The variables
+ * of a clique larger than maxExpandedCliqueSize (e.g. of a global factor)
+ * are only connected to its first variable instead, so that the graph stays
+ * linear in the size of the cliques.
+ */
+std::vector<std::vector<int>> getAdjacencyLists(
+  const std::vector<std::vector<int>>& cliques,
+  int numberOfVariables,
+  int maxExpandedCliqueSize = kMaxExpandedCliqueSize);
+
+/**
+ * Returns the reverse Cuthill-McKee ordering of a graph given by its
+ * adjacency lists, as a permutation mapping each old vertex id to its new
+ * id. Each connected component is numbered by a breadth-first search from a
+ * pseudo-peripheral vertex (found as by George and Liu), visiting
+ * neighbours by increasing degree, which keeps the bandwidth of the
+ * renumbered adjacency matrix small. The running time is linear in the
+ * size of the graph for a bounded number of root search steps.
+ */
+std::vector<int> getReverseCuthillMcKeePermutation(
+  const std::vector<std::vector<int>>& adjacencyLists);
+
+/**
+ * Returns the bandwidth max |p(i) - p(j)| over the edges (i, j) of a graph
+ * renumbered with the given permutation.
+ */
+int getBandwidth(
+  const std::vector<std::vector<int>>& adjacencyLists,
+  const std::vector<int>& permutation);
+
+}
+}
+
+#include "variable_ordering.tcc"
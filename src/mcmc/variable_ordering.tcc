@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace pdmp {
+namespace mcmc {
+
+namespace {
+
+// Runs a breadth-first search within the component of the root vertex,
+// visiting the unvisited neighbours of each vertex by increasing degree.
+// Returns the visited vertices in order, and sets the first index of the
+// last level in that order. The levels of all the vertices should be -1, and
+// are reset to -1 afterwards, so that a search costs only the size of the
+// component.
+std::vector<int> getBreadthFirstOrder(
+  const std::vector<std::vector<int>>& adjacencyLists,
+  int root,
+  const std::vector<bool>& excluded,
+  std::vector<int>* levelsOfVertices,
+  int* depth,
+  int* lastLevelBegin) {
+
+  std::vector<int>& levels = *levelsOfVertices;
+  std::vector<int> order{root};
+  levels[root] = 0;
+  *lastLevelBegin = 0;
+  std::vector<int> neighbours;
+  for (int i = 0; i < order.size(); i++) {
+    const int vertex = order[i];
+    if (levels[vertex] > levels[order[*lastLevelBegin]]) {
+      *lastLevelBegin = i;
+    }
+    neighbours.clear();
+    for (int neighbour : adjacencyLists[vertex]) {
+      if (!excluded[neighbour] && levels[neighbour] < 0) {
+        levels[neighbour] = levels[vertex] + 1;
+        neighbours.push_back(neighbour);
+      }
+    }
+    std::stable_sort(
+      neighbours.begin(), neighbours.end(),
+      [&adjacencyLists] (int a, int b) {
+        return adjacencyLists[a].size() < adjacencyLists[b].size();
+      });
+    order.insert(order.end(), neighbours.begin(), neighbours.end());
+  }
+  *depth = levels[order.back()];
+  for (int vertex : order) {
+    levels[vertex] = -1;
+  }
+  return order;
+}
+
+}
+
+std::vector<std::vector<int>> getAdjacencyLists(
+  const std::vector<std::vector<int>>& cliques,
+  int numberOfVariables,
+  int maxExpandedCliqueSize) {
+
+  std::vector<std::vector<int>> adjacencyLists(numberOfVariables);
+  for (const auto& clique : cliques) {
+    for (int i : clique) {
+      if (i < 0 || i >= numberOfVariables) {
+        throw std::out_of_range(
+          "Variable id " + std::to_string(i) + " is out of range. Should be "
+          "0 <= id < " + std::to_string(numberOfVariables) + ".");
+      }
+    }
+    if (clique.size() > maxExpandedCliqueSize) {
+      // A star around the first variable keeps the clique connected.
+      for (int i : clique) {
+        if (i != clique[0]) {
+          adjacencyLists[clique[0]].push_back(i);
+          adjacencyLists[i].push_back(clique[0]);
+        }
+      }
+      continue;
+    }
+    for (int i : clique) {
+      for (int j : clique) {
+        if (i != j) {
+          adjacencyLists[i].push_back(j);
+        }
+      }
+    }
+  }
+  for (auto& neighbours : adjacencyLists) {
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(
+      std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+  }
+  return adjacencyLists;
+}
+
+std::vector<int> getReverseCuthillMcKeePermutation(
+  const std::vector<std::vector<int>>& adjacencyLists) {
+
+  const int numberOfVertices = adjacencyLists.size();
+  std::vector<bool> numbered(numberOfVertices, false);
+  std::vector<int> levels(numberOfVertices, -1);
+  std::vector<int> order;
+  order.reserve(numberOfVertices);
+  for (int start = 0; start < numberOfVertices; start++) {
+    if (numbered[start]) {
+      continue;
+    }
+    // Find a pseudo-peripheral root (George and Liu): starting from a vertex
+    // of minimal degree in the component, move to a vertex of minimal degree
+    // in the last level while the depth increases.
+    int depth, lastLevelBegin;
+    auto component = getBreadthFirstOrder(
+      adjacencyLists, start, numbered, &levels, &depth, &lastLevelBegin);
+    auto hasSmallerDegree = [&adjacencyLists] (int a, int b) {
+      return adjacencyLists[a].size() < adjacencyLists[b].size();
+    };
+    int root = *std::min_element(
+      component.begin(), component.end(), hasSmallerDegree);
+    component = getBreadthFirstOrder(
+      adjacencyLists, root, numbered, &levels, &depth, &lastLevelBegin);
+    while (true) {
+      const int candidate = *std::min_element(
+        component.begin() + lastLevelBegin, component.end(), hasSmallerDegree);
+      int candidateDepth, candidateLastLevelBegin;
+      auto candidateComponent = getBreadthFirstOrder(
+        adjacencyLists, candidate, numbered, &levels,
+        &candidateDepth, &candidateLastLevelBegin);
+      if (candidateDepth <= depth) {
+        break;
+      }
+      depth = candidateDepth;
+      lastLevelBegin = candidateLastLevelBegin;
+      component = std::move(candidateComponent);
+    }
+    for (int vertex : component) {
+      numbered[vertex] = true;
+    }
+    order.insert(order.end(), component.begin(), component.end());
+  }
+
+  std::vector<int> permutation(numberOfVertices);
+  for (int i = 0; i < numberOfVertices; i++) {
+    permutation[order[i]] = numberOfVertices - 1 - i;
+  }
+  return permutation;
+}
+
+int getBandwidth(
+  const std::vector<std::vector<int>>& adjacencyLists,
+  const std::vector<int>& permutation) {
+
+  int bandwidth = 0;
+  for (int i = 0; i < adjacencyLists.size(); i++) {
+    for (int j : adjacencyLists[i]) {
+      bandwidth = std::max(
+        bandwidth, std::abs(permutation.at(i) - permutation.at(j)));
+    }
+  }
+  return bandwidth;
+}
+
+}
+}
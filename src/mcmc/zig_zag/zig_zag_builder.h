@@ -1,9 +1,10 @@
 #pragma once
 
-#include "core/policies/linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
 #include "core/state_space/position_and_velocity_state.h"
 #include "mcmc/pdmp_builder_base.h"
 #include "mcmc/distributions/distribution_base.h"
+#include "mcmc/subsampling/data_sum_factor.h"
 
 namespace pdmp {
 namespace mcmc {
@@ -11,7 +12,7 @@ namespace mcmc {
 namespace zig_zag {
 
 using State = DynamicPositionAndVelocityState<double>;
-using Flow = LinearFlow;
+using Flow = ZigZagFlow;
 
 }
 
@@ -42,15 +43,98 @@ class ZigZagBuilder : protected PdmpBuilderBase<zig_zag::State, zig_zag::Flow> {
     const std::vector<int>& variableIds,
     const DistributionBase<Distribution>& distribution);
 
+  /**
+   * Adds a data-sum factor, acting on the specified model variables.
+   * The flipped coordinate is chosen using the same control variate
+   * gradient estimate which triggered the event.
+   *
+   * @param Ids
+   *   The variable ids (indexed from 0), on which this factor depends.
+   * @param dataSumFactor
+   *   The subsampled factor we are adding.
+   */
+  template<class DatumEnergyGradient>
+  void addFactor(
+    const std::vector<int>& variableIds,
+    const DataSumFactor<DatumEnergyGradient>& dataSumFactor);
+
+  /**
+   * Makes the specified model variables sticky at zero, i.e. adds a spike at
+   * zero to their distribution, so that the target becomes
+   *   pi(x) prod_i (dx_i + delta_0(dx_i) / stickiness).
+   * For a spike-and-slab prior (1 - w) delta_0 + w p_slab, the slab should be
+   * added as a factor and the stickiness should be w p_slab(0) / (1 - w).
+   *
+   * A sticky coordinate moves with unit speed, as in the standard Zig-Zag.
+   * Hitting zero, it is frozen (its velocity is set to a zero with the sign
+   * of the velocity) for an exponential time with rate stickiness, after
+   * which it continues with the velocity of that sign. The state thus
+   * determines how a frozen coordinate is unfrozen, e.g. after a restart
+   * or a ParallelTempering swap, and a zero initial velocity starts frozen
+   * with the positive direction. The freezing and unfreezing events are
+   * handled by a factor and Markov kernel pair each. A frozen coordinate
+   * generates no events and changes no variables, so in sparse regimes most
+   * factors are left untouched.
+   *
+   * @param Ids
+   *   The variable ids (indexed from 0), which should be sticky.
+   * @param stickiness
+   *   The rate of unfreezing per unit speed.
+   */
+  void addStickyCoordinates(
+    const std::vector<int>& variableIds, double stickiness);
+
+  /**
+   * Tempers the target factors added after the call, so that the built PDMP
+   * targets pi^beta for the given inverse temperature beta in (0, 1] (see
+   * getTemperedStrategy and ParallelTempering). The independent flipping
+   * and sticky coordinate factors are not tempered.
+   */
+  void setInverseTemperature(double inverseTemperature);
+
+  /**
+   * Optional renumbering of the model variables for cache locality, with the
+   * mapping of the states to and from the user-facing variable ids
+   * (see PdmpBuilderBase::setVariableOrdering).
+   */
+  using PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::setVariableOrdering;
+  using PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::getVariablePermutation;
+  using PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::getInternalState;
+  using PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::getUserState;
+
+  /**
+   * Special handling of the events modifying high-degree variables, and a
+   * report of the degrees and event costs (see
+   * PdmpBuilderBase::setHubThreshold).
+   */
+  using PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::setHubThreshold;
+  using PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::getFactorGraphReport;
+
+  /**
+   * Parallel resimulation of the factors affected by wide events (see
+   * PdmpBuilderBase::setParallelResimulation).
+   */
+  using PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::setParallelResimulation;
+
   /**
    * Returns the PDMP that can be used to simulated from the constructed
    * probability model.
    */
   auto build();
 
+  /**
+   * Returns a parallel simulator of the PDMP, with the model variables split
+   * into the given number of partitions (see
+   * PdmpBuilderBase::buildPartitioned). Throws std::logic_error if sticky
+   * coordinates were added.
+   */
+  auto buildPartitioned(int numberOfPartitions);
+
  private:
 
   int numberOfModelVariables_;
+  bool hasStickyCoordinates_{false};
+  double inverseTemperature_{1.0};
 
 };
 
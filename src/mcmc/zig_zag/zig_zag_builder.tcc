@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <stdexcept>
+#include <string>
 
 #include <Eigen/Core>
 
@@ -35,7 +38,9 @@ auto flipPredeterminedVariable = [] (const auto& state) {
         "a state with size " + std::to_string(state.size()) + " but the size "
         "should be 1.");
   }
-  decltype(state) flipped = -1.0 * state;
+  // A frozen coordinate keeps the sign of its zero velocity, with which it
+  // is unfrozen (see getUnstickingKernel).
+  decltype(state) flipped = state(0) == 0.0 ? state : -1.0 * state;
   return flipped;
 };
 
@@ -54,13 +59,13 @@ auto getFlipKernel(const F& energyGradient) {
       double gradientPositivePartSum = 0.0;
       for (int i = 0; i < gradient.size(); i++) {
         gradientPositivePartSum += std::max(
-          0.0, (double) gradient(i) * (double) state(i));
+          0.0, (double) gradient(i) * (double) velocity(i));
       }
       double U = stan::math::uniform_rng(0.0, 1.0, rng);
       int flipIndex = 0;
       for (flipIndex = 0; flipIndex < gradient.size(); flipIndex++) {
         U -= (1.0 / gradientPositivePartSum) * std::max(
-              0.0, (double) gradient(flipIndex) * (double) state(flipIndex));
+              0.0, (double) gradient(flipIndex) * (double) velocity(flipIndex));
         if (U <= 0) {
           break;
         }
@@ -74,6 +79,59 @@ auto getFlipKernel(const F& energyGradient) {
   return flipKernel;
 }
 
+// Simulates the time when the coordinate hits zero, given its position and
+// velocity. Coordinates at zero are either frozen or leaving it.
+auto getStickingStrategy() {
+  auto stickingStrategy = [] (const auto& state, const auto&, const auto&) {
+    const double position = state(0);
+    const double velocity = state(1);
+    return dependencies_graph::wrapPoissonProcessResult(
+      position * velocity < 0.0 ? -position / velocity
+                                : std::numeric_limits<double>::infinity());
+  };
+  return stickingStrategy;
+}
+
+// Freezes the coordinate at zero. The zero velocity keeps the sign of the
+// velocity, so that the state alone determines how it is unfrozen.
+auto getStickingKernel() {
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  auto stickingKernel = [] (const auto& state) {
+    RealVector stuck(2);
+    stuck << 0.0, std::copysign(0.0, static_cast<double>(state(1)));
+    return stuck;
+  };
+  return stickingKernel;
+}
+
+// Simulates the time when a frozen coordinate, given its velocity, is
+// unfrozen.
+auto getUnstickingStrategy(double stickiness) {
+  auto rng = getRng();
+  auto unstickingStrategy =
+    [rng, stickiness] (const auto& state, const auto&, const auto&) mutable {
+      if (state(0) != 0.0) {
+        return dependencies_graph::wrapPoissonProcessResult(
+          std::numeric_limits<double>::infinity());
+      }
+      return dependencies_graph::wrapPoissonProcessResult(
+        stan::math::exponential_rng(stickiness, rng));
+    };
+  return unstickingStrategy;
+}
+
+// Restores the unit velocity of a frozen coordinate, with the sign of its
+// zero velocity.
+auto getUnstickingKernel() {
+  using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+  auto unstickingKernel = [] (const auto& state) {
+    RealVector velocity = RealVector::Constant(
+      1, std::copysign(1.0, static_cast<double>(state(0))));
+    return velocity;
+  };
+  return unstickingKernel;
+}
+
 }
 
 namespace zig_zag {
@@ -120,6 +178,15 @@ ZigZagBuilder::ZigZagBuilder(int numberOfModelVariables)
   }
 }
 
+void ZigZagBuilder::setInverseTemperature(double inverseTemperature) {
+  if (!(inverseTemperature > 0.0 && inverseTemperature <= 1.0)) {
+    throw std::invalid_argument(
+      "Inverse temperature should be in (0, 1], but is "
+      + std::to_string(inverseTemperature) + ".");
+  }
+  inverseTemperature_ = inverseTemperature;
+}
+
 template<class Distribution>
 void ZigZagBuilder::addFactor(
     const std::vector<int>& variableIds,
@@ -133,16 +200,50 @@ void ZigZagBuilder::addFactor(
   const std::vector<int> variablesNeededByFactorNode =
     variablesNeededByFlipKernel;
 
-  auto logPdf = distribution.getLogPdf();
-  auto logProbGradient = getGradientOfAFunctor(logPdf);
+  auto logProbGradient = distribution.getLogPdfGradient();
   auto energy = [logProbGradient] (const auto& state) {
     auto logPrGrad = logProbGradient(state);
     decltype(logPrGrad) negated = logPrGrad * (-1.0);
     return negated;
   };
   auto flipKernel = getFlipKernel(energy);
-  auto poissonProcessStrategy = distribution.template getPoissonProcessStrategy<
-    zig_zag::Flow>();
+  auto poissonProcessStrategy = getTemperedStrategy(
+    distribution.template getPoissonProcessStrategy<zig_zag::Flow>(),
+    inverseTemperature_);
+
+  PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::addFactorNode(
+    variablesNeededByFactorNode, poissonProcessStrategy);
+  PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::addMarkovKernelNode(
+    variablesNeededByFlipKernel,
+    variablesToBeChangedByFlipKernel,
+    flipKernel);
+
+}
+
+template<class DatumEnergyGradient>
+void ZigZagBuilder::addFactor(
+    const std::vector<int>& variableIds,
+    const DataSumFactor<DatumEnergyGradient>& dataSumFactor) {
+
+  const std::vector<int> variablesNeededByFlipKernel =
+    zig_zag::getPositionAndVelocityVariables(
+      variableIds, this->numberOfModelVariables_);
+  const std::vector<int> variablesToBeChangedByFlipKernel =
+    zig_zag::getVelocityVariables(variableIds, this->numberOfModelVariables_);
+  const std::vector<int> variablesNeededByFactorNode =
+    variablesNeededByFlipKernel;
+
+  // The factor node stores the accepted gradient estimate in the cache, from
+  // which the flip kernel reads it.
+  auto cache = std::make_shared<GradientEstimateCache>();
+  auto energy = [cache] (const auto&) {
+    return cache->energyGradient;
+  };
+  auto flipKernel = getFlipKernel(energy);
+  auto poissonProcessStrategy = getTemperedStrategy(
+    dataSumFactor.template getZigZagPoissonProcessStrategy<zig_zag::Flow>(
+      cache),
+    inverseTemperature_);
 
   PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::addFactorNode(
     variablesNeededByFactorNode, poissonProcessStrategy);
@@ -150,12 +251,52 @@ void ZigZagBuilder::addFactor(
     variablesNeededByFlipKernel,
     variablesToBeChangedByFlipKernel,
     flipKernel);
+}
+
+void ZigZagBuilder::addStickyCoordinates(
+    const std::vector<int>& variableIds, double stickiness) {
+
+  if (!(stickiness > 0.0)) {
+    throw std::invalid_argument(
+      "Stickiness should be positive, but is " + std::to_string(stickiness)
+      + ".");
+  }
+  for (int variableId : variableIds) {
+    const std::vector<int> positionAndVelocity =
+      zig_zag::getPositionAndVelocityVariables(
+        {variableId}, this->numberOfModelVariables_);
+    const std::vector<int> velocity =
+      zig_zag::getVelocityVariables({variableId}, this->numberOfModelVariables_);
+
+    PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::addFactorNode(
+      positionAndVelocity, getStickingStrategy());
+    PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::addMarkovKernelNode(
+      positionAndVelocity,
+      positionAndVelocity,
+      getStickingKernel());
 
+    PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::addFactorNode(
+      velocity, getUnstickingStrategy(stickiness));
+    PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::addMarkovKernelNode(
+      velocity,
+      velocity,
+      getUnstickingKernel());
+  }
+  hasStickyCoordinates_ = true;
 }
 
 auto ZigZagBuilder::build() {
   return PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::build();
 }
 
+auto ZigZagBuilder::buildPartitioned(int numberOfPartitions) {
+  if (hasStickyCoordinates_) {
+    throw std::logic_error(
+      "Sticky coordinates are not supported by the partitioned simulator.");
+  }
+  return PdmpBuilderBase<zig_zag::State, zig_zag::Flow>::buildPartitioned(
+    numberOfPartitions);
+}
+
 }
 }
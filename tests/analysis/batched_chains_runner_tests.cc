@@ -0,0 +1,93 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include "analysis/batched_chains_runner.h"
+#include "analysis/output_processors/path_collector.h"
+#include "mcmc/bps/batched_gaussian_bps.h"
+
+using namespace pdmp;
+using namespace pdmp::analysis;
+using namespace pdmp::mcmc;
+using namespace testing;
+
+using State = BatchedGaussianBps::State;
+using RealVector = BatchedGaussianBps::RealVector;
+using RealMatrix = BatchedGaussianBps::RealMatrix;
+using Runner = BatchedChainsRunner<BatchedGaussianBps>;
+using Collector = PathCollector<BatchedGaussianBps, State>;
+
+struct MockBatchObserver : public ObserverBase<BatchedGaussianBps, State> {
+
+  MOCK_METHOD2(
+    notifyProcessBegins, void(const BatchedGaussianBps&, const State&));
+
+  MOCK_METHOD1(notifyIterationResult, void(const IterationResult<State>&));
+
+  MOCK_METHOD0(notifyProcessEnded, void());
+};
+
+namespace {
+
+GaussianDistribution getStandardGaussian() {
+  return GaussianDistribution(RealVector::Zero(2), RealMatrix::Identity(2, 2));
+}
+
+}
+
+TEST(BatchedChainsRunnerTests, TestObserversSeeTheTrajectoryOfTheirChain) {
+  BatchedGaussianBps batch(getStandardGaussian(), 1.0, 3, 11);
+  BatchedGaussianBps sameBatch(getStandardGaussian(), 1.0, 3, 11);
+  std::vector<std::vector<State>> expectedStates(3);
+  for (int k = 0; k < 3; k++) {
+    expectedStates[k].push_back(sameBatch.getState(k));
+  }
+  sameBatch.simulateIterations(
+    20,
+    [&] (int chainId, const IterationResult<State>& iterationResult) {
+      expectedStates[chainId].push_back(iterationResult.state);
+    });
+
+  Runner runner;
+  Collector firstCollector;
+  Collector lastCollector;
+  runner.registerAnObserver(0, &firstCollector);
+  runner.registerAnObserver(2, &lastCollector);
+  runner.run(batch, 20);
+
+  EXPECT_EQ(firstCollector.getCollectedStates(), expectedStates[0]);
+  EXPECT_EQ(lastCollector.getCollectedStates(), expectedStates[2]);
+}
+
+TEST(BatchedChainsRunnerTests, TestObserversAreNotifiedOfTheWholeProcess) {
+  BatchedGaussianBps batch(getStandardGaussian(), 1.0, 2, 3);
+  const State initialState = batch.getState(1);
+  MockBatchObserver observer;
+  {
+    InSequence sequence;
+    EXPECT_CALL(observer, notifyProcessBegins(Ref(batch), initialState))
+      .Times(1);
+    EXPECT_CALL(observer, notifyIterationResult(_)).Times(5);
+    EXPECT_CALL(observer, notifyProcessEnded()).Times(1);
+  }
+
+  Runner runner;
+  runner.registerAnObserver(1, &observer);
+  runner.run(batch, 5);
+}
+
+TEST(BatchedChainsRunnerTests, TestObserversOfMissingChainsThrowAnException) {
+  BatchedGaussianBps batch(getStandardGaussian(), 1.0, 2, 3);
+  Collector collector;
+  Runner runner;
+  EXPECT_THROW(runner.registerAnObserver(-1, &collector), std::out_of_range);
+  runner.registerAnObserver(2, &collector);
+  EXPECT_THROW(runner.run(batch, 5), std::out_of_range);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
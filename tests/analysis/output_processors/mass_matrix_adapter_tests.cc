@@ -0,0 +1,72 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "analysis/output_processors/mass_matrix_adapter.h"
+#include "core/pdmp.h"
+#include "core/state_space/position_and_velocity_state.h"
+
+#include "../mock_pdmp.h"
+
+using namespace pdmp;
+using namespace pdmp::analysis;
+
+using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+using PVState = PositionAndVelocityState<double, 4>;
+
+struct FakeMassMatrix {
+  void setInverse(const RealMatrix& inverseMassMatrix) {
+    inverse = inverseMassMatrix;
+    numberOfUpdates++;
+  }
+  RealMatrix inverse;
+  int numberOfUpdates = 0;
+};
+
+// The path x(t) = (t, 2t) on (0, 1), followed by x(t) = (1 - t, 2) on (0, 1).
+const auto kPath = std::vector<IterationResult<PVState>>{
+  IterationResult<PVState>{PVState{{0.0, 0.0}, {1.0, 2.0}}, 0.0},
+  IterationResult<PVState>{PVState{{1.0, 2.0}, {-1.0, 0.0}}, 1.0},
+  IterationResult<PVState>{PVState{{0.0, 2.0}, {1.0, 1.0}}, 1.0}
+};
+
+TEST(MassMatrixAdapterTests, TestCovarianceIsEstimatedFromThePath) {
+  auto massMatrix = std::make_shared<FakeMassMatrix>();
+  MassMatrixAdapter<MockPdmp, PVState, FakeMassMatrix> adapter(massMatrix, 1);
+  adapter.notifyProcessBegins(MockPdmp(), kPath[0].state);
+  adapter.notifyIterationResult(kPath[1]);
+
+  // For a single segment, mean = (1/2, 1) and E[x x^T] = [1/3 2/3; 2/3 4/3].
+  RealMatrix expectedCovariance(2, 2);
+  expectedCovariance << 1.0 / 12.0, 1.0 / 6.0, 1.0 / 6.0, 1.0 / 3.0;
+  EXPECT_TRUE(expectedCovariance.isApprox(adapter.estimateCovariance()));
+  EXPECT_EQ(1, massMatrix->numberOfUpdates);
+  RealMatrix expectedInverse =
+    expectedCovariance / 6.0 + 1e-3 * 5.0 / 6.0 * RealMatrix::Identity(2, 2);
+  EXPECT_TRUE(expectedInverse.isApprox(massMatrix->inverse));
+
+  // Over both segments, mean = (1/2, 3/2) and E[x x^T] = [1/3 5/6; 5/6 8/3].
+  adapter.notifyIterationResult(kPath[2]);
+  expectedCovariance << 1.0 / 12.0, 1.0 / 12.0, 1.0 / 12.0, 5.0 / 12.0;
+  EXPECT_TRUE(expectedCovariance.isApprox(adapter.estimateCovariance()));
+}
+
+TEST(MassMatrixAdapterTests, TestMassMatrixIsUpdatedWhenTheProcessEnds) {
+  auto massMatrix = std::make_shared<FakeMassMatrix>();
+  MassMatrixAdapter<MockPdmp, PVState, FakeMassMatrix> adapter(massMatrix);
+  adapter.notifyProcessBegins(MockPdmp(), kPath[0].state);
+  adapter.notifyIterationResult(kPath[1]);
+  adapter.notifyIterationResult(kPath[2]);
+  EXPECT_EQ(0, massMatrix->numberOfUpdates);
+  adapter.notifyProcessEnded();
+  EXPECT_EQ(1, massMatrix->numberOfUpdates);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,128 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "analysis/output_processors/refresh_rate_adapter.h"
+#include "core/pdmp.h"
+
+#include "output_processors_tests_utils.h"
+#include "../mock_pdmp.h"
+
+using namespace pdmp;
+using namespace pdmp::analysis;
+using namespace myutils;
+
+// The cost of simulating a window, which is minimised for a scale of 2.
+double currentScale = 1.0;
+double getWindowCostInSeconds(double scale) {
+  return 1.0 + pow(log(scale) - log(2.0), 2.0);
+}
+
+struct FakeController {
+  double getScale() const {
+    return currentScale;
+  }
+  void setScale(double scale) {
+    currentScale = scale;
+  }
+  void freeze() {
+    isFrozen = true;
+  }
+  bool isFrozen = false;
+};
+
+// Reports the window cost of the current scale as the measured time.
+struct FakeTimer {
+  static FakeTimer getTimer() {
+    return FakeTimer();
+  }
+  void start() {}
+  void stop() {}
+  void reset() {}
+  long getTimeInMs() {
+    return 1000.0 * getWindowCostInSeconds(currentScale);
+  }
+};
+
+using Adapter = RefreshRateAdapter<
+  MockPdmp, State, SimpleFlow, FakeController, FakeTimer>;
+
+class RefreshRateAdapterTests : public ::testing::Test {
+
+ protected:
+
+  RefreshRateAdapterTests() {
+    currentScale = 1.0;
+    std::mt19937_64 rng(42);
+    std::normal_distribution<float> normal;
+    for (int i = 0; i < kWindowIterations; i++) {
+      window_.push_back(IterationResult<State>{State{normal(rng)}, 1.0f});
+    }
+  }
+
+  // Feeds the same path in each window, so that the windows only differ in
+  // the measured time.
+  void runWindows(Adapter& adapter, int numberOfWindows) {
+    adapter.notifyProcessBegins(MockPdmp(), window_.back().state);
+    for (int i = 0; i < numberOfWindows; i++) {
+      for (const auto& iterationResult : window_) {
+        adapter.notifyIterationResult(iterationResult);
+      }
+    }
+  }
+
+  const int kWindowIterations = 256;
+  std::vector<IterationResult<State>> window_;
+};
+
+TEST_F(RefreshRateAdapterTests, TestScaleConvergesToTheMostEfficientOne) {
+  auto controller = std::make_shared<FakeController>();
+  Adapter adapter(
+    controller, [] (const State& state) { return state.x; }, kWindowIterations);
+  runWindows(adapter, 30);
+  EXPECT_NEAR(2.0, adapter.getTunedScale(), 0.1);
+
+  adapter.notifyProcessEnded();
+  EXPECT_EQ(adapter.getTunedScale(), controller->getScale());
+  EXPECT_TRUE(controller->isFrozen);
+}
+
+TEST_F(RefreshRateAdapterTests, TestTuningTraceRecordsEachWindow) {
+  auto controller = std::make_shared<FakeController>();
+  Adapter adapter(
+    controller, [] (const State& state) { return state.x; }, kWindowIterations);
+  runWindows(adapter, 3);
+  const auto& trace = adapter.getTuningTrace();
+  ASSERT_EQ(3, trace.size());
+  // The current scale is evaluated first, followed by its neighbours.
+  EXPECT_DOUBLE_EQ(1.0, trace[0].scale);
+  EXPECT_DOUBLE_EQ(4.0, trace[1].scale);
+  EXPECT_DOUBLE_EQ(0.25, trace[2].scale);
+  for (const auto& step : trace) {
+    EXPECT_EQ(kWindowIterations, step.numberOfIterations);
+    EXPECT_FLOAT_EQ(kWindowIterations, step.trajectoryLength);
+    EXPECT_GT(step.effectiveSampleSize, 0.0);
+    EXPECT_DOUBLE_EQ(step.effectiveSampleSize, trace[0].effectiveSampleSize);
+    EXPECT_NEAR(getWindowCostInSeconds(step.scale), step.seconds, 1e-3);
+    EXPECT_DOUBLE_EQ(
+      step.effectiveSampleSize / step.seconds,
+      step.effectiveSampleSizePerSecond);
+  }
+}
+
+TEST_F(RefreshRateAdapterTests, TestInvalidSettingsThrowAnException) {
+  auto controller = std::make_shared<FakeController>();
+  auto integrand = [] (const State& state) { return state.x; };
+  EXPECT_THROW(Adapter(controller, integrand, 0), std::invalid_argument);
+  EXPECT_THROW(Adapter(controller, integrand, 100, 1.0), std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "analysis/parallel_chain_runner.h"
+
+using namespace pdmp::analysis;
+using namespace std;
+
+namespace {
+
+// A chain of pseudo-random length, returning the sum of its draws.
+auto chain = [] (int chainId, mt19937_64& rng) {
+  uniform_real_distribution<double> unif(0.0, 1.0);
+  const int length = 1000 * (1 + chainId % 5);
+  double sum = 0.0;
+  for (int i = 0; i < length; i++) {
+    sum += unif(rng);
+  }
+  return sum;
+};
+
+}
+
+TEST(ParallelChainRunnerTests, TestResultsAreInChainOrder) {
+  ParallelChainRunner runner(3);
+  EXPECT_EQ(3, runner.getNumberOfThreads());
+  auto chainIds = runner.runChains(
+    [] (int chainId, mt19937_64&) { return chainId; }, 20);
+  ASSERT_EQ(20, chainIds.size());
+  for (int i = 0; i < 20; i++) {
+    EXPECT_EQ(i, chainIds[i]);
+  }
+  EXPECT_TRUE(runner.runChains(chain, 0).empty());
+}
+
+TEST(ParallelChainRunnerTests, TestResultsDoNotDependOnTheNumberOfThreads) {
+  vector<vector<double>> results;
+  for (int numberOfThreads : {1, 4}) {
+    ParallelChainRunner runner(numberOfThreads, true);
+    results.push_back(runner.runChains(chain, 17, 2019));
+  }
+  EXPECT_EQ(results[0], results[1]);
+  for (int i = 0; i < 17; i++) {
+    mt19937_64 rng = ParallelChainRunner::getChainRng(2019, i);
+    EXPECT_EQ(chain(i, rng), results[0][i]);
+    EXPECT_NE(results[0][i], results[0][(i + 5) % 17]);
+  }
+}
+
+TEST(ParallelChainRunnerTests, TestThreadsAreReusedForSeveralBatches) {
+  ParallelChainRunner runner(2);
+  auto getThreadId = [] (int, mt19937_64&) { return this_thread::get_id(); };
+  vector<thread::id> threadIds;
+  for (int batch = 0; batch < 5; batch++) {
+    for (const auto& id : runner.runChains(getThreadId, 8)) {
+      if (find(threadIds.begin(), threadIds.end(), id) == threadIds.end()) {
+        threadIds.push_back(id);
+      }
+    }
+  }
+  EXPECT_GE(2, threadIds.size());
+}
+
+TEST(ParallelChainRunnerTests, TestConcurrentBatchesRunOneAfterAnother) {
+  ParallelChainRunner runner(3);
+  const auto expected = runner.runChains(chain, 12, 7);
+  vector<vector<double>> results(4);
+  vector<thread> callers;
+  for (int i = 0; i < results.size(); i++) {
+    callers.emplace_back([&runner, &results, i] () {
+      results[i] = runner.runChains(chain, 12, 7);
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (const auto& result : results) {
+    EXPECT_TRUE(expected == result);
+  }
+}
+
+TEST(ParallelChainRunnerTests, TestNestedBatchesThrowAnException) {
+  ParallelChainRunner runner(2);
+  auto nestingChain = [&runner] (int, mt19937_64&) {
+    return runner.runChains(chain, 2).size();
+  };
+  EXPECT_THROW(runner.runChains(nestingChain, 2), logic_error);
+}
+
+TEST(ParallelChainRunnerTests, TestExceptionsAreRethrown) {
+  ParallelChainRunner runner(2);
+  atomic<int> numberOfChainsRun(0);
+  auto failingChain = [&numberOfChainsRun] (int chainId, mt19937_64&) {
+    numberOfChainsRun++;
+    if (chainId == 3) {
+      throw runtime_error("Chain failed.");
+    }
+    return chainId;
+  };
+  EXPECT_THROW(runner.runChains(failingChain, 10), runtime_error);
+  EXPECT_LE(numberOfChainsRun.load(), 10);
+  EXPECT_EQ(4, runner.runChains(chain, 4).size());
+  EXPECT_THROW(ParallelChainRunner(0), invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "analysis/parallel_tempering.h"
+#include "analysis/pdmp_runner.h"
+#include "mcmc/bps/bps_builder.h"
+#include "mcmc/distributions/gaussian.h"
+#include "mcmc/utils.h"
+
+using namespace pdmp;
+using namespace pdmp::analysis;
+using namespace pdmp::mcmc;
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+using BpsPdmp = decltype(std::declval<BpsBuilder>().build());
+using MyParallelTempering = ParallelTempering<BpsPdmp, bps::State>;
+
+namespace {
+
+// A standard Gaussian target on two variables, tempered by the given
+// inverse temperature.
+BpsPdmp getGaussianReplica(double inverseTemperature) {
+  ScopedRngSeed seed(static_cast<std::uint64_t>(1000 * inverseTemperature));
+  BpsBuilder builder(2);
+  builder.setInverseTemperature(inverseTemperature);
+  builder.addFactor(
+    {0, 1},
+    GaussianDistribution(RealVector::Zero(2), RealMatrix::Identity(2, 2)));
+  return builder.build();
+}
+
+double getGaussianLogDensity(const bps::State& state) {
+  return -0.5 * state.position.squaredNorm();
+}
+
+double getFlatLogDensity(const bps::State&) {
+  return 0.0;
+}
+
+// Integrates the square of the first variable along the observed
+// trajectory.
+struct SecondMomentObserver : ObserverBase<BpsPdmp, bps::State> {
+
+  void notifyProcessBegins(
+    const BpsPdmp&, const bps::State& initialState) override {
+
+    state = initialState;
+  }
+
+  void notifyIterationResult(
+    const IterationResult<bps::State>& iterationResult) override {
+
+    const double x = state.position(0);
+    const double v = state.velocity(0);
+    const double t = iterationResult.iterationTime;
+    integral += x * x * t + x * v * t * t + v * v * t * t * t / 3.0;
+    totalTime += t;
+    state = iterationResult.state;
+    numberOfIterations++;
+  }
+
+  bps::State state;
+  double integral{0.0};
+  double totalTime{0.0};
+  long numberOfIterations{0};
+
+};
+
+bps::State getInitialState() {
+  return bps::State(RealVector::Ones(2), RealVector::Ones(2));
+}
+
+}
+
+TEST(ParallelTemperingTests, TestColdReplicaKeepsTheTarget) {
+  MyParallelTempering parallelTempering(
+    getGaussianReplica, {1.0, 0.5, 0.25}, getGaussianLogDensity, 1.0, 2, 7);
+  SecondMomentObserver observer;
+  parallelTempering.registerAnObserver(&observer);
+  parallelTempering.run(getInitialState(), 20000.0);
+
+  EXPECT_NEAR(1.0, observer.integral / observer.totalTime, 0.1);
+  const auto report = parallelTempering.getReport();
+  ASSERT_EQ(report.exchanges.size(), 2);
+  for (const auto& exchange : report.exchanges) {
+    EXPECT_GT(exchange.acceptanceRate, 0.1);
+    EXPECT_LT(exchange.acceptanceRate, 1.0);
+  }
+  ASSERT_EQ(report.replicas.size(), 3);
+  EXPECT_DOUBLE_EQ(report.replicas[2].inverseTemperature, 0.25);
+  for (const auto& replica : report.replicas) {
+    EXPECT_GT(replica.numberOfEvents, 0);
+  }
+}
+
+TEST(ParallelTemperingTests, TestOnlyTheColdReplicaIsObserved) {
+  // With a flat log density all the swaps are accepted, and the pairs
+  // (0, 1) and (1, 2) are proposed alternately at times 1, 2, ..., 9.
+  MyParallelTempering parallelTempering(
+    getGaussianReplica, {1.0, 0.5, 0.25}, getFlatLogDensity, 1.0, 3, 7);
+  SecondMomentObserver observer;
+  parallelTempering.registerAnObserver(&observer);
+  parallelTempering.run(getInitialState(), 10.0);
+
+  const auto report = parallelTempering.getReport();
+  EXPECT_EQ(report.exchanges[0].numberOfProposals, 5);
+  EXPECT_EQ(report.exchanges[1].numberOfProposals, 4);
+  for (const auto& exchange : report.exchanges) {
+    EXPECT_DOUBLE_EQ(exchange.acceptanceRate, 1.0);
+  }
+  EXPECT_EQ(observer.numberOfIterations,
+            report.replicas[0].numberOfEvents
+              + report.exchanges[0].numberOfAcceptances);
+}
+
+TEST(ParallelTemperingTests, TestRunsDoNotDependOnTheNumberOfThreads) {
+  std::vector<bps::State> states;
+  for (int numberOfThreads : {1, 3}) {
+    MyParallelTempering parallelTempering(
+      getGaussianReplica, {1.0, 0.5, 0.25}, getGaussianLogDensity, 0.5,
+      numberOfThreads, 11);
+    parallelTempering.run(getInitialState(), 100.0);
+    for (int k = 0; k < parallelTempering.getNumberOfReplicas(); k++) {
+      states.push_back(parallelTempering.getState(k));
+    }
+  }
+  for (int k = 0; k < 3; k++) {
+    EXPECT_EQ(states[k].position, states[k + 3].position);
+    EXPECT_EQ(states[k].velocity, states[k + 3].velocity);
+  }
+}
+
+TEST(ParallelTemperingTests, TestInvalidArgumentsThrowAnException) {
+  EXPECT_THROW(
+    MyParallelTempering(
+      getGaussianReplica, {0.5, 0.25}, getGaussianLogDensity, 1.0, 1, 0),
+    std::invalid_argument);
+  EXPECT_THROW(
+    MyParallelTempering(
+      getGaussianReplica, {1.0, 0.5, 0.5}, getGaussianLogDensity, 1.0, 1, 0),
+    std::invalid_argument);
+  EXPECT_THROW(
+    MyParallelTempering(
+      getGaussianReplica, {1.0, 0.5}, getGaussianLogDensity, 0.0, 1, 0),
+    std::invalid_argument);
+
+  MyParallelTempering parallelTempering(
+    getGaussianReplica, {1.0, 0.5}, getGaussianLogDensity, 1.0, 1, 0);
+  EXPECT_THROW(
+    parallelTempering.run(std::vector<bps::State>{getInitialState()}, 1.0),
+    std::invalid_argument);
+  EXPECT_THROW(parallelTempering.getState(2), std::out_of_range);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "core/dependencies_graph/dependencies_graph.h"
+#include "core/dependencies_graph/factor_node.h"
+#include "core/dependencies_graph/markov_kernel_node.h"
+#include "core/dependencies_graph/variable_node.h"
+#include "core/policies/linear_flow.h"
+#include "core/policies/poisson_process.h"
+#include "core/state_space/position_and_velocity_state.h"
+
+/**
+ * In this header file we define a small local PDMP model shared by the tests
+ * of the parallel simulators, which compare their trajectories with the
+ * sequential ones.
+ */
+
+using BeadChainState = pdmp::DynamicPositionAndVelocityState<double>;
+using BeadChainGraph = pdmp::dependencies_graph::DependenciesGraph<
+  pdmp::dependencies_graph::MarkovKernelNodeBase<BeadChainState>,
+  pdmp::dependencies_graph::VariableNode,
+  pdmp::dependencies_graph::FactorNodeBase<BeadChainState>>;
+
+/**
+ * A chain of beads on a line, where the gap between consecutive beads stays
+ * in [0, 1]. When a gap hits its bound, the two beads either swap or negate
+ * their velocities, unless the event is rejected by the thinning step.
+ * All the randomness is kept in the closures of the nodes, seeded by the
+ * given seed and the factor id, so two graphs built with the same seed
+ * simulate the same trajectory.
+ */
+std::shared_ptr<BeadChainGraph> getBeadChainGraph(
+  int numberOfBeads, int seed = 0) {
+
+  using namespace pdmp;
+  using namespace pdmp::dependencies_graph;
+  using State = BeadChainState;
+  std::vector<std::shared_ptr<MarkovKernelNodeBase<State>>> kernels;
+  std::vector<std::shared_ptr<FactorNodeBase<State>>> factors;
+  std::vector<std::vector<int>> dependentFactorIds(2 * numberOfBeads);
+  for (int i = 0; i + 1 < numberOfBeads; i++) {
+    auto factor =
+      [rng = std::mt19937(seed + 2 * i)] (
+        const auto& subvector, auto&, auto&) mutable {
+        const double gap = subvector(1) - subvector(0);
+        const double relativeVelocity = subvector(3) - subvector(2);
+        double time = std::numeric_limits<double>::infinity();
+        if (relativeVelocity > 0.0) {
+          time = std::max(0.0, (1.0 - gap) / relativeVelocity);
+        } else if (relativeVelocity < 0.0) {
+          time = std::max(0.0, gap / -relativeVelocity);
+        }
+        const bool shouldAccept =
+          std::uniform_real_distribution<double>(0.0, 1.0)(rng) < 0.8;
+        auto thinningStep = [shouldAccept] () { return shouldAccept; };
+        std::shared_ptr<PoissonProcessResultBase> result =
+          std::make_shared<PoissonProcessResult<decltype(thinningStep)>>(
+            time, thinningStep);
+        return result;
+      };
+    auto kernel =
+      [rng = std::mt19937(seed + 2 * i + 1)] (
+        State::DynamicRealVector velocities) mutable {
+        if (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < 0.5) {
+          std::swap(velocities(0), velocities(1));
+        } else {
+          velocities *= -1.0;
+        }
+        return velocities;
+      };
+    std::vector<int> ids{i, i + 1, numberOfBeads + i, numberOfBeads + i + 1};
+    factors.push_back(
+      std::make_shared<FactorNode<State, decltype(factor), LinearFlow>>(
+        ids, factor));
+    kernels.push_back(
+      std::make_shared<MarkovKernelNode<State, decltype(kernel)>>(
+        std::vector<int>{numberOfBeads + i, numberOfBeads + i + 1}, kernel));
+    for (int id : ids) {
+      dependentFactorIds[id].push_back(i);
+    }
+  }
+  std::vector<std::shared_ptr<VariableNode>> variables;
+  for (const auto& ids : dependentFactorIds) {
+    variables.push_back(std::make_shared<VariableNode>(ids));
+  }
+  return std::make_shared<BeadChainGraph>(kernels, variables, factors);
+}
+
+/**
+ * Returns a state of the bead chain with gaps in [0, 1].
+ */
+BeadChainState getInitialBeadChainState(int numberOfBeads) {
+  std::mt19937 rng(2019);
+  std::uniform_real_distribution<double> unif(0.0, 1.0);
+  BeadChainState::DynamicRealVector position(numberOfBeads);
+  BeadChainState::DynamicRealVector velocity(numberOfBeads);
+  double x = 0.0;
+  for (int i = 0; i < numberOfBeads; i++) {
+    x += unif(rng);
+    position(i) = x;
+    velocity(i) = 2.0 * unif(rng) - 1.0;
+  }
+  return BeadChainState(position, velocity);
+}
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <stdexcept>
 
 #include <gtest/gtest.h>
 
@@ -124,6 +125,57 @@ TEST_F(DependenciesGraphTests, TestDependenciesAreCalculatedCorrectly6) {
   }
 }
 
+TEST_F(DependenciesGraphTests, TestDependenciesOfVariables) {
+  EXPECT_TRUE(
+    sorted(graph_.getFactorDependenciesOfVariables<DummyFlow1>({3}))
+    == (vector<int>{2}));
+  EXPECT_TRUE(
+    sorted(graph_.getFactorDependenciesOfVariables<DummyFlow2>({2, 3}))
+    == (vector<int>{0, 2}));
+  EXPECT_TRUE(
+    graph_.getFactorDependenciesOfVariables<DummyFlow1>({}).empty());
+}
+
+TEST_F(DependenciesGraphTests, TestHubFactorsAreFoundByTheThreshold) {
+  for (int i = 0; i < 3; i++) {
+    EXPECT_FALSE(graph_.isHubFactor<DummyFlow1>(i));
+  }
+  graph_.setHubThreshold(2);
+  EXPECT_TRUE(graph_.isHubFactor<DummyFlow1>(0));
+  EXPECT_TRUE(graph_.isHubFactor<DummyFlow1>(1));
+  EXPECT_FALSE(graph_.isHubFactor<DummyFlow1>(2));
+  EXPECT_THROW(graph_.setHubThreshold(0), std::invalid_argument);
+}
+
+TEST_F(DependenciesGraphTests, TestGraphWithOtherNodesSharesTheDependencies) {
+  graph_.setHubThreshold(2);
+  graph_.cacheAllFactorDependencies<DummyFlow1>();
+  DependenciesGraph otherGraph(
+    graph_,
+    {
+      make_shared<DummyMarkovKernelNode>(vector<int>{1}),
+      make_shared<DummyMarkovKernelNode>(vector<int>{0, 3}),
+      make_shared<DummyMarkovKernelNode>(vector<int>{2})
+    },
+    {
+      make_shared<DummyFactorNode>(),
+      make_shared<DummyFactorNode>(),
+      make_shared<DummyFactorNode>()
+    });
+
+  EXPECT_EQ(otherGraph.variableNodes, graph_.variableNodes);
+  EXPECT_NE(otherGraph.factorNodes, graph_.factorNodes);
+  for (int i = 0; i < 3; i++) {
+    // The same cached vectors are returned.
+    EXPECT_EQ(&otherGraph.getFactorDependencies<DummyFlow1>(i),
+              &graph_.getFactorDependencies<DummyFlow1>(i));
+    EXPECT_EQ(otherGraph.isHubFactor<DummyFlow1>(i),
+              graph_.isHubFactor<DummyFlow1>(i));
+  }
+  EXPECT_THROW(
+    DependenciesGraph(graph_, {}, {}), std::runtime_error);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
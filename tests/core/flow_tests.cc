@@ -1,8 +1,12 @@
+#include <cmath>
 #include <vector>
 
 #include <gtest/gtest.h>
 
+#include "core/policies/boomerang_flow.h"
 #include "core/policies/linear_flow.h"
+#include "core/policies/preconditioned_linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
 #include "core/state_space/position_and_velocity_state.h"
 
 /**
@@ -36,6 +40,78 @@ TEST(LinearFlowTest, TestLinearFlowCalculationsAreCorrect) {
   EXPECT_TRUE(actualState == expectedState);
 }
 
+/**
+ * The Zig-Zag flow should move the particle exactly as the linear flow.
+ */
+TEST(ZigZagFlowTest, TestZigZagFlowMatchesLinearFlow) {
+  const int dimension = 4;
+  using State = pdmp::PositionAndVelocityState<double, dimension>;
+  using RealVector = State::RealVector<dimension / 2>;
+
+  const State initialState(RealVector(1.0, -2.0), RealVector(1.0, -1.0));
+  EXPECT_TRUE(pdmp::ZigZagFlow::advanceStateByFlow(initialState, 1.5)
+              == pdmp::LinearFlow::advanceStateByFlow(initialState, 1.5));
+  EXPECT_TRUE(pdmp::ZigZagFlow::getDependentVariableIds(3, 4)
+              == pdmp::LinearFlow::getDependentVariableIds(3, 4));
+}
+
+/**
+ * The preconditioned flow should move the particle exactly as the linear flow.
+ */
+TEST(PreconditionedLinearFlowTest, TestFlowMatchesLinearFlow) {
+  const int dimension = 4;
+  using State = pdmp::PositionAndVelocityState<double, dimension>;
+  using RealVector = State::RealVector<dimension / 2>;
+
+  const State initialState(RealVector(1.0, -2.0), RealVector(0.5, -3.0));
+  EXPECT_TRUE(
+    pdmp::PreconditionedLinearFlow::advanceStateByFlow(initialState, 1.5)
+    == pdmp::LinearFlow::advanceStateByFlow(initialState, 1.5));
+  EXPECT_TRUE(pdmp::PreconditionedLinearFlow::getDependentVariableIds(3, 4)
+              == pdmp::LinearFlow::getDependentVariableIds(3, 4));
+}
+
+/**
+ * The Boomerang flow should rotate each (position, velocity) pair, keeping
+ * x^2 + v^2 constant and returning to the initial state after a full turn.
+ */
+TEST(BoomerangFlowTest, TestBoomerangFlowRotatesTheState) {
+  const int dimension = 4;
+  using State = pdmp::PositionAndVelocityState<double, dimension>;
+  using RealVector = State::RealVector<dimension / 2>;
+
+  const State initialState(RealVector(1.0, -2.0), RealVector(0.5, 3.0));
+  State quarterTurn =
+    pdmp::BoomerangFlow::advanceStateByFlow(initialState, M_PI / 2.0);
+  EXPECT_TRUE(quarterTurn.position.isApprox(initialState.velocity));
+  EXPECT_TRUE(quarterTurn.velocity.isApprox(-1.0 * initialState.position));
+
+  State movedState = pdmp::BoomerangFlow::advanceStateByFlow(
+    State(initialState), 0.7);
+  EXPECT_NEAR(
+    initialState.position.squaredNorm() + initialState.velocity.squaredNorm(),
+    movedState.position.squaredNorm() + movedState.velocity.squaredNorm(),
+    1e-12);
+  State fullTurn = pdmp::BoomerangFlow::advanceStateByFlow(
+    movedState, 2.0 * M_PI - 0.7);
+  EXPECT_TRUE(fullTurn.position.isApprox(initialState.position));
+  EXPECT_TRUE(fullTurn.velocity.isApprox(initialState.velocity));
+}
+
+/**
+ * Under the Boomerang flow, positions depend on velocities and vice versa.
+ */
+TEST(BoomerangFlowTest, TestDependenciesCalculation) {
+  EXPECT_TRUE(pdmp::BoomerangFlow::getDependentVariableIds(1, 6)
+              == std::vector<int>({1, 4}));
+  EXPECT_TRUE(pdmp::BoomerangFlow::getDependentVariableIds(4, 6)
+              == std::vector<int>({1, 4}));
+  EXPECT_THROW(pdmp::BoomerangFlow::getDependentVariableIds(6, 6),
+               std::out_of_range);
+  EXPECT_THROW(pdmp::BoomerangFlow::getDependentVariableIds(0, 5),
+               std::logic_error);
+}
+
 TEST(LinearFlowTest, TestDependenciesCalculationForPositionVariable) {
   auto dependencies = pdmp::LinearFlow::getDependentVariableIds(0, 10);
   std::vector<int> expectedDependencies{0};
@@ -75,6 +151,38 @@ TEST(
     std::out_of_range);
 }
 
+/**
+ * Advancing a subvector by the flow should give the same values as advancing
+ * the whole state and then taking the subvector.
+ */
+TEST(LinearFlowTest, TestSubvectorFlowMatchesStateFlow) {
+  const int dimension = 6;
+  using State = pdmp::PositionAndVelocityState<double, dimension>;
+  using RealVector = State::RealVector<dimension / 2>;
+
+  const State initialState(
+    RealVector(1.0, 2.0, 3.0), RealVector(2.5, -3.25, 5.0));
+  const std::vector<int> ids{4, 0, 2};
+  EXPECT_TRUE(
+    pdmp::LinearFlow::advanceSubvectorByFlow(initialState, ids, 1.5)
+      .isApprox(pdmp::LinearFlow::advanceStateByFlow(initialState, 1.5)
+                  .getSubvector(ids)));
+}
+
+TEST(BoomerangFlowTest, TestSubvectorFlowMatchesStateFlow) {
+  const int dimension = 6;
+  using State = pdmp::PositionAndVelocityState<double, dimension>;
+  using RealVector = State::RealVector<dimension / 2>;
+
+  const State initialState(
+    RealVector(1.0, -2.0, 0.5), RealVector(0.5, 3.0, -1.0));
+  const std::vector<int> ids{4, 1, 5};
+  EXPECT_TRUE(
+    pdmp::BoomerangFlow::advanceSubvectorByFlow(initialState, ids, 0.7)
+      .isApprox(pdmp::BoomerangFlow::advanceStateByFlow(initialState, 0.7)
+                  .getSubvector(ids)));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,90 @@
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/interleaved_pdmps.h"
+#include "core/pdmp.h"
+#include "core/dependencies_graph/dependencies_graph.h"
+#include "core/dependencies_graph/factor_node.h"
+#include "core/dependencies_graph/markov_kernel_node.h"
+#include "core/dependencies_graph/variable_node.h"
+#include "core/policies/linear_flow.h"
+#include "core/policies/markov_kernel.h"
+#include "core/policies/poisson_process.h"
+#include "core/state_space/position_and_velocity_state.h"
+#include "bead_chain.h"
+
+using namespace pdmp;
+using namespace pdmp::dependencies_graph;
+using namespace std;
+
+using State = DynamicPositionAndVelocityState<double>;
+using MyDependenciesGraph = DependenciesGraph<
+  MarkovKernelNodeBase<State>,
+  VariableNode,
+  FactorNodeBase<State>>;
+using MyPdmp = Pdmp<
+  PoissonProcess<MyDependenciesGraph>,
+  MarkovKernel<MyDependenciesGraph>,
+  LinearFlow>;
+
+namespace {
+
+// The bead chain PDMP with the given seed (see getBeadChainGraph).
+MyPdmp getBeadChainPdmp(int numberOfBeads, int seed) {
+  auto args = make_tuple(getBeadChainGraph(numberOfBeads, seed));
+  return MyPdmp(args, args);
+}
+
+}
+
+TEST(InterleavedPdmpsTests, TestTrajectoriesAreTheSameAsSequentially) {
+  const int numberOfBeads = 32;
+  const int numberOfPdmps = 3;
+  const int numberOfIterations = 500;
+  vector<MyPdmp> pdmps;
+  vector<State> states;
+  for (int k = 0; k < numberOfPdmps; k++) {
+    pdmps.push_back(getBeadChainPdmp(numberOfBeads, 1000 * k));
+    states.push_back(getInitialBeadChainState(numberOfBeads));
+  }
+  InterleavedPdmps<MyPdmp, State> interleavedPdmps(std::move(pdmps), states);
+  EXPECT_EQ(numberOfPdmps, interleavedPdmps.getNumberOfPdmps());
+
+  vector<vector<IterationResult<State>>> results(numberOfPdmps);
+  interleavedPdmps.simulateIterations(
+    numberOfIterations,
+    [&results] (int pdmpId, const IterationResult<State>& result) {
+      results[pdmpId].push_back(result);
+    });
+
+  for (int k = 0; k < numberOfPdmps; k++) {
+    ASSERT_EQ(numberOfIterations, results[k].size());
+    auto pdmp = getBeadChainPdmp(numberOfBeads, 1000 * k);
+    State state = getInitialBeadChainState(numberOfBeads);
+    for (int i = 0; i < numberOfIterations; i++) {
+      auto result = pdmp.simulateOneIteration(state);
+      EXPECT_EQ(result.iterationTime, results[k][i].iterationTime);
+      EXPECT_EQ(result.state.position, results[k][i].state.position);
+      EXPECT_EQ(result.state.velocity, results[k][i].state.velocity);
+      state = result.state;
+    }
+    EXPECT_EQ(state.position, interleavedPdmps.getState(k).position);
+  }
+  EXPECT_NE(results[0].back().state.velocity, results[1].back().state.velocity);
+}
+
+TEST(InterleavedPdmpsTests, TestEachPdmpNeedsAState) {
+  vector<MyPdmp> pdmps;
+  pdmps.push_back(getBeadChainPdmp(4, 0));
+  EXPECT_THROW(
+    (InterleavedPdmps<MyPdmp, State>(pdmps, {})), invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
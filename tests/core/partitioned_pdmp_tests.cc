@@ -0,0 +1,134 @@
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "core/pdmp.h"
+#include "core/dependencies_graph/dependencies_graph.h"
+#include "core/dependencies_graph/factor_node.h"
+#include "core/dependencies_graph/markov_kernel_node.h"
+#include "core/dependencies_graph/partitioned_pdmp.h"
+#include "core/dependencies_graph/variable_node.h"
+#include "core/policies/linear_flow.h"
+#include "core/policies/markov_kernel.h"
+#include "core/policies/poisson_process.h"
+#include "core/state_space/position_and_velocity_state.h"
+#include "bead_chain.h"
+
+using namespace pdmp;
+using namespace pdmp::dependencies_graph;
+using namespace std;
+using namespace testing;
+
+using State = DynamicPositionAndVelocityState<double>;
+using MyDependenciesGraph = DependenciesGraph<
+  MarkovKernelNodeBase<State>,
+  VariableNode,
+  FactorNodeBase<State>>;
+using MyPdmp = Pdmp<
+  PoissonProcess<MyDependenciesGraph>,
+  MarkovKernel<MyDependenciesGraph>,
+  LinearFlow>;
+using MyPartitionedPdmp =
+  PartitionedPdmp<MyDependenciesGraph, State, LinearFlow>;
+
+namespace {
+
+// Simulates the sequential PDMP and returns its states at the given times.
+vector<State> getSequentialStates(
+  int numberOfBeads, const vector<double>& times) {
+
+  auto graph = getBeadChainGraph(numberOfBeads);
+  auto args = make_tuple(graph);
+  MyPdmp pdmp(args, args);
+  State state = getInitialBeadChainState(numberOfBeads);
+  double time = 0.0;
+  auto result = pdmp.simulateOneIteration(state);
+  vector<State> states;
+  for (double nextTime : times) {
+    while (time + result.iterationTime <= nextTime) {
+      time += result.iterationTime;
+      state = result.state;
+      result = pdmp.simulateOneIteration(state);
+    }
+    states.push_back(LinearFlow::advanceStateByFlow(state, nextTime - time));
+  }
+  return states;
+}
+
+}
+
+TEST(PartitionedPdmpTests, TestCrossPartitionFactorsAreFound) {
+  auto graph = getBeadChainGraph(8);
+  MyPartitionedPdmp pdmp(graph, 2);
+
+  // Beads 0-3 are in partition 0 and beads 4-7 in partition 1. Factor 3
+  // links the partitions, and factor 4 changes a velocity read by factor 3.
+  vector<int> expectedPartitions{0, 0, 0, 0, 1, 1, 1};
+  for (int factorId = 0; factorId < 7; factorId++) {
+    EXPECT_EQ(pdmp.getPartitionOfFactor(factorId), expectedPartitions[factorId]);
+    EXPECT_EQ(
+      pdmp.isCrossPartitionFactor(factorId), factorId == 3 || factorId == 4);
+  }
+}
+
+TEST(PartitionedPdmpTests, TestSinglePartitionHasNoCrossPartitionFactors) {
+  auto graph = getBeadChainGraph(8);
+  MyPartitionedPdmp pdmp(graph, 1);
+
+  for (int factorId = 0; factorId < 7; factorId++) {
+    EXPECT_EQ(pdmp.getPartitionOfFactor(factorId), 0);
+    EXPECT_FALSE(pdmp.isCrossPartitionFactor(factorId));
+  }
+}
+
+TEST(PartitionedPdmpTests, TestTrajectoryIsTheSameAsSequentially) {
+  const int numberOfBeads = 64;
+  const vector<double> times{0.5, 1.0, 2.0, 5.0, 10.0};
+  const auto expectedStates = getSequentialStates(numberOfBeads, times);
+
+  for (int numberOfPartitions : {1, 2, 4, 7}) {
+    MyPartitionedPdmp pdmp(
+      getBeadChainGraph(numberOfBeads), numberOfPartitions);
+    pdmp.setState(getInitialBeadChainState(numberOfBeads));
+    for (int i = 0; i < times.size(); i++) {
+      State state = pdmp.simulateUntil(times[i]);
+      EXPECT_DOUBLE_EQ(pdmp.getTime(), times[i]);
+      for (int j = 0; j < numberOfBeads; j++) {
+        EXPECT_NEAR(state.position(j), expectedStates[i].position(j), 1e-9);
+        EXPECT_DOUBLE_EQ(state.velocity(j), expectedStates[i].velocity(j));
+      }
+    }
+    const auto& statistics = pdmp.getStatistics();
+    EXPECT_GT(statistics.numberOfEvents, 0);
+    if (numberOfPartitions == 1) {
+      EXPECT_EQ(statistics.numberOfCrossPartitionEvents, 0);
+      EXPECT_EQ(statistics.numberOfRolledBackEvents, 0);
+    } else {
+      EXPECT_GT(statistics.numberOfCrossPartitionEvents, 0);
+    }
+  }
+}
+
+TEST(PartitionedPdmpTests, TestStateShouldBeSetBeforeSimulating) {
+  MyPartitionedPdmp pdmp(getBeadChainGraph(8), 2);
+  EXPECT_THROW(pdmp.simulateUntil(1.0), logic_error);
+
+  pdmp.setState(getInitialBeadChainState(8), 1.0);
+  EXPECT_THROW(pdmp.simulateUntil(0.5), invalid_argument);
+  EXPECT_THROW(pdmp.setState(getInitialBeadChainState(4)), invalid_argument);
+}
+
+TEST(PartitionedPdmpTests, TestNumberOfPartitionsShouldBePositive) {
+  EXPECT_THROW(MyPartitionedPdmp(getBeadChainGraph(8), 0), invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -219,6 +219,103 @@ TEST_F(
   EXPECT_TRUE(areEqual(returned, 0.5f));
 }
 
+TEST_F(
+  PoissonProcessSimulationTests,
+  TestParallelResimulationSchedulesTheSameEvents) {
+
+  poissonProcess_.setParallelResimulation(2, 2);
+  shared_ptr<PoissonProcessResultBase> result0
+    = make_shared<PoissonProcessResult<>>(2.0f);
+  shared_ptr<PoissonProcessResultBase> result1
+    = make_shared<PoissonProcessResult<>>(1.5f);
+  shared_ptr<PoissonProcessResultBase> result2
+    = make_shared<PoissonProcessResult<>>(3.0f);
+
+  setUpReturnObjectForMockFactorNode(0, initialState_, &result0);
+  setUpReturnObjectForMockFactorNode(1, initialState_, &result1);
+  setUpReturnObjectForMockFactorNode(2, initialState_, &result2);
+
+  EXPECT_TRUE(areEqual(
+    poissonProcess_.getJumpTime(initialState_, LinearFlow()), 1.5f));
+
+  // Factor1 should have returned, hence all factors are resampled in
+  // parallel, and the old events are invalidated.
+  setUpReturnObjectForMockFactorNode(0, initialState_, &result0);
+  setUpReturnObjectForMockFactorNode(1, initialState_, &result1);
+  setUpReturnObjectForMockFactorNode(2, initialState_, &result2);
+
+  EXPECT_TRUE(areEqual(
+    poissonProcess_.getJumpTime(initialState_, LinearFlow()), 1.5f));
+  EXPECT_EQ(poissonProcess_.getLastFactorId(), 1);
+}
+
+TEST_F(
+  PoissonProcessSimulationTests,
+  TestNonPositiveParallelResimulationBatchSizeThrowsAnException) {
+
+  EXPECT_THROW(
+    poissonProcess_.setParallelResimulation(2, 0), std::invalid_argument);
+}
+
+TEST_F(
+  PoissonProcessSimulationTests,
+  TestResetEventsResimulatesAllFactorsFromTimeZero) {
+
+  shared_ptr<PoissonProcessResultBase> result0
+    = make_shared<PoissonProcessResult<>>(1.5f);
+  shared_ptr<PoissonProcessResultBase> result1
+    = make_shared<PoissonProcessResult<>>(2.0f);
+  shared_ptr<PoissonProcessResultBase> result2
+    = make_shared<PoissonProcessResult<>>(3.0f);
+
+  setUpReturnObjectForMockFactorNode(0, initialState_, &result0);
+  setUpReturnObjectForMockFactorNode(1, initialState_, &result1);
+  setUpReturnObjectForMockFactorNode(2, initialState_, &result2);
+
+  poissonProcess_.getJumpTime(initialState_, LinearFlow());
+  poissonProcess_.resetEvents();
+
+  // The old events are dropped, and the new event times are not offset by
+  // the time of the last event.
+  setUpReturnObjectForMockFactorNode(0, initialState_, &result2);
+  setUpReturnObjectForMockFactorNode(1, initialState_, &result1);
+  setUpReturnObjectForMockFactorNode(2, initialState_, &result2);
+
+  auto jumpTime = poissonProcess_.getJumpTime(initialState_, LinearFlow());
+  EXPECT_TRUE(areEqual(jumpTime, 2.0f));
+}
+
+TEST_F(
+  PoissonProcessSimulationTests,
+  TestOnlyInvalidatedFactorsAreResimulated) {
+
+  shared_ptr<PoissonProcessResultBase> result0
+    = make_shared<PoissonProcessResult<>>(1.5f);
+  shared_ptr<PoissonProcessResultBase> result1
+    = make_shared<PoissonProcessResult<>>(2.0f);
+  shared_ptr<PoissonProcessResultBase> result2
+    = make_shared<PoissonProcessResult<>>(3.0f);
+  shared_ptr<PoissonProcessResultBase> invalidatedResult2
+    = make_shared<PoissonProcessResult<>>(0.25f);
+
+  setUpReturnObjectForMockFactorNode(0, initialState_, &result0);
+  setUpReturnObjectForMockFactorNode(1, initialState_, &result1);
+  setUpReturnObjectForMockFactorNode(2, initialState_, &result2);
+
+  poissonProcess_.getJumpTime(initialState_, LinearFlow());
+  poissonProcess_.invalidateFactors({2, 0});
+
+  // Factor0 fired and factor2 was invalidated, while the event of factor1
+  // is kept.
+  setUpReturnObjectForMockFactorNode(0, initialState_, &result0);
+  setUpReturnObjectForMockFactorNode(2, initialState_, &invalidatedResult2);
+
+  auto jumpTime = poissonProcess_.getJumpTime(initialState_, LinearFlow());
+  EXPECT_TRUE(areEqual(jumpTime, 0.25f));
+  EXPECT_THROW(poissonProcess_.invalidateFactors({kNumberOfFactors}),
+               std::out_of_range);
+}
+
 TEST_F(PoissonProcessSimulationTests, TestThinningProcedureWorks) {
 
   auto reject = [] () { return false; };
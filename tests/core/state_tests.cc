@@ -72,6 +72,12 @@ TEST_F(PositionAndVelocityStateTests, TestTooBigSubvectorExtractionFails) {
   EXPECT_THROW(state_.getSubvector(ids), std::logic_error);
 }
 
+TEST_F(PositionAndVelocityStateTests, TestElementAddressesPointToTheElements) {
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(state_.getElementAtIndex(i), *state_.getElementAddress(i));
+  }
+}
+
 TEST_F(PositionAndVelocityStateTests, TestCorrectSubvectorExtraction) {
   std::vector<int> ids{1,3};
   State::DynamicRealVector expectedVector(2);
@@ -0,0 +1,59 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/thread_pool.h"
+
+using namespace pdmp;
+using namespace std;
+
+TEST(ThreadPoolTests, TestEachTaskIsExecutedOnce) {
+  ThreadPool threadPool(4);
+  EXPECT_EQ(threadPool.getNumberOfThreads(), 4);
+  for (int numberOfTasks : {0, 1, 3, 1000}) {
+    vector<atomic<int>> numberOfCalls(numberOfTasks);
+    for (auto& calls : numberOfCalls) {
+      calls = 0;
+    }
+    threadPool.parallelFor(numberOfTasks, [&numberOfCalls] (int i) {
+      numberOfCalls[i]++;
+    });
+    for (const auto& calls : numberOfCalls) {
+      EXPECT_EQ(calls.load(), 1);
+    }
+  }
+}
+
+TEST(ThreadPoolTests, TestSingleThreadExecutesTasksInOrder) {
+  ThreadPool threadPool(1);
+  vector<int> calls;
+  threadPool.parallelFor(5, [&calls] (int i) { calls.push_back(i); });
+  EXPECT_EQ(calls, vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST(ThreadPoolTests, TestExceptionsAreRethrown) {
+  ThreadPool threadPool(3);
+  EXPECT_THROW(
+    threadPool.parallelFor(100, [] (int i) {
+      if (i == 42) {
+        throw runtime_error("Task failed.");
+      }
+    }),
+    runtime_error);
+
+  // The pool can be used after a failed batch.
+  atomic<int> numberOfCalls(0);
+  threadPool.parallelFor(100, [&numberOfCalls] (int) { numberOfCalls++; });
+  EXPECT_EQ(numberOfCalls.load(), 100);
+}
+
+TEST(ThreadPoolTests, TestNonPositiveNumberOfThreadsThrowsAnException) {
+  EXPECT_THROW(ThreadPool(0), invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
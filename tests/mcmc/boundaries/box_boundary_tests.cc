@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <Eigen/Core>
+
+#include "core/policies/linear_flow.h"
+#include "mcmc/boundaries/box_boundary.h"
+
+using namespace pdmp;
+using namespace pdmp::mcmc;
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+
+const double kInfinity = std::numeric_limits<double>::infinity();
+
+TEST(BoxBoundaryTests, TestHittingTimeIsTheFirstWallHit) {
+  BoxBoundary boundary((RealVector(2) << 0.0, -1.0).finished(),
+                       (RealVector(2) << kInfinity, 1.0).finished());
+  auto strategy = boundary.getPoissonProcessStrategy<LinearFlow>();
+
+  // The first coordinate hits 0 at time 2, the second hits 1 at time 1.5.
+  RealVector state = (RealVector(4) << 1.0, 0.25, -0.5, 0.5).finished();
+  EXPECT_DOUBLE_EQ(1.5, strategy(state, 0, 0)->time);
+
+  // Moving towards the infinite bound never hits the boundary.
+  state << 1.0, 0.0, 1.0, 0.0;
+  EXPECT_TRUE(std::isinf(strategy(state, 0, 0)->time));
+
+  // A coordinate pushed outside by rounding is reflected at once.
+  state << -1e-12, 0.0, -1.0, 0.0;
+  EXPECT_EQ(0.0, strategy(state, 0, 0)->time);
+}
+
+TEST(BoxBoundaryTests, TestKernelReflectsTheHittingCoordinate) {
+  BoxBoundary boundary((RealVector(2) << 0.0, -1.0).finished(),
+                       (RealVector(2) << kInfinity, 1.0).finished());
+  auto kernel = boundary.getReflectionKernel();
+
+  // The second coordinate is at its upper bound, moving outwards.
+  RealVector state = (RealVector(4) << 1.0, 1.0, -0.5, 0.5).finished();
+  RealVector expected = (RealVector(4) << 1.0, 1.0, -0.5, -0.5).finished();
+  EXPECT_TRUE(expected.isApprox(kernel(state)));
+}
+
+TEST(BoxBoundaryTests, TestCoordinateBoundaryKeepsItsBounds) {
+  BoxBoundary boundary((RealVector(2) << 0.0, -1.0).finished(),
+                       (RealVector(2) << kInfinity, 1.0).finished());
+  BoxBoundary coordinateBoundary = boundary.getCoordinateBoundary(1);
+  EXPECT_EQ(1, coordinateBoundary.getDimension());
+  auto strategy = coordinateBoundary.getPoissonProcessStrategy<LinearFlow>();
+  RealVector state = (RealVector(2) << 0.0, -2.0).finished();
+  EXPECT_DOUBLE_EQ(0.5, strategy(state, 0, 0)->time);
+  EXPECT_THROW(boundary.getCoordinateBoundary(2), std::out_of_range);
+}
+
+TEST(BoxBoundaryTests, TestInvalidBoundsThrowAnException) {
+  EXPECT_THROW(BoxBoundary(RealVector::Zero(2), RealVector::Ones(1)),
+               std::invalid_argument);
+  EXPECT_THROW(BoxBoundary(RealVector::Ones(1), RealVector::Zero(1)),
+               std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
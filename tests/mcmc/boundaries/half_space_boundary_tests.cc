@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+
+#include <Eigen/Core>
+
+#include "core/policies/linear_flow.h"
+#include "mcmc/boundaries/half_space_boundary.h"
+
+using namespace pdmp;
+using namespace pdmp::mcmc;
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+
+TEST(HalfSpaceBoundaryTests, TestHittingTimeIsExact) {
+  // The half-space x_0 <= x_1.
+  HalfSpaceBoundary boundary((RealVector(2) << 1.0, -1.0).finished(), 0.0);
+  auto strategy = boundary.getPoissonProcessStrategy<LinearFlow>();
+
+  // The gap x_1 - x_0 = 2 closes at speed 4.
+  RealVector state = (RealVector(4) << 0.0, 2.0, 1.0, -3.0).finished();
+  EXPECT_DOUBLE_EQ(0.5, strategy(state, 0, 0)->time);
+
+  // Moving parallel to, or away from, the boundary never hits it.
+  state << 0.0, 2.0, 1.0, 1.0;
+  EXPECT_TRUE(std::isinf(strategy(state, 0, 0)->time));
+  state << 0.0, 2.0, -1.0, 1.0;
+  EXPECT_TRUE(std::isinf(strategy(state, 0, 0)->time));
+}
+
+TEST(HalfSpaceBoundaryTests, TestKernelReflectsSpecularly) {
+  HalfSpaceBoundary boundary((RealVector(2) << 1.0, -1.0).finished(), 0.0);
+  auto kernel = boundary.getReflectionKernel();
+
+  RealVector state = (RealVector(4) << 1.0, 1.0, 1.0, -3.0).finished();
+  RealVector reflected = kernel(state);
+  // The normal component (4) is negated, the tangential one (-2) is kept.
+  RealVector expected = (RealVector(4) << 1.0, 1.0, -3.0, 1.0).finished();
+  EXPECT_TRUE(expected.isApprox(reflected));
+  EXPECT_DOUBLE_EQ(state.tail(2).norm(), reflected.tail(2).norm());
+}
+
+TEST(HalfSpaceBoundaryTests, TestZeroNormalThrowsAnException) {
+  EXPECT_THROW(HalfSpaceBoundary(RealVector::Zero(2), 0.0),
+               std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "mcmc/bps/batched_gaussian_bps.h"
+
+using namespace pdmp;
+using namespace pdmp::mcmc;
+using namespace std;
+
+using RealVector = BatchedGaussianBps::RealVector;
+using RealMatrix = BatchedGaussianBps::RealMatrix;
+using State = BatchedGaussianBps::State;
+
+namespace {
+
+GaussianDistribution getCorrelatedGaussian() {
+  RealVector mean(2);
+  mean << 1.0, -2.0;
+  RealMatrix covariance(2, 2);
+  covariance << 1.0, 0.6,
+                0.6, 2.0;
+  return GaussianDistribution(mean, covariance);
+}
+
+}
+
+TEST(BatchedGaussianBpsTests, TestTimeAveragesMatchTheMoments) {
+  const auto distribution = getCorrelatedGaussian();
+  const int numberOfChains = 16;
+  BatchedGaussianBps bps(distribution, 1.0, numberOfChains, 2019);
+
+  // The integrals of x and x x^T along the linear segments of all chains.
+  vector<State> previousStates;
+  for (int k = 0; k < numberOfChains; k++) {
+    previousStates.push_back(bps.getState(k));
+  }
+  RealVector firstMoment = RealVector::Zero(2);
+  RealMatrix secondMoment = RealMatrix::Zero(2, 2);
+  double totalTime = 0.0;
+  bps.simulateIterations(
+    5000,
+    [&] (int chainId, const IterationResult<State>& result) {
+      const auto& x = previousStates[chainId].position;
+      const auto& v = previousStates[chainId].velocity;
+      const double t = result.iterationTime;
+      firstMoment += x * t + v * t * t / 2.0;
+      secondMoment += x * x.transpose() * t
+        + (x * v.transpose() + v * x.transpose()) * t * t / 2.0
+        + v * v.transpose() * t * t * t / 3.0;
+      totalTime += t;
+      previousStates[chainId] = result.state;
+    });
+
+  const RealVector mean = firstMoment / totalTime;
+  const RealMatrix covariance =
+    secondMoment / totalTime - mean * mean.transpose();
+  EXPECT_NEAR(mean(0), 1.0, 0.1);
+  EXPECT_NEAR(mean(1), -2.0, 0.1);
+  EXPECT_NEAR(covariance(0, 0), 1.0, 0.1);
+  EXPECT_NEAR(covariance(0, 1), 0.6, 0.1);
+  EXPECT_NEAR(covariance(1, 1), 2.0, 0.2);
+}
+
+TEST(BatchedGaussianBpsTests, TestChainsDoNotDependOnEachOther) {
+  const auto distribution = getCorrelatedGaussian();
+  BatchedGaussianBps fewChains(distribution, 0.5, 4, 7);
+  BatchedGaussianBps manyChains(distribution, 0.5, 8, 7);
+  fewChains.simulateIterations(200);
+  manyChains.simulateIterations(200);
+
+  for (int k = 0; k < 4; k++) {
+    EXPECT_EQ(fewChains.getTime(k), manyChains.getTime(k));
+    EXPECT_EQ(fewChains.getState(k), manyChains.getState(k));
+  }
+}
+
+TEST(BatchedGaussianBpsTests, TestEachChainKeepsItsOwnClock) {
+  BatchedGaussianBps bps(getCorrelatedGaussian(), 1.0, 3, 1);
+  State state(RealVector::Zero(2), RealVector::Ones(2));
+  bps.setState(1, state);
+  EXPECT_EQ(bps.getState(1), state);
+
+  vector<double> times(3, 0.0);
+  vector<int> numberOfEvents(3, 0);
+  bps.simulateIterations(
+    50,
+    [&] (int chainId, const IterationResult<State>& result) {
+      EXPECT_GT(result.iterationTime, 0.0);
+      times[chainId] += result.iterationTime;
+      numberOfEvents[chainId]++;
+    });
+
+  for (int k = 0; k < 3; k++) {
+    EXPECT_EQ(numberOfEvents[k], 50);
+    EXPECT_NEAR(bps.getTime(k), times[k], 1e-12);
+  }
+  EXPECT_NE(bps.getTime(0), bps.getTime(1));
+}
+
+TEST(BatchedGaussianBpsTests, TestInvalidArgumentsThrowAnException) {
+  const auto distribution = getCorrelatedGaussian();
+  EXPECT_THROW(BatchedGaussianBps(distribution, 1.0, 0, 1), invalid_argument);
+  EXPECT_THROW(BatchedGaussianBps(distribution, -1.0, 2, 1), invalid_argument);
+
+  BatchedGaussianBps bps(distribution, 1.0, 2, 1);
+  EXPECT_THROW(bps.getState(2), out_of_range);
+  EXPECT_THROW(
+    bps.setState(0, State(RealVector::Zero(3), RealVector::Zero(3))),
+    invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
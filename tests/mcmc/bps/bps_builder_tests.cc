@@ -0,0 +1,539 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "mcmc/bps/bps_builder.h"
+#include "mcmc/distributions/gaussian.h"
+
+using namespace pdmp::mcmc;
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+// Exposes the nodes added by the builder.
+struct TestBpsBuilder : BpsBuilder {
+
+ public:
+
+  using BpsBuilder::BpsBuilder;
+
+  auto getFactorNodes() {
+    return this->factorNodes_;
+  }
+
+  auto getMarkovKernelNodes() {
+    return this->markovKernelNodes_;
+  }
+};
+
+class BpsBuilderTests : public ::testing::Test {
+
+ protected:
+
+  BpsBuilderTests()
+    : gaussianDistribution_(
+        RealVector::Zero(3), RealMatrix::Identity(3, 3)),
+      state_(RealVector::Zero(3), (RealVector(3) << 1.0, -2.0, 3.0).finished()) {
+  }
+
+  GaussianDistribution gaussianDistribution_;
+  bps::State state_;
+};
+
+TEST_F(BpsBuilderTests, TestZeroRefreshRateAddsNoRefreshmentFactor) {
+  TestBpsBuilder builder(3, BounceKernelType::ForwardEventChain);
+  builder.addFactor({0, 1, 2}, gaussianDistribution_, 0.0);
+  EXPECT_EQ(1, builder.getFactorNodes().size());
+  EXPECT_EQ(1, builder.getMarkovKernelNodes().size());
+}
+
+TEST_F(BpsBuilderTests, TestRandomSubsetRefreshmentActsOnSingleVariables) {
+  TestBpsBuilder builder(3);
+  builder.addFactor(
+    {0, 1, 2}, gaussianDistribution_, RefreshmentOptions(3.0, 0.0, true));
+  auto kernels = builder.getMarkovKernelNodes();
+  ASSERT_EQ(4, kernels.size());
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(kernels[i + 1]->dependentVariableIds == std::vector<int>{i + 3});
+    bps::State refreshed = kernels[i + 1]->jump(state_);
+    for (int j = 0; j < 3; j++) {
+      if (j != i) {
+        EXPECT_EQ(state_.velocity(j), refreshed.velocity(j));
+      }
+    }
+  }
+}
+
+TEST_F(BpsBuilderTests, TestRefreshRatesAreReadFromTheController) {
+  TestBpsBuilder builder(3);
+  builder.addFactor(
+    {0, 1, 2}, gaussianDistribution_, RefreshmentOptions(3.0, 0.0, true));
+  auto controller = builder.getRefreshRateController();
+  ASSERT_EQ(3, controller->getNumberOfFactors());
+
+  // The mean refreshment time should follow the scaled rate of 1e-3 * 1.
+  controller->setScale(1e-3);
+  auto refreshmentFactor = builder.getFactorNodes()[1];
+  double meanTime = 0.0;
+  const int numberOfSamples = 10000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    meanTime +=
+      refreshmentFactor->getPoissonProcessResult(state_)->time
+      / numberOfSamples;
+  }
+  EXPECT_NEAR(1e3, meanTime, 50.0);
+}
+
+TEST_F(BpsBuilderTests, TestPartialRefreshmentKeepsMomentum) {
+  const double autocorrelation = 0.8;
+  TestBpsBuilder builder(3);
+  builder.addFactor({0, 1, 2}, gaussianDistribution_, {1.0, autocorrelation});
+  auto refreshmentKernel = builder.getMarkovKernelNodes()[1];
+
+  // v' should be N(rho * v, (1 - rho^2) I) distributed.
+  RealVector mean = RealVector::Zero(3);
+  RealVector secondMoment = RealVector::Zero(3);
+  const int numberOfSamples = 100000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    RealVector velocity = refreshmentKernel->jump(state_).velocity;
+    mean += velocity / numberOfSamples;
+    secondMoment += velocity.cwiseProduct(velocity) / numberOfSamples;
+  }
+  RealVector variance = secondMoment - mean.cwiseProduct(mean);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NEAR(autocorrelation * state_.velocity(i), mean(i), 0.01);
+    EXPECT_NEAR(1.0 - autocorrelation * autocorrelation, variance(i), 0.01);
+  }
+}
+
+// Returns the time average of the given linear function of the position
+// along the path of the pdmp, optionally checking that it stays
+// non-negative.
+template<class Pdmp>
+double getPathAverage(
+  Pdmp& pdmp, bps::State state, const RealVector& weights,
+  int numberOfIterations, bool checkPositivity = false) {
+
+  double integral = 0.0;
+  double totalTime = 0.0;
+  for (int i = 0; i < numberOfIterations; i++) {
+    const double position = weights.dot(state.position);
+    const double velocity = weights.dot(state.velocity);
+    auto iterationResult = pdmp.simulateOneIteration(std::move(state));
+    const double time = iterationResult.iterationTime;
+    integral += position * time + velocity * time * time / 2.0;
+    totalTime += time;
+    state = std::move(iterationResult.state);
+    if (checkPositivity) {
+      EXPECT_GE(weights.dot(state.position), -1e-9);
+    }
+  }
+  return integral / totalTime;
+}
+
+TEST_F(BpsBuilderTests, TestBoxBoundaryTruncatesTheTarget) {
+  // The half-normal distribution has the mean sqrt(2 / pi).
+  BpsBuilder builder(1);
+  builder.addFactor(
+    {0}, GaussianDistribution(RealVector::Zero(1), RealMatrix::Identity(1, 1)));
+  builder.addBoundary(
+    {0}, BoxBoundary(RealVector::Zero(1),
+                     RealVector::Constant(
+                       1, std::numeric_limits<double>::infinity())));
+  auto pdmp = builder.build();
+  bps::State initialState(RealVector::Ones(1), RealVector::Ones(1));
+  EXPECT_NEAR(sqrt(2.0 / M_PI),
+              getPathAverage(
+                pdmp, initialState, RealVector::Ones(1), 200000, true),
+              0.05);
+}
+
+TEST_F(BpsBuilderTests, TestTemperedTargetIsFlattened) {
+  // N(0, 1)^0.25 is N(0, 4), and the untempered box boundary truncates it
+  // to the half-normal with the mean 2 sqrt(2 / pi).
+  BpsBuilder builder(1);
+  builder.setInverseTemperature(0.25);
+  builder.addFactor(
+    {0}, GaussianDistribution(RealVector::Zero(1), RealMatrix::Identity(1, 1)));
+  builder.addBoundary(
+    {0}, BoxBoundary(RealVector::Zero(1),
+                     RealVector::Constant(
+                       1, std::numeric_limits<double>::infinity())));
+  auto pdmp = builder.build();
+  bps::State initialState(RealVector::Ones(1), RealVector::Ones(1));
+  EXPECT_NEAR(2.0 * sqrt(2.0 / M_PI),
+              getPathAverage(
+                pdmp, initialState, RealVector::Ones(1), 200000, true),
+              0.1);
+}
+
+TEST_F(BpsBuilderTests, TestInverseTemperatureShouldBeInTheUnitInterval) {
+  BpsBuilder builder(1);
+  EXPECT_THROW(builder.setInverseTemperature(0.0), std::invalid_argument);
+  EXPECT_THROW(builder.setInverseTemperature(1.5), std::invalid_argument);
+}
+
+TEST_F(BpsBuilderTests, TestHalfSpaceBoundaryTruncatesTheTarget) {
+  // For x ~ N(0, I) restricted to x_0 <= x_1, the difference x_1 - x_0 is
+  // half-normal with variance 2, so its mean is 2 / sqrt(pi).
+  BpsBuilder builder(2);
+  builder.addFactor(
+    {0, 1},
+    GaussianDistribution(RealVector::Zero(2), RealMatrix::Identity(2, 2)));
+  builder.addBoundary(
+    {0, 1}, HalfSpaceBoundary((RealVector(2) << 1.0, -1.0).finished(), 0.0));
+  auto pdmp = builder.build();
+  bps::State initialState((RealVector(2) << 0.0, 1.0).finished(),
+                          RealVector::Ones(2));
+  RealVector weights = (RealVector(2) << -1.0, 1.0).finished();
+  EXPECT_NEAR(2.0 / sqrt(M_PI),
+              getPathAverage(pdmp, initialState, weights, 200000, true),
+              0.05);
+}
+
+TEST_F(BpsBuilderTests, TestChainFactorsAreFusedIntoBlocks) {
+  RealMatrix pairCovariance(2, 2);
+  pairCovariance << 1.0, 0.5, 0.5, 1.0;
+  GaussianDistribution pairFactor(RealVector::Zero(2), pairCovariance);
+  TestBpsBuilder builder(7);
+  builder.setFactorsPerBlock(3);
+  for (int i = 0; i < 6; i++) {
+    builder.addFactor({i, i + 1}, pairFactor, 0.5);
+  }
+  builder.build();
+
+  // Two blocks, each with a fused factor followed by the refreshment factors
+  // of the three original factors.
+  auto factorNodes = builder.getFactorNodes();
+  ASSERT_EQ(8, factorNodes.size());
+  EXPECT_TRUE(factorNodes[0]->dependentVariableIds
+              == (std::vector<int>{0, 1, 2, 3, 7, 8, 9, 10}));
+  EXPECT_TRUE(factorNodes[4]->dependentVariableIds
+              == (std::vector<int>{3, 4, 5, 6, 10, 11, 12, 13}));
+  auto markovKernelNodes = builder.getMarkovKernelNodes();
+  EXPECT_TRUE(markovKernelNodes[1]->dependentVariableIds
+              == (std::vector<int>{7, 8}));
+  EXPECT_TRUE(markovKernelNodes[7]->dependentVariableIds
+              == (std::vector<int>{12, 13}));
+  // Each refreshment factor keeps the rate of its original factor.
+  for (int i = 0; i < 6; i++) {
+    EXPECT_DOUBLE_EQ(0.5, builder.getRefreshRateController()->getRate(i));
+  }
+}
+
+TEST_F(BpsBuilderTests, TestFusedFactorsKeepTheTarget) {
+  // Three overlapping factors with different means on a chain of four
+  // variables. The target mean is P^-1 sum_k P_k mean_k.
+  RealMatrix pairCovariance(2, 2);
+  pairCovariance << 1.0, 0.5, 0.5, 1.0;
+  RealMatrix pairPrecision = pairCovariance.inverse();
+  RealMatrix precision = RealMatrix::Zero(4, 4);
+  RealVector precisionTimesMean = RealVector::Zero(4);
+  BpsBuilder builder(4);
+  builder.setFactorsPerBlock(3);
+  for (int i = 0; i < 3; i++) {
+    RealVector mean = (RealVector(2) << i, -1.0).finished();
+    builder.addFactor({i, i + 1}, GaussianDistribution(mean, pairCovariance));
+    precision.block(i, i, 2, 2) += pairPrecision;
+    precisionTimesMean.segment(i, 2) += pairPrecision * mean;
+  }
+  RealVector targetMean = precision.inverse() * precisionTimesMean;
+
+  auto pdmp = builder.build();
+  bps::State initialState(RealVector::Zero(4), RealVector::Ones(4));
+  for (int i = 0; i < 4; i++) {
+    EXPECT_NEAR(targetMean(i),
+                getPathAverage(pdmp, initialState,
+                               RealVector::Unit(4, i), 100000),
+                0.1);
+  }
+}
+
+TEST_F(BpsBuilderTests, TestReorderedVariablesKeepTheTarget) {
+  // A chain of Gaussian factors visiting the variables in a scrambled order,
+  // with the target mean i at the variable chain[i].
+  std::vector<int> chain{3, 0, 4, 1, 2};
+  RealMatrix pairCovariance(2, 2);
+  pairCovariance << 1.0, 0.5, 0.5, 1.0;
+  BpsBuilder builder(5);
+  for (int i = 0; i + 1 < chain.size(); i++) {
+    RealVector mean = (RealVector(2) << i, i + 1).finished();
+    builder.addFactor(
+      {chain[i], chain[i + 1]}, GaussianDistribution(mean, pairCovariance));
+  }
+  builder.setVariableOrdering(VariableOrdering::ReverseCuthillMcKee);
+  auto pdmp = builder.build();
+
+  const auto& permutation = builder.getVariablePermutation();
+  for (int i = 0; i + 1 < chain.size(); i++) {
+    EXPECT_EQ(1, std::abs(permutation[chain[i]] - permutation[chain[i + 1]]));
+  }
+  bps::State initialState = builder.getInternalState(
+    bps::State(RealVector::Zero(5), RealVector::Ones(5)));
+  for (int i = 0; i < chain.size(); i++) {
+    EXPECT_NEAR(i,
+                getPathAverage(pdmp, initialState,
+                               RealVector::Unit(5, permutation[chain[i]]),
+                               100000),
+                0.15);
+  }
+}
+
+TEST_F(BpsBuilderTests, TestPartitionedPdmpKeepsTheTarget) {
+  // A chain of Gaussian factors, with the target mean i at the variable i.
+  const int numberOfVariables = 8;
+  RealMatrix pairCovariance(2, 2);
+  pairCovariance << 1.0, 0.5, 0.5, 1.0;
+  BpsBuilder builder(numberOfVariables);
+  for (int i = 0; i + 1 < numberOfVariables; i++) {
+    RealVector mean = (RealVector(2) << i, i + 1).finished();
+    builder.addFactor({i, i + 1}, GaussianDistribution(mean, pairCovariance));
+  }
+  auto pdmp = builder.buildPartitioned(2);
+  pdmp.setState(bps::State(RealVector::Zero(numberOfVariables),
+                           RealVector::Ones(numberOfVariables)));
+
+  const int numberOfSamples = 20000;
+  RealVector sum = RealVector::Zero(numberOfVariables);
+  for (int i = 1; i <= numberOfSamples; i++) {
+    sum += pdmp.simulateUntil(0.5 * i).position;
+  }
+  for (int i = 0; i < numberOfVariables; i++) {
+    EXPECT_NEAR(i, sum(i) / numberOfSamples, 0.15);
+  }
+  EXPECT_GT(pdmp.getStatistics().numberOfCrossPartitionEvents, 0);
+}
+
+TEST_F(BpsBuilderTests, TestChainsOfASharedModelKeepTheTarget) {
+  // A chain of Gaussian factors, with the target mean i at the variable i.
+  const int numberOfVariables = 4;
+  RealMatrix pairCovariance(2, 2);
+  pairCovariance << 1.0, 0.5, 0.5, 1.0;
+  BpsBuilder builder(numberOfVariables);
+  for (int i = 0; i + 1 < numberOfVariables; i++) {
+    RealVector mean = (RealVector(2) << i, i + 1).finished();
+    builder.addFactor({i, i + 1}, GaussianDistribution(mean, pairCovariance));
+  }
+  builder.setVariableOrdering(VariableOrdering::ReverseCuthillMcKee);
+  auto model = builder.buildModel();
+  EXPECT_EQ(2 * (numberOfVariables - 1), model->getNumberOfFactors());
+  EXPECT_EQ(builder.getVariablePermutation(), model->getVariablePermutation());
+
+  // The chains are created and simulated concurrently.
+  const bps::State initialState = builder.getInternalState(bps::State(
+    RealVector::Zero(numberOfVariables), RealVector::Ones(numberOfVariables)));
+  std::vector<std::vector<double>> averages(3);
+  std::vector<std::thread> threads;
+  for (int k = 0; k < averages.size(); k++) {
+    threads.emplace_back([&, k] () {
+      auto chain = model->createChain(k);
+      for (int i = 0; i < numberOfVariables; i++) {
+        auto weights = RealVector::Unit(
+          numberOfVariables, builder.getVariablePermutation()[i]);
+        averages[k].push_back(
+          getPathAverage(chain, initialState, weights, 40000));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int k = 0; k < averages.size(); k++) {
+    for (int i = 0; i < numberOfVariables; i++) {
+      EXPECT_NEAR(i, averages[k][i], 0.2);
+    }
+  }
+  EXPECT_NE(averages[0], averages[1]);
+}
+
+TEST_F(BpsBuilderTests, TestChainsWithTheSameSeedAreTheSame) {
+  BpsBuilder builder(3);
+  builder.addFactor({0, 1, 2}, gaussianDistribution_);
+  builder.addBoundary({0}, HalfSpaceBoundary(RealVector::Ones(1), -1.0));
+  auto model = builder.buildModel();
+
+  auto chain = model->createChain(7);
+  auto sameChain = model->createChain(7);
+  auto otherChain = model->createChain(8);
+  bps::State state = state_;
+  bps::State sameState = state_;
+  bps::State otherState = state_;
+  bool isOtherChainDifferent = false;
+  for (int i = 0; i < 100; i++) {
+    auto result = chain.simulateOneIteration(state);
+    auto sameResult = sameChain.simulateOneIteration(sameState);
+    auto otherResult = otherChain.simulateOneIteration(otherState);
+    EXPECT_EQ(result, sameResult);
+    isOtherChainDifferent |=
+      result.iterationTime != otherResult.iterationTime;
+    state = result.state;
+    sameState = sameResult.state;
+    otherState = otherResult.state;
+  }
+  EXPECT_TRUE(isOtherChainDifferent);
+}
+
+TEST_F(BpsBuilderTests, TestFactorsAddedInBulkKeepTheTarget) {
+  // A chain of Gaussian factors, with the target mean i at the variable i.
+  const int numberOfVariables = 4;
+  RealMatrix pairCovariance(2, 2);
+  pairCovariance << 1.0, 0.5, 0.5, 1.0;
+  std::vector<std::vector<int>> variableIds;
+  std::vector<GaussianDistribution> distributions;
+  for (int i = 0; i + 1 < numberOfVariables; i++) {
+    RealVector mean = (RealVector(2) << i, i + 1).finished();
+    variableIds.push_back({i, i + 1});
+    distributions.emplace_back(mean, pairCovariance);
+  }
+  TestBpsBuilder builder(numberOfVariables);
+  builder.addFactors(variableIds, distributions, RefreshmentOptions(), 2);
+  EXPECT_EQ(2 * (numberOfVariables - 1), builder.getFactorNodes().size());
+  auto pdmp = builder.build();
+
+  const bps::State initialState(
+    RealVector::Zero(numberOfVariables), RealVector::Ones(numberOfVariables));
+  for (int i = 0; i < numberOfVariables; i++) {
+    EXPECT_NEAR(i,
+                getPathAverage(
+                  pdmp, initialState, RealVector::Unit(numberOfVariables, i),
+                  40000),
+                0.2);
+  }
+  EXPECT_THROW(
+    builder.addFactors(variableIds, std::vector<GaussianDistribution>{}),
+    std::invalid_argument);
+}
+
+TEST_F(BpsBuilderTests, TestGaussianParametersAreReplacedInPlace) {
+  const RealMatrix covariance = RealMatrix::Identity(1, 1);
+  BpsBuilder builder(2);
+  builder.addFactor({0}, GaussianDistribution(RealVector::Zero(1), covariance));
+  builder.addFactor({1}, GaussianDistribution(RealVector::Zero(1), covariance));
+  auto pdmp = builder.build();
+  bps::State state(RealVector::Zero(2), RealVector::Ones(2));
+  for (int i = 0; i < 100; i++) {
+    state = pdmp.simulateOneIteration(state).state;
+  }
+
+  builder.setGaussianParameters(
+    pdmp, 1, GaussianDistribution(RealVector::Constant(1, 3.0), covariance));
+  EXPECT_NEAR(0.0, getPathAverage(pdmp, state, RealVector::Unit(2, 0), 40000),
+              0.2);
+  EXPECT_NEAR(3.0, getPathAverage(pdmp, state, RealVector::Unit(2, 1), 40000),
+              0.2);
+
+  EXPECT_THROW(
+    builder.setGaussianParameters(
+      pdmp, 2, GaussianDistribution(RealVector::Zero(1), covariance)),
+    std::out_of_range);
+  EXPECT_THROW(
+    builder.setGaussianParameters(pdmp, 0, gaussianDistribution_),
+    std::invalid_argument);
+}
+
+TEST_F(BpsBuilderTests, TestFusedGaussianParametersCanNotBeReplaced) {
+  BpsBuilder builder(3);
+  builder.setFactorsPerBlock(2);
+  const GaussianDistribution pairDistribution(
+    RealVector::Zero(2), RealMatrix::Identity(2, 2));
+  builder.addFactor({0, 1}, pairDistribution);
+  builder.addFactor({1, 2}, pairDistribution);
+  auto pdmp = builder.build();
+  EXPECT_THROW(builder.setGaussianParameters(pdmp, 1, pairDistribution),
+               std::logic_error);
+}
+
+TEST_F(BpsBuilderTests, TestSharedGaussianParametersCanNotBeReplaced) {
+  const GaussianDistribution distribution(
+    RealVector::Zero(1), RealMatrix::Identity(1, 1));
+  BpsBuilder builder(1);
+  builder.addFactor({0}, distribution);
+  auto pdmp = builder.build();
+  auto otherPdmp = builder.build();
+  EXPECT_THROW(builder.setGaussianParameters(pdmp, 0, distribution),
+               std::logic_error);
+
+  BpsBuilder modelBuilder(1);
+  modelBuilder.addFactor({0}, distribution);
+  auto chain = modelBuilder.buildModel()->createChain(0);
+  EXPECT_THROW(modelBuilder.setGaussianParameters(chain, 0, distribution),
+               std::logic_error);
+}
+
+TEST_F(BpsBuilderTests, TestSharedRefreshRatesCanNotBeScaled) {
+  BpsBuilder builder(3);
+  builder.addFactor({0, 1, 2}, gaussianDistribution_);
+  auto pdmp = builder.build();
+  builder.setRefreshRateScale(pdmp, 2.0);
+  auto otherPdmp = builder.build();
+  EXPECT_THROW(builder.setRefreshRateScale(pdmp, 0.5), std::logic_error);
+  EXPECT_THROW(builder.getRefreshRateController(otherPdmp), std::logic_error);
+  EXPECT_DOUBLE_EQ(2.0, builder.getRefreshRateController()->getScale());
+}
+
+TEST_F(BpsBuilderTests, TestRefreshRatesAreReplacedInPlace) {
+  BpsBuilder builder(3);
+  builder.addFactor({0, 1, 2}, gaussianDistribution_, 1000.0);
+  auto pdmp = builder.build();
+
+  // The pending refreshment event of the rate 1000 is resimulated with the
+  // rate 1, so the events are mostly bounces from then on.
+  bps::State state = state_;
+  auto getMeanIterationTime = [&pdmp, &state] () {
+    const int numberOfIterations = 1000;
+    double time = 0.0;
+    for (int i = 0; i < numberOfIterations; i++) {
+      auto iterationResult = pdmp.simulateOneIteration(state);
+      time += iterationResult.iterationTime / numberOfIterations;
+      state = iterationResult.state;
+    }
+    return time;
+  };
+  EXPECT_LT(getMeanIterationTime(), 0.01);
+  builder.setRefreshRateScale(pdmp, 1e-3);
+  EXPECT_DOUBLE_EQ(1.0, builder.getRefreshRateController()->getRate(0));
+  EXPECT_GT(getMeanIterationTime(), 0.1);
+
+  // Back to the rate 1000 through the controller of the PDMP, e.g. used by
+  // a RefreshRateAdapter, which resimulates the pending refreshment too.
+  auto controller = builder.getRefreshRateController(pdmp);
+  controller->setScale(1e-6);
+  controller->setScale(1.0);
+  EXPECT_DOUBLE_EQ(1000.0, controller->getRate(0));
+  auto iterationResult = pdmp.simulateOneIteration(state);
+  EXPECT_LT(iterationResult.iterationTime, 0.1);
+}
+
+TEST_F(BpsBuilderTests, TestInvalidRefreshmentOptionsThrowAnException) {
+  EXPECT_THROW(RefreshmentOptions(-1.0), std::invalid_argument);
+  EXPECT_THROW(RefreshmentOptions(1.0, 1.0), std::invalid_argument);
+}
+
+TEST_F(BpsBuilderTests, TestNonPositiveBlockSizeThrowsAnException) {
+  BpsBuilder builder(3);
+  EXPECT_THROW(builder.setFactorsPerBlock(0), std::invalid_argument);
+}
+
+TEST_F(BpsBuilderTests, TestBoundaryOfWrongDimensionThrowsAnException) {
+  BpsBuilder builder(3);
+  EXPECT_THROW(
+    builder.addBoundary({0, 1}, BoxBoundary(RealVector::Zero(3),
+                                            RealVector::Ones(3))),
+    std::invalid_argument);
+  EXPECT_THROW(
+    builder.addBoundary({0, 1}, HalfSpaceBoundary(RealVector::Ones(3), 0.0)),
+    std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
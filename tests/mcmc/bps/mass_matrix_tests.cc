@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/LU>
+
+#include "mcmc/bps/mass_matrix.h"
+
+using namespace pdmp::mcmc;
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+class MassMatrixTests : public ::testing::Test {
+
+ protected:
+
+  MassMatrixTests()
+    : inverse_((RealMatrix(3, 3) << 2.0, 0.5, 0.1,
+                                    0.5, 1.0, 0.3,
+                                    0.1, 0.3, 4.0).finished()) {
+  }
+
+  RealMatrix inverse_;
+};
+
+TEST_F(MassMatrixTests, TestDenseReflectionPreservesTheKineticEnergy) {
+  MassMatrix massMatrix(3, MassMatrixType::Dense);
+  massMatrix.setInverse(inverse_);
+  const RealMatrix mass = inverse_.inverse();
+  const std::vector<int> variableIds{0, 2};
+  RealVector velocity = (RealVector(3) << 1.0, -0.5, 2.0).finished();
+  RealVector energyGradient = (RealVector(2) << 0.3, -1.2).finished();
+
+  RealVector reflected =
+    massMatrix.reflectVelocity(variableIds, velocity, energyGradient);
+  EXPECT_NEAR(
+    velocity.dot(mass * velocity), reflected.dot(mass * reflected), 1e-10);
+  // The velocity component along the gradient changes its sign.
+  EXPECT_NEAR(
+    energyGradient(0) * velocity(0) + energyGradient(1) * velocity(2),
+    -energyGradient(0) * reflected(0) - energyGradient(1) * reflected(2),
+    1e-10);
+}
+
+TEST_F(MassMatrixTests, TestDiagonalReflectionActsOnTheFactorVariables) {
+  MassMatrix massMatrix(3, MassMatrixType::Diagonal);
+  massMatrix.setInverse(inverse_);
+  EXPECT_EQ(0.0, massMatrix.getInverse()(0, 1));
+  const std::vector<int> variableIds{1, 2};
+  RealVector velocity = (RealVector(2) << -0.5, 2.0).finished();
+  RealVector energyGradient = (RealVector(2) << 1.0, 1.0).finished();
+
+  RealVector reflected =
+    massMatrix.reflectVelocity(variableIds, velocity, energyGradient);
+  ASSERT_EQ(2, reflected.size());
+  EXPECT_NEAR(
+    velocity(0) * velocity(0) / 1.0 + velocity(1) * velocity(1) / 4.0,
+    reflected(0) * reflected(0) / 1.0 + reflected(1) * reflected(1) / 4.0,
+    1e-10);
+  EXPECT_NEAR(-energyGradient.dot(velocity), energyGradient.dot(reflected),
+              1e-10);
+}
+
+TEST_F(MassMatrixTests, TestSampledVelocitiesHaveTheInverseMassCovariance) {
+  MassMatrix massMatrix(3, MassMatrixType::Dense);
+  massMatrix.setInverse(inverse_);
+  std::mt19937_64 rng(42);
+  const std::vector<int> variableIds{0, 1, 2};
+  RealMatrix covariance = RealMatrix::Zero(3, 3);
+  const int numberOfSamples = 100000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    RealVector velocity = massMatrix.sampleVelocity(variableIds, rng);
+    covariance += velocity * velocity.transpose() / numberOfSamples;
+  }
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      EXPECT_NEAR(inverse_(i, j), covariance(i, j), 0.1);
+    }
+  }
+  EXPECT_THROW(massMatrix.sampleVelocity({0}, rng), std::logic_error);
+}
+
+TEST_F(MassMatrixTests, TestInvalidInverseMassMatricesThrowAnException) {
+  MassMatrix massMatrix(3, MassMatrixType::Dense);
+  EXPECT_THROW(massMatrix.setInverse(RealMatrix::Identity(2, 2)),
+               std::invalid_argument);
+  EXPECT_THROW(massMatrix.setInverse(-1.0 * RealMatrix::Identity(3, 3)),
+               std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -71,6 +71,40 @@ TEST_F(ReflectionKernelTests, TestSimpleReflection) {
   EXPECT_DOUBLE_EQ(reflectedVelocity(1), -2.0);
 }
 
+TEST_F(ReflectionKernelTests, TestForwardEventChainReflectsParallelComponent) {
+  auto logPdfGradient = gaussianDistribution_.getLogPdfGradient();
+  auto forwardEventChainKernel = getForwardEventChainKernel(logPdfGradient);
+  RealVector energyGradient = -1.0 * logPdfGradient(initialPosition_);
+  for (int i = 0; i < 10; i++) {
+    RealVector bounced = forwardEventChainKernel(initialState_);
+    EXPECT_DOUBLE_EQ(initialPosition_(0), bounced(0));
+    EXPECT_DOUBLE_EQ(initialPosition_(1), bounced(1));
+    EXPECT_NEAR(-energyGradient.dot(initialVelocity_),
+                energyGradient.dot(bounced.tail(2)), 1e-8);
+  }
+}
+
+TEST_F(ReflectionKernelTests, TestForwardEventChainResamplesOrthogonalPart) {
+  auto forwardEventChainKernel = getForwardEventChainKernel(
+    gaussianDistribution_.getLogPdfGradient());
+  // The energy gradient at (1, 1) points along (1, 1), so the orthogonal
+  // component is along (1, -1) and should be N(0, 1) distributed.
+  RealVector state = (RealVector(4) << 1, 1, 2, 0).finished();
+  RealVector orthogonalDirection =
+    (RealVector(2) << 1, -1).finished().normalized();
+  double mean = 0.0;
+  double secondMoment = 0.0;
+  const int numberOfSamples = 100000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    double orthogonalComponent =
+      orthogonalDirection.dot(forwardEventChainKernel(state).tail(2));
+    mean += orthogonalComponent / numberOfSamples;
+    secondMoment += orthogonalComponent * orthogonalComponent / numberOfSamples;
+  }
+  EXPECT_NEAR(0.0, mean, 0.02);
+  EXPECT_NEAR(1.0, secondMoment, 0.02);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "mcmc/bps/refresh_rate_controller.h"
+
+using namespace pdmp::mcmc;
+
+TEST(RefreshRateControllerTests, TestRatesAreScaledBaseRates) {
+  RefreshRateController controller;
+  EXPECT_EQ(0, controller.registerFactor(1.0));
+  EXPECT_EQ(1, controller.registerFactor(0.5));
+  EXPECT_EQ(2, controller.getNumberOfFactors());
+  controller.setScale(4.0);
+  EXPECT_DOUBLE_EQ(4.0, controller.getRate(0));
+  EXPECT_DOUBLE_EQ(2.0, controller.getRate(1));
+}
+
+TEST(RefreshRateControllerTests, TestFrozenScaleCannotBeChanged) {
+  RefreshRateController controller;
+  controller.registerFactor(1.0);
+  controller.setScale(2.0);
+  controller.freeze();
+  EXPECT_TRUE(controller.isFrozen());
+  EXPECT_THROW(controller.setScale(3.0), std::logic_error);
+  EXPECT_DOUBLE_EQ(2.0, controller.getRate(0));
+}
+
+TEST(RefreshRateControllerTests, TestInvalidRatesThrowAnException) {
+  RefreshRateController controller;
+  EXPECT_THROW(controller.registerFactor(-1.0), std::invalid_argument);
+  EXPECT_THROW(controller.setScale(0.0), std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
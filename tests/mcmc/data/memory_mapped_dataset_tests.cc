@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <Eigen/Core>
+
+#include "mcmc/data/memory_mapped_dataset.h"
+
+using namespace pdmp::mcmc;
+
+using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+class MemoryMappedDatasetTests : public ::testing::Test {
+
+ protected:
+
+  MemoryMappedDatasetTests()
+    : path_(::testing::TempDir() + "memory_mapped_dataset_tests.bin"),
+      matrix_((RealMatrix(2, 3) << 1.0, 2.0, 3.0,
+                                   4.0, 5.0, 6.0).finished()) {
+  }
+
+  ~MemoryMappedDatasetTests() {
+    std::remove(path_.c_str());
+  }
+
+  // Writes a double precision dataset header with the given dimensions,
+  // followed by the given number of zero elements.
+  void writeHeader(
+    std::uint64_t rows, std::uint64_t cols, int numberOfElements) const {
+
+    const std::uint64_t header[3] = {
+      rows, cols, static_cast<std::uint64_t>(DatasetType::Float64)};
+    std::ofstream file(path_, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (int i = 0; i < numberOfElements; i++) {
+      const double zero = 0.0;
+      file.write(reinterpret_cast<const char*>(&zero), sizeof(zero));
+    }
+  }
+
+  const std::string path_;
+  const RealMatrix matrix_;
+};
+
+TEST_F(MemoryMappedDatasetTests, TestWrittenMatrixIsReadBack) {
+  writeColumnarDataset(path_, matrix_);
+  MemoryMappedDataset dataset(path_);
+  EXPECT_EQ(2, dataset.rows());
+  EXPECT_EQ(3, dataset.cols());
+  EXPECT_TRUE(dataset.getType() == DatasetType::Float64);
+  EXPECT_TRUE(matrix_ == dataset.getMatrix());
+  EXPECT_TRUE(matrix_.col(2) == dataset.getColumn(2));
+}
+
+TEST_F(MemoryMappedDatasetTests, TestViewsDoNotCopyTheData) {
+  writeColumnarDataset(path_, matrix_);
+  auto dataset = std::make_shared<const MemoryMappedDataset>(path_);
+  auto firstView = dataset->getMatrix();
+  auto secondView = dataset->getMatrix();
+  EXPECT_EQ(firstView.data(), secondView.data());
+  EXPECT_EQ(firstView.data() + 2, dataset->getColumn(1).data());
+}
+
+TEST_F(MemoryMappedDatasetTests, TestSinglePrecisionDatasets) {
+  writeColumnarDataset(path_, matrix_.cast<float>());
+  MemoryMappedDataset dataset(path_);
+  EXPECT_TRUE(dataset.getType() == DatasetType::Float32);
+  EXPECT_TRUE(matrix_.cast<float>() == dataset.getMatrix<float>());
+  EXPECT_THROW(dataset.getMatrix<double>(), std::logic_error);
+}
+
+TEST_F(MemoryMappedDatasetTests, TestInvalidFilesThrowAnException) {
+  EXPECT_THROW(MemoryMappedDataset("/non/existing/file"), std::runtime_error);
+
+  // A header claiming more data than the file contains.
+  writeColumnarDataset(path_, matrix_);
+  std::ofstream(path_, std::ios::binary | std::ios::in | std::ios::out)
+    .write("\x10", 1);
+  EXPECT_THROW(MemoryMappedDataset dataset(path_), std::runtime_error);
+}
+
+TEST_F(MemoryMappedDatasetTests, TestOverflowingDimensionsThrowAnException) {
+  // The payload size 8 * (2^61 + 8) of these dimensions overflows to the
+  // size of 8 elements.
+  writeHeader(2147352580, 1073807362, 8);
+  EXPECT_THROW(MemoryMappedDataset dataset(path_), std::runtime_error);
+
+  // An empty dataset, but with more columns than an int can hold.
+  writeHeader(0, std::uint64_t(1) << 31, 0);
+  EXPECT_THROW(MemoryMappedDataset dataset(path_), std::runtime_error);
+
+  writeHeader(2, 4, 8);
+  EXPECT_EQ(4, MemoryMappedDataset(path_).cols());
+}
+
+TEST_F(MemoryMappedDatasetTests, TestColumnIdOutOfRangeThrowsAnException) {
+  writeColumnarDataset(path_, matrix_);
+  MemoryMappedDataset dataset(path_);
+  EXPECT_THROW(dataset.getColumn(3), std::out_of_range);
+  EXPECT_THROW(dataset.getColumn(-1), std::out_of_range);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
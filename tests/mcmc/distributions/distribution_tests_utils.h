@@ -0,0 +1,33 @@
+#pragma once
+
+#include <algorithm>
+
+#include <Eigen/Core>
+
+namespace distribution_tests_utils {
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+
+// Numerically integrates the BPS (or Zig-Zag, if perCoordinate is true) rate
+// along the flow from the given state until the given time.
+template<class F>
+double integrateRate(
+  const F& logPdfGradient, const RealVector& state, double time,
+  bool perCoordinate) {
+
+  const int dimension = state.size() / 2;
+  const int steps = 2000;
+  double integral = 0.0;
+  for (int k = 0; k < steps; k++) {
+    RealVector position =
+      state.head(dimension) + state.tail(dimension) * (k + 0.5) * time / steps;
+    RealVector rates =
+      -1.0 * state.tail(dimension).cwiseProduct(logPdfGradient(position));
+    double rate = perCoordinate ? rates.cwiseMax(0.0).sum()
+                                : std::max(0.0, rates.sum());
+    integral += rate * time / steps;
+  }
+  return integral;
+}
+
+}
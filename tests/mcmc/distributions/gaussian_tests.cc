@@ -3,7 +3,10 @@
 #include <Eigen/Core>
 #include <stan/math/prim/mat.hpp>
 
+#include "core/policies/boomerang_flow.h"
 #include "core/policies/linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
+#include "core/state_space/position_and_velocity_state.h"
 #include "mcmc/utils.h"
 #include "mcmc/distributions/gaussian.h"
 
@@ -50,6 +53,87 @@ TEST(
   EXPECT_TRUE(start(0) + start(1) * jumpTime->time > mean(0));
 }
 
+TEST(
+  TestGaussianPoissonProcessStrategy,
+  TestBoomerangEventTimesAreExact) {
+
+  RealVector mean(2);
+  mean << 1.0, -0.5;
+  RealMatrix covariances(2, 2);
+  covariances << 2.0, 0.3, 0.3, 0.5;
+  pdmp::mcmc::GaussianDistribution gaussianDistribution(mean, covariances);
+  auto poissonProcessStrategy =
+    gaussianDistribution.getPoissonProcessStrategy<pdmp::BoomerangFlow>();
+  auto logPdfGradient = gaussianDistribution.getLogPdfGradient();
+  pdmp::DynamicPositionAndVelocityState<double> start(
+    (RealVector(2) << 0.5, 1.0).finished(),
+    (RealVector(2) << -1.0, 0.2).finished());
+
+  // Integrate the rate numerically along the flow until the first accepted
+  // event. The integrated rate should be Exp(1) distributed.
+  double meanIntegratedRate = 0.0;
+  const int numberOfSamples = 1000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    auto state = start;
+    double integratedRate = 0.0;
+    while (true) {
+      RealVector subvector(4);
+      subvector << state.position, state.velocity;
+      auto result = poissonProcessStrategy(subvector, 0, 0);
+      const int steps = 200;
+      for (int k = 0; k < steps; k++) {
+        auto midState = pdmp::BoomerangFlow::advanceStateByFlow(
+          state, (k + 0.5) * result->time / steps);
+        integratedRate += std::max(
+          0.0, -midState.velocity.dot(logPdfGradient(midState.position)))
+          * result->time / steps;
+      }
+      state = pdmp::BoomerangFlow::advanceStateByFlow(state, result->time);
+      if (result->shouldAccept()) {
+        break;
+      }
+    }
+    meanIntegratedRate += integratedRate / numberOfSamples;
+  }
+  EXPECT_NEAR(1.0, meanIntegratedRate, 0.15);
+}
+
+TEST(
+  TestGaussianPoissonProcessStrategy,
+  TestZigZagEventTimesAreExact) {
+
+  RealVector mean(2);
+  mean << 1.0, -0.5;
+  RealMatrix covariances(2, 2);
+  covariances << 2.0, 0.3, 0.3, 0.5;
+  pdmp::mcmc::GaussianDistribution gaussianDistribution(mean, covariances);
+  auto poissonProcessStrategy =
+    gaussianDistribution.getPoissonProcessStrategy<pdmp::ZigZagFlow>();
+  auto logPdfGradient = gaussianDistribution.getLogPdfGradient();
+  // The first coordinate moves uphill, the second one downhill.
+  RealVector position = (RealVector(2) << 0.5, 1.0).finished();
+  RealVector velocity = (RealVector(2) << -1.0, -1.0).finished();
+  RealVector subvector(4);
+  subvector << position, velocity;
+
+  // The integrated Zig-Zag rate sum_i max(0, v_i d_i U) until the event
+  // time should be Exp(1) distributed.
+  double meanIntegratedRate = 0.0;
+  const int numberOfSamples = 2000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    const double time = poissonProcessStrategy(subvector, 0, 0)->time;
+    const int steps = 200;
+    for (int k = 0; k < steps; k++) {
+      RealVector midPosition = position + velocity * (k + 0.5) * time / steps;
+      RealVector rates =
+        -1.0 * velocity.cwiseProduct(logPdfGradient(midPosition));
+      meanIntegratedRate +=
+        rates.cwiseMax(0.0).sum() * time / steps / numberOfSamples;
+    }
+  }
+  EXPECT_NEAR(1.0, meanIntegratedRate, 0.1);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
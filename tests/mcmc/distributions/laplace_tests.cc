@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <Eigen/Core>
+
+#include "core/policies/linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
+#include "mcmc/utils.h"
+#include "mcmc/distributions/laplace.h"
+#include "distribution_tests_utils.h"
+
+using namespace pdmp;
+using namespace pdmp::mcmc;
+using distribution_tests_utils::integrateRate;
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+
+TEST(LaplaceDistributionTests, TestAnalyticGradientMatchesAutodiff) {
+  IndependentLaplaceDistribution distribution(
+    (RealVector(3) << 0.0, 1.0, -2.0).finished(),
+    (RealVector(3) << 1.0, 0.5, 2.0).finished());
+  RealVector x = (RealVector(3) << 0.3, 0.2, -1.0).finished();
+  RealVector expected = getGradientOfAFunctor(distribution.getLogPdf())(x);
+  RealVector actual = distribution.getLogPdfGradient()(x);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_DOUBLE_EQ(expected(i), actual(i));
+  }
+}
+
+TEST(LaplaceDistributionTests, TestUnivariateEventsHappenAfterCrossing) {
+  LaplaceDistribution distribution(2.0, 0.5);
+  auto strategy = distribution.getPoissonProcessStrategy<LinearFlow>();
+
+  // Moving towards the location at speed 2 from distance 3.
+  RealVector state = (RealVector(2) << 5.0, -2.0).finished();
+  double meanTimeAfterCrossing = 0.0;
+  const int numberOfSamples = 10000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    double time = strategy(state, 0, 0)->time;
+    EXPECT_GT(time, 1.5);
+    meanTimeAfterCrossing += (time - 1.5) / numberOfSamples;
+  }
+  // After the crossing the rate is |v| / scale = 4.
+  EXPECT_NEAR(0.25, meanTimeAfterCrossing, 0.02);
+
+  state << 5.0, 0.0;
+  EXPECT_TRUE(std::isinf(strategy(state, 0, 0)->time));
+}
+
+TEST(LaplaceDistributionTests, TestProductEventTimesAreExact) {
+  IndependentLaplaceDistribution distribution(
+    (RealVector(3) << 0.0, 1.0, -2.0).finished(),
+    (RealVector(3) << 1.0, 0.5, 2.0).finished());
+  auto logPdfGradient = distribution.getLogPdfGradient();
+  RealVector state =
+    (RealVector(6) << 1.0, -1.0, 0.0, -1.0, 1.0, 0.5).finished();
+
+  // The integrated rate at the event time should be Exp(1) distributed.
+  auto bpsStrategy = distribution.getPoissonProcessStrategy<LinearFlow>();
+  auto zigZagStrategy = distribution.getPoissonProcessStrategy<ZigZagFlow>();
+  double bpsMean = 0.0;
+  double zigZagMean = 0.0;
+  const int numberOfSamples = 1000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    bpsMean += integrateRate(
+      logPdfGradient, state, bpsStrategy(state, 0, 0)->time, false)
+      / numberOfSamples;
+    zigZagMean += integrateRate(
+      logPdfGradient, state, zigZagStrategy(state, 0, 0)->time, true)
+      / numberOfSamples;
+  }
+  EXPECT_NEAR(1.0, bpsMean, 0.15);
+  EXPECT_NEAR(1.0, zigZagMean, 0.15);
+}
+
+TEST(LaplaceDistributionTests, TestInvalidParametersThrowAnException) {
+  EXPECT_THROW(LaplaceDistribution(0.0, 0.0), std::invalid_argument);
+  EXPECT_THROW(
+    IndependentLaplaceDistribution(RealVector::Zero(2), RealVector::Ones(3)),
+    std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
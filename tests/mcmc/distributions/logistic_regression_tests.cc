@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "core/policies/linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
+#include "mcmc/utils.h"
+#include "mcmc/distributions/logistic_regression.h"
+
+using namespace pdmp;
+using namespace pdmp::mcmc;
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+class LogisticRegressionTests : public ::testing::Test {
+
+ protected:
+
+  LogisticRegressionTests()
+    : covariates_((RealMatrix(2, 4) << 1.0, -0.5, 2.0, 0.3,
+                                       0.2, 1.5, -1.0, -2.0).finished()),
+      responses_((RealVector(4) << 1.0, 0.0, 1.0, 0.0).finished()),
+      distribution_(covariates_, responses_),
+      position_((RealVector(2) << 0.7, -1.2).finished()) {
+  }
+
+  RealMatrix covariates_;
+  RealVector responses_;
+  LogisticRegressionDistribution distribution_;
+  RealVector position_;
+};
+
+TEST_F(LogisticRegressionTests, TestAnalyticGradientMatchesAutodiff) {
+  auto analyticGradient = distribution_.getLogPdfGradient();
+  auto autodiffGradient = getGradientOfAFunctor(distribution_.getLogPdf());
+  RealVector expected = autodiffGradient(position_);
+  RealVector actual = analyticGradient(position_);
+  EXPECT_NEAR(expected(0), actual(0), 1e-10);
+  EXPECT_NEAR(expected(1), actual(1), 1e-10);
+}
+
+TEST_F(LogisticRegressionTests, TestObservationFactorsSumToTheFullGradient) {
+  RealVector sum = RealVector::Zero(2);
+  for (int j = 0; j < distribution_.getNumberOfObservations(); j++) {
+    auto observationFactor = distribution_.getObservationFactor(j);
+    EXPECT_EQ(1, observationFactor.getNumberOfObservations());
+    sum += observationFactor.getLogPdfGradient()(position_);
+  }
+  RealVector expected = distribution_.getLogPdfGradient()(position_);
+  EXPECT_NEAR(expected(0), sum(0), 1e-10);
+  EXPECT_NEAR(expected(1), sum(1), 1e-10);
+  EXPECT_THROW(distribution_.getObservationFactor(4), std::out_of_range);
+}
+
+TEST_F(LogisticRegressionTests, TestParallelGradientMatchesTheSerialOne) {
+  const int kNumberOfObservations = 10001;
+  RealMatrix covariates = RealMatrix::Random(3, kNumberOfObservations);
+  RealVector responses = (RealVector::Random(kNumberOfObservations).array()
+                          > 0.0).cast<double>();
+  RealVector position = (RealVector(3) << 0.3, -0.8, 1.1).finished();
+  LogisticRegressionDistribution distribution(covariates, responses);
+  RealVector expected = distribution.getLogPdfGradient()(position);
+
+  std::vector<RealVector> gradients;
+  for (int numberOfThreads : {2, 4}) {
+    distribution.setParallelGradient(numberOfThreads, 1000);
+    gradients.push_back(distribution.getLogPdfGradient()(position));
+  }
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NEAR(expected(i), gradients[0](i), 1e-9);
+    // The partial gradients are summed in the same order.
+    EXPECT_EQ(gradients[0](i), gradients[1](i));
+  }
+  EXPECT_THROW(distribution.setParallelGradient(0), std::invalid_argument);
+  EXPECT_THROW(distribution.setParallelGradient(2, 0), std::invalid_argument);
+}
+
+TEST_F(LogisticRegressionTests, TestAcceptedBpsEventsAreUphill) {
+  // The full factor uses the precomputed Hessian bound, the observation
+  // factor the rank-one bound.
+  for (const auto& distribution :
+       {distribution_, distribution_.getObservationFactor(2)}) {
+    auto strategy = distribution.getPoissonProcessStrategy<LinearFlow>();
+    auto logPdfGradient = distribution.getLogPdfGradient();
+    RealVector state = (RealVector(4) << 3.0, -1.0, -1.0, 0.5).finished();
+    int numberOfAcceptedEvents = 0;
+    for (int i = 0; i < 1000; i++) {
+      auto result = strategy(state, 0, 0);
+      if (result->shouldAccept()) {
+        numberOfAcceptedEvents++;
+        RealVector position = state.head(2) + state.tail(2) * result->time;
+        EXPECT_LT(state.tail(2).dot(logPdfGradient(position)), 0.0);
+      }
+    }
+    EXPECT_GT(numberOfAcceptedEvents, 0);
+  }
+}
+
+TEST_F(LogisticRegressionTests, TestAcceptedZigZagEventsHaveAPositiveRate) {
+  for (const auto& distribution :
+       {distribution_, distribution_.getObservationFactor(2)}) {
+    auto strategy = distribution.getPoissonProcessStrategy<ZigZagFlow>();
+    auto logPdfGradient = distribution.getLogPdfGradient();
+    RealVector state = (RealVector(4) << 3.0, -1.0, -1.0, 1.0).finished();
+    int numberOfAcceptedEvents = 0;
+    for (int i = 0; i < 1000; i++) {
+      auto result = strategy(state, 0, 0);
+      if (result->shouldAccept()) {
+        numberOfAcceptedEvents++;
+        RealVector position = state.head(2) + state.tail(2) * result->time;
+        RealVector rates = -1.0 * state.tail(2).cwiseProduct(
+          logPdfGradient(position));
+        EXPECT_GT(rates.maxCoeff(), 0.0);
+      }
+    }
+    EXPECT_GT(numberOfAcceptedEvents, 0);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
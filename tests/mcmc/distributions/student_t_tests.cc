@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <Eigen/Core>
+
+#include "core/policies/linear_flow.h"
+#include "core/policies/zig_zag_flow.h"
+#include "mcmc/utils.h"
+#include "mcmc/distributions/student_t.h"
+#include "distribution_tests_utils.h"
+
+using namespace pdmp;
+using namespace pdmp::mcmc;
+using distribution_tests_utils::integrateRate;
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+namespace {
+
+// Returns the first accepted event time of a strategy using thinning.
+template<class F>
+double getAcceptedEventTime(F& strategy, const RealVector& state) {
+  const int dimension = state.size() / 2;
+  RealVector currentState = state;
+  double time = 0.0;
+  while (true) {
+    auto result = strategy(currentState, 0, 0);
+    time += result->time;
+    if (result->shouldAccept()) {
+      return time;
+    }
+    currentState.head(dimension) += state.tail(dimension) * result->time;
+  }
+}
+
+}
+
+class MultivariateStudentTTests : public ::testing::Test {
+
+ protected:
+
+  MultivariateStudentTTests()
+    : distribution_(
+        (RealVector(2) << 1.0, -1.0).finished(),
+        (RealMatrix(2, 2) << 2.0, 0.5, 0.5, 1.0).finished(), 3.0),
+      state_((RealVector(4) << 3.0, 0.0, -1.0, 1.0).finished()) {
+  }
+
+  MultivariateStudentTDistribution distribution_;
+  RealVector state_;
+};
+
+TEST(StudentTTests, TestAnalyticGradientMatchesAutodiff) {
+  StudentTDistribution distribution(1.0, 2.0, 3.0);
+  RealVector x = (RealVector(1) << -0.7).finished();
+  EXPECT_DOUBLE_EQ(
+    getGradientOfAFunctor(distribution.getLogPdf())(x)(0),
+    distribution.getLogPdfGradient()(x)(0));
+}
+
+TEST(StudentTTests, TestUnivariateEventTimesAreExact) {
+  StudentTDistribution distribution(1.0, 2.0, 1.0);
+  auto strategy = distribution.getPoissonProcessStrategy<LinearFlow>();
+  auto logPdfGradient = distribution.getLogPdfGradient();
+  RealVector state = (RealVector(2) << 4.0, -1.5).finished();
+
+  // The integrated rate at the event time should be Exp(1) distributed.
+  double mean = 0.0;
+  const int numberOfSamples = 1000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    double time = strategy(state, 0, 0)->time;
+    EXPECT_LT(state(0) + state(1) * time, 1.0);
+    mean += integrateRate(logPdfGradient, state, time, false) / numberOfSamples;
+  }
+  EXPECT_NEAR(1.0, mean, 0.15);
+}
+
+TEST_F(MultivariateStudentTTests, TestAnalyticGradientMatchesAutodiff) {
+  RealVector x = (RealVector(2) << 0.3, 2.0).finished();
+  RealVector expected = getGradientOfAFunctor(distribution_.getLogPdf())(x);
+  RealVector actual = distribution_.getLogPdfGradient()(x);
+  EXPECT_NEAR(expected(0), actual(0), 1e-12);
+  EXPECT_NEAR(expected(1), actual(1), 1e-12);
+}
+
+TEST_F(MultivariateStudentTTests, TestBpsEventTimesAreExact) {
+  auto strategy = distribution_.getPoissonProcessStrategy<LinearFlow>();
+  auto logPdfGradient = distribution_.getLogPdfGradient();
+  double mean = 0.0;
+  const int numberOfSamples = 1000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    mean += integrateRate(
+      logPdfGradient, state_, strategy(state_, 0, 0)->time, false)
+      / numberOfSamples;
+  }
+  EXPECT_NEAR(1.0, mean, 0.15);
+}
+
+TEST_F(MultivariateStudentTTests, TestZigZagEventTimesAreExact) {
+  auto strategy = distribution_.getPoissonProcessStrategy<ZigZagFlow>();
+  auto logPdfGradient = distribution_.getLogPdfGradient();
+  double mean = 0.0;
+  const int numberOfSamples = 1000;
+  for (int i = 0; i < numberOfSamples; i++) {
+    mean += integrateRate(
+      logPdfGradient, state_, getAcceptedEventTime(strategy, state_), true)
+      / numberOfSamples;
+  }
+  EXPECT_NEAR(1.0, mean, 0.15);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,6 +1,14 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
 #include <memory>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
 
 #include <Eigen/Core>
 
@@ -85,6 +93,313 @@ TEST(PdmpBuilderBaseTests, TestAddingFactorNodes) {
     && builder.getVariableNodes()[3]->dependentFactorIds.size() == 0);
 }
 
+TEST(PdmpBuilderBaseTests, TestAddingFactorAndMarkovKernelNodes) {
+  PdmpBuilder builder;
+  // Each pair of lambdas shares a counter, which is created anew for each
+  // chain of the model.
+  auto numberOfCreatedPairs = make_shared<int>(0);
+  builder.addFactorAndMarkovKernelNodes(
+    {0, 2}, {0, 1}, {0},
+    [numberOfCreatedPairs] () {
+      (*numberOfCreatedPairs)++;
+      auto numberOfJumps = make_shared<int>(0);
+      auto ppStrategy = [numberOfJumps] (const auto&, auto&, auto&) {
+        return wrapPoissonProcessResult(1.0 + *numberOfJumps);
+      };
+      auto kernel = [numberOfJumps] (const auto& subvector) {
+        (*numberOfJumps)++;
+        auto newSubvector = subvector;
+        newSubvector(0) = 0.0;
+        return newSubvector;
+      };
+      return make_tuple(ppStrategy, kernel);
+    });
+  EXPECT_EQ(1, *numberOfCreatedPairs);
+  ASSERT_EQ(1, builder.getFactorNodes().size());
+  ASSERT_EQ(1, builder.getMarkovKernelNodes().size());
+  EXPECT_TRUE(builder.getVariableNodes()[0]->dependentFactorIds == vector<int>{0}
+              && builder.getVariableNodes()[2]->dependentFactorIds
+                 == vector<int>{0});
+  EXPECT_TRUE(builder.getMarkovKernelNodes()[0]->dependentVariableIds
+              == vector<int>{0});
+  EXPECT_TRUE(builder.getMarkovKernelNodes()[0]->getRequiredVariableIds()
+              == (vector<int>{0, 1}));
+
+  auto model = builder.buildModel();
+  auto chain = model->createChain(0);
+  auto otherChain = model->createChain(1);
+  EXPECT_EQ(3, *numberOfCreatedPairs);
+  State state{RealVector::Ones(2), RealVector::Ones(2)};
+  auto result = chain.simulateOneIteration(state);
+  EXPECT_DOUBLE_EQ(1.0, result.iterationTime);
+  EXPECT_DOUBLE_EQ(0.0, result.state.position(0));
+  EXPECT_DOUBLE_EQ(2.0, chain.simulateOneIteration(result.state).iterationTime);
+  // The other chain has its own counter.
+  EXPECT_DOUBLE_EQ(1.0, otherChain.simulateOneIteration(state).iterationTime);
+}
+
+TEST(PdmpBuilderBaseTests, TestAddingFactorsInBulk) {
+  // More factors than fit in a chunk, each with its own event time drawn
+  // from the generator given to it.
+  const int numberOfFactors = 3 * PdmpBuilder::kNumberOfFactorsPerChunk + 1;
+  vector<PdmpBuilder::FactorSpec> factorSpecs;
+  for (int i = 0; i < numberOfFactors; i++) {
+    factorSpecs.push_back({{i % 2}, {i % 2, 2 + i % 2}, {2 + i % 2}});
+  }
+  auto createLambdas = [] (int factorIndex) {
+    auto rng = getRng();
+    const double time =
+      factorIndex + uniform_real_distribution<double>(0.0, 1.0)(rng);
+    auto ppStrategy = [time] (const auto&, auto&, auto&) {
+      return wrapPoissonProcessResult(time);
+    };
+    auto kernel = [] (const auto& subvector) { return subvector; };
+    return make_tuple(ppStrategy, kernel);
+  };
+
+  vector<double> firstEventTimes;
+  for (int numberOfThreads : {1, 3}) {
+    PdmpBuilder builder;
+    {
+      ScopedRngSeed seed(2019);
+      builder.addFactorAndMarkovKernelNodes(
+        factorSpecs, createLambdas, numberOfThreads);
+    }
+    ASSERT_EQ(numberOfFactors, builder.getFactorNodes().size());
+    ASSERT_EQ(numberOfFactors, builder.getMarkovKernelNodes().size());
+    const auto variableNodes = builder.getVariableNodes();
+    EXPECT_EQ((numberOfFactors + 1) / 2,
+              variableNodes[0]->dependentFactorIds.size());
+    EXPECT_EQ(numberOfFactors / 2,
+              variableNodes[1]->dependentFactorIds.size());
+    EXPECT_TRUE(is_sorted(variableNodes[1]->dependentFactorIds.begin(),
+                          variableNodes[1]->dependentFactorIds.end()));
+    EXPECT_TRUE(builder.getMarkovKernelNodes()[1]->getRequiredVariableIds()
+                == (vector<int>{1, 3}));
+
+    auto pdmp = builder.build();
+    State state{RealVector::Ones(2), RealVector::Ones(2)};
+    firstEventTimes.push_back(pdmp.simulateOneIteration(state).iterationTime);
+  }
+  EXPECT_LT(firstEventTimes[0], 1.0);
+  EXPECT_DOUBLE_EQ(firstEventTimes[0], firstEventTimes[1]);
+}
+
+TEST(PdmpBuilderBaseTests, TestModelNeedsNodeFactories) {
+  PdmpBuilder builder;
+  auto ppStrategy = [] (const auto&, auto&, auto&) {
+    return wrapPoissonProcessResult(1.0);
+  };
+  auto kernel = [] (const auto& subvector) { return subvector; };
+  builder.addFactorNode({0}, ppStrategy);
+  builder.addMarkovKernelNode({0}, {0}, kernel);
+  EXPECT_THROW(builder.buildModel(), logic_error);
+}
+
+TEST(PdmpBuilderBaseTests, TestVariableReorderingRemapsTheNodes) {
+  // A factor and a kernel coupling the second position and the first
+  // velocity.
+  PdmpBuilder builder;
+  auto ppStrategy = [] (const auto& subvector, auto&, auto&) {
+    shared_ptr<PoissonProcessResultBase> result = make_shared<
+      PoissonProcessResult<>>(subvector(0) - subvector(1));
+    return result;
+  };
+  auto kernel = [] (const auto& subvector) {
+    auto newSubvector = subvector;
+    newSubvector(1) = subvector(0);
+    return newSubvector;
+  };
+  builder.addFactorNode({1, 2}, ppStrategy);
+  builder.addMarkovKernelNode({1, 2}, {2}, kernel);
+  builder.setVariableOrdering(VariableOrdering::ReverseCuthillMcKee);
+  builder.build();
+
+  auto permutation = builder.getVariablePermutation();
+  vector<int> sortedPermutation = permutation;
+  sort(sortedPermutation.begin(), sortedPermutation.end());
+  EXPECT_TRUE(sortedPermutation == (vector<int>{0, 1, 2, 3}));
+  // Positions and velocities are permuted together.
+  EXPECT_EQ(permutation[0] + 2, permutation[2]);
+  EXPECT_EQ(permutation[1] + 2, permutation[3]);
+
+  State userState{
+    (RealVector(2) << 1, 2).finished(), (RealVector(2) << 3, 4).finished()};
+  State internalState = builder.getInternalState(userState);
+  for (int i = 0; i < kPdmpDimension; i++) {
+    EXPECT_DOUBLE_EQ(userState.getElementAtIndex(i),
+                     internalState.getElementAtIndex(permutation[i]));
+  }
+  EXPECT_TRUE(userState == builder.getUserState(internalState));
+}
+
+TEST(PdmpBuilderBaseTests, TestReorderedPdmpSimulatesTheSameProcess) {
+  // Factors with deterministic event times and deterministic kernels, so
+  // that both orderings must give the same trajectory.
+  auto ppStrategy = [] (const auto& subvector, auto&, auto&) {
+    shared_ptr<PoissonProcessResultBase> result = make_shared<
+      PoissonProcessResult<>>(1.0 / (1.0 + subvector(0) * subvector(0)
+                                     + 2.0 * subvector(1) * subvector(1)));
+    return result;
+  };
+  auto kernel = [] (const auto& subvector) {
+    auto newSubvector = subvector;
+    newSubvector(1) = -subvector(1) + 0.1 * subvector(0);
+    return newSubvector;
+  };
+  const int kDimension = 6;
+  State userState{(RealVector(3) << 0.5, -1.0, 0.25).finished(),
+                  (RealVector(3) << 1.0, 0.5, -2.0).finished()};
+  vector<State> finalStates;
+  vector<vector<int>> permutations;
+  for (auto ordering : {VariableOrdering::AsAdded,
+                        VariableOrdering::ReverseCuthillMcKee}) {
+    PdmpBuilderBase<State, Flow> builder(kDimension);
+    for (int i : {2, 0}) {
+      builder.addFactorNode({i, i + 3}, ppStrategy);
+      builder.addMarkovKernelNode({i, i + 3}, {i + 3}, kernel);
+    }
+    builder.addFactorNode({1, 2, 4, 5}, ppStrategy);
+    builder.addMarkovKernelNode({1, 4}, {4}, kernel);
+    builder.setVariableOrdering(ordering);
+    auto pdmp = builder.build();
+    State state = builder.getInternalState(userState);
+    for (int i = 0; i < 20; i++) {
+      state = pdmp.simulateOneIteration(std::move(state)).state;
+    }
+    finalStates.push_back(builder.getUserState(state));
+    permutations.push_back(builder.getVariablePermutation());
+  }
+  EXPECT_FALSE(permutations[0] == permutations[1]);
+  for (int i = 0; i < kDimension; i++) {
+    EXPECT_NEAR(finalStates[0].getElementAtIndex(i),
+                finalStates[1].getElementAtIndex(i), 1e-12);
+  }
+}
+
+namespace {
+
+// Adds factors coupling a hub variable 0 with each of the other variables,
+// whose positions bounce between -1 and 1 deterministically. The kernels
+// may modify both velocities, but only reflect the non-hub one. Counts the
+// Poisson process simulations in the given counter.
+void addHubFactors(
+  PdmpBuilderBase<State, Flow>& builder, int numberOfModelVariables,
+  shared_ptr<atomic<int>> numberOfSimulations) {
+
+  auto wallHittingStrategy =
+    [numberOfSimulations] (const auto& subvector, auto&, auto&) {
+      (*numberOfSimulations)++;
+      const double position = subvector(1);
+      const double velocity = subvector(3);
+      const double wall = velocity > 0.0 ? 1.0 : -1.0;
+      shared_ptr<PoissonProcessResultBase> result = make_shared<
+        PoissonProcessResult<>>((wall - position) / velocity);
+      return result;
+    };
+  auto reflection = [] (const auto& subvector) {
+    auto newSubvector = subvector;
+    newSubvector(3) = -subvector(3);
+    return newSubvector;
+  };
+  for (int i = 1; i < numberOfModelVariables; i++) {
+    vector<int> ids{0, i, numberOfModelVariables, numberOfModelVariables + i};
+    builder.addFactorNode(ids, wallHittingStrategy);
+    builder.addMarkovKernelNode(
+      ids, {numberOfModelVariables, numberOfModelVariables + i}, reflection);
+  }
+}
+
+}
+
+TEST(PdmpBuilderBaseTests, TestHubEventsOnlyResimulateChangedFactors) {
+  const int kNumberOfModelVariables = 6;
+  const int kNumberOfIterations = 50;
+  State initialState{
+    (RealVector(6) << 0.0, 0.1, -0.2, 0.3, -0.4, 0.5).finished(),
+    (RealVector(6) << 1.0, 1.0, -0.7, 0.9, 1.3, -1.1).finished()};
+  vector<State> finalStates;
+  vector<int> numbersOfSimulations;
+  for (int hubThreshold : {100, 2}) {
+    PdmpBuilderBase<State, Flow> builder(2 * kNumberOfModelVariables);
+    auto numberOfSimulations = make_shared<atomic<int>>(0);
+    addHubFactors(builder, kNumberOfModelVariables, numberOfSimulations);
+    builder.setHubThreshold(hubThreshold);
+    auto pdmp = builder.build();
+    State state = initialState;
+    for (int i = 0; i < kNumberOfIterations; i++) {
+      state = pdmp.simulateOneIteration(std::move(state)).state;
+    }
+    finalStates.push_back(state);
+    numbersOfSimulations.push_back(*numberOfSimulations);
+  }
+  // Each event resimulates all the factors sharing the hub at the start of
+  // the next iteration, unless the kernel is known to have changed only the
+  // non-hub velocity.
+  const int kNumberOfFactors = kNumberOfModelVariables - 1;
+  EXPECT_EQ(kNumberOfFactors * kNumberOfIterations, numbersOfSimulations[0]);
+  EXPECT_EQ(kNumberOfFactors + kNumberOfIterations - 1,
+            numbersOfSimulations[1]);
+  for (int i = 0; i < 2 * kNumberOfModelVariables; i++) {
+    EXPECT_NEAR(finalStates[0].getElementAtIndex(i),
+                finalStates[1].getElementAtIndex(i), 1e-9);
+  }
+}
+
+TEST(PdmpBuilderBaseTests, TestParallelResimulationSimulatesTheSameProcess) {
+  const int kNumberOfModelVariables = 40;
+  const int kNumberOfIterations = 200;
+  RealVector position(kNumberOfModelVariables);
+  RealVector velocity(kNumberOfModelVariables);
+  for (int i = 0; i < kNumberOfModelVariables; i++) {
+    position(i) = 0.9 * sin(i);
+    velocity(i) = 0.5 + 0.1 * (i % 7);
+  }
+  vector<State> finalStates;
+  vector<int> numbersOfSimulations;
+  for (int numberOfThreads : {1, 4}) {
+    PdmpBuilderBase<State, Flow> builder(2 * kNumberOfModelVariables);
+    auto numberOfSimulations = make_shared<atomic<int>>(0);
+    addHubFactors(builder, kNumberOfModelVariables, numberOfSimulations);
+    builder.setHubThreshold(1000);
+    builder.setParallelResimulation(numberOfThreads, 8);
+    auto pdmp = builder.build();
+    State state{position, velocity};
+    for (int i = 0; i < kNumberOfIterations; i++) {
+      state = pdmp.simulateOneIteration(std::move(state)).state;
+    }
+    finalStates.push_back(state);
+    numbersOfSimulations.push_back(*numberOfSimulations);
+  }
+  EXPECT_EQ(numbersOfSimulations[0], numbersOfSimulations[1]);
+  for (int i = 0; i < 2 * kNumberOfModelVariables; i++) {
+    EXPECT_DOUBLE_EQ(finalStates[0].getElementAtIndex(i),
+                     finalStates[1].getElementAtIndex(i));
+  }
+  PdmpBuilderBase<State, Flow> builder(2);
+  EXPECT_THROW(builder.setParallelResimulation(0), invalid_argument);
+}
+
+TEST(PdmpBuilderBaseTests, TestFactorGraphReportFindsTheHub) {
+  const int kNumberOfModelVariables = 6;
+  PdmpBuilderBase<State, Flow> builder(2 * kNumberOfModelVariables);
+  addHubFactors(
+    builder, kNumberOfModelVariables, make_shared<atomic<int>>(0));
+  auto report = builder.getFactorGraphReport(2);
+
+  // The hub position and velocity have degree 5, the others degree 1.
+  EXPECT_TRUE(report.degreeDistribution == (map<int, int>{{1, 10}, {5, 2}}));
+  EXPECT_DOUBLE_EQ(5.0, report.meanDependentFactorsPerKernel);
+  ASSERT_EQ(2, report.hubs.size());
+  EXPECT_EQ(0, report.hubs[0].variableId);
+  EXPECT_EQ(0, report.hubs[0].numberOfModifyingKernels);
+  EXPECT_EQ(kNumberOfModelVariables, report.hubs[1].variableId);
+  EXPECT_EQ(5, report.hubs[1].degree);
+  EXPECT_EQ(5, report.hubs[1].numberOfModifyingKernels);
+  EXPECT_DOUBLE_EQ(5.0, report.hubs[1].meanDependentFactorsPerKernel);
+  EXPECT_EQ(5, report.hubs[1].maxDependentFactorsPerKernel);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include <Eigen/Core>
+
+#include "core/policies/linear_flow.h"
+#include "core/state_space/position_and_velocity_state.h"
+#include "mcmc/bps/bps_builder.h"
+#include "mcmc/subsampling/data_sum_factor.h"
+#include "mcmc/zig_zag/zig_zag_builder.h"
+
+using namespace pdmp;
+using namespace pdmp::mcmc;
+
+using State = DynamicPositionAndVelocityState<double>;
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+namespace {
+
+// U_j(x) = |x - y_j|^2 / 2, so that the gradient is x - y_j and its
+// Lipschitz constant is 1.
+auto datumEnergyGradient = [] (const RealVector& x, const auto& datum) {
+  RealVector gradient = x - datum;
+  return gradient;
+};
+
+auto datumLipschitzConstant = [] (const auto&) {
+  return 1.0;
+};
+
+// Returns the time average of the positions along the path of the PDMP.
+template<class Pdmp>
+RealVector getPathMean(Pdmp& pdmp, State state, int numberOfIterations) {
+  RealVector integral = RealVector::Zero(state.position.size());
+  double totalTime = 0.0;
+  for (int i = 0; i < numberOfIterations; i++) {
+    const RealVector position = state.position;
+    const RealVector velocity = state.velocity;
+    auto iterationResult = pdmp.simulateOneIteration(std::move(state));
+    const double time = iterationResult.iterationTime;
+    integral += position * time + velocity * time * time / 2.0;
+    totalTime += time;
+    state = std::move(iterationResult.state);
+  }
+  return integral / totalTime;
+}
+
+}
+
+class DataSumFactorTests : public ::testing::Test {
+
+ protected:
+
+  DataSumFactorTests()
+    : data_((RealMatrix(2, 3) << 1.0, 2.0, -3.0,
+                                 0.5, -1.0, 4.0).finished()),
+      referencePoint_((RealVector(2) << 0.1, 0.2).finished()),
+      factor_(makeDataSumFactor(
+        Eigen::Map<const RealMatrix>(data_.data(), data_.rows(), data_.cols()),
+        datumEnergyGradient,
+        datumLipschitzConstant,
+        referencePoint_)) {
+  }
+
+  // The exact gradient of sum_j U_j at the given position.
+  RealVector getExactGradient(const RealVector& position) {
+    return data_.cols() * position - data_.rowwise().sum();
+  }
+
+  RealMatrix data_;
+  RealVector referencePoint_;
+  DataSumFactor<decltype(datumEnergyGradient)> factor_;
+};
+
+TEST_F(DataSumFactorTests, TestReferenceGradientIsPrecomputedExactly) {
+  RealVector expected = getExactGradient(referencePoint_);
+  EXPECT_DOUBLE_EQ(expected(0), factor_.getReferenceEnergyGradient()(0));
+  EXPECT_DOUBLE_EQ(expected(1), factor_.getReferenceEnergyGradient()(1));
+  EXPECT_EQ(3, factor_.getNumberOfData());
+}
+
+TEST_F(DataSumFactorTests, TestGradientEstimateIsUnbiased) {
+  RealVector position = (RealVector(2) << 5.0, -2.5).finished();
+  RealVector average = RealVector::Zero(2);
+  for (int j = 0; j < factor_.getNumberOfData(); j++) {
+    average += factor_.getEnergyGradientEstimate(position, j);
+  }
+  average /= factor_.getNumberOfData();
+  RealVector expected = getExactGradient(position);
+  EXPECT_NEAR(expected(0), average(0), 1e-10);
+  EXPECT_NEAR(expected(1), average(1), 1e-10);
+}
+
+TEST_F(DataSumFactorTests, TestAcceptedEventsStoreTheUsedEstimate) {
+  auto cache = std::make_shared<GradientEstimateCache>();
+  auto strategy = factor_.getBpsPoissonProcessStrategy<LinearFlow>(cache);
+  RealVector state = (RealVector(4) << 3.0, -1.0, 1.0, 0.5).finished();
+  int numberOfAcceptedEvents = 0;
+  for (int i = 0; i < 1000; i++) {
+    auto result = strategy(state, 0, 0);
+    if (result->shouldAccept()) {
+      numberOfAcceptedEvents++;
+      // For this potential, the estimate does not depend on the datum.
+      RealVector position = state.head(2) + state.tail(2) * result->time;
+      RealVector expected = getExactGradient(position);
+      EXPECT_NEAR(expected(0), cache->energyGradient(0), 1e-8);
+      EXPECT_NEAR(expected(1), cache->energyGradient(1), 1e-8);
+    }
+  }
+  EXPECT_GT(numberOfAcceptedEvents, 0);
+}
+
+TEST_F(DataSumFactorTests, TestBpsAndZigZagBuildersAcceptDataSumFactors) {
+  BpsBuilder bpsBuilder(2);
+  bpsBuilder.addFactor({0, 1}, factor_, 1.0);
+  auto bps = bpsBuilder.build();
+
+  ZigZagBuilder zigZagBuilder(2);
+  zigZagBuilder.addFactor({0, 1}, factor_);
+  auto zigZag = zigZagBuilder.build();
+
+  State state(
+    (RealVector(2) << 1.0, 1.0).finished(),
+    (RealVector(2) << 1.0, -1.0).finished());
+  // The target exp(-sum_j U_j) is the Gaussian with the mean of the data
+  // and the variance 1 / 3 in each coordinate.
+  RealVector posteriorMean = data_.rowwise().mean();
+  RealVector bpsMean = getPathMean(bps, state, 100000);
+  RealVector zigZagMean = getPathMean(zigZag, state, 100000);
+  for (int i = 0; i < 2; i++) {
+    EXPECT_NEAR(posteriorMean(i), bpsMean(i), 0.05);
+    EXPECT_NEAR(posteriorMean(i), zigZagMean(i), 0.05);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
 #include <Eigen/Core>
 #include <stan/math/prim/mat.hpp>
 
@@ -24,6 +28,58 @@ TEST(TestStanGradientWrapper, CalculateGradientOfLogPdfOfNormalDistribution) {
   EXPECT_DOUBLE_EQ(logPdfGradient(x)(1), -x(1) / 2.0);
 }
 
+TEST(TestAffineIntensityJumpTime, IntegratedIntensityMatchesTheExponential) {
+  using pdmp::mcmc::getAffineIntensityJumpTime;
+  // Increasing intensity 1 + 2t: t + t^2 = 2 at t = 1.
+  EXPECT_DOUBLE_EQ(1.0, getAffineIntensityJumpTime(1.0, 2.0, 2.0));
+  // Intensity zero until t = 1, then 2(t - 1): (t - 1)^2 = 4 at t = 3.
+  EXPECT_DOUBLE_EQ(3.0, getAffineIntensityJumpTime(-2.0, 2.0, 4.0));
+  // Constant intensity 2.
+  EXPECT_DOUBLE_EQ(1.5, getAffineIntensityJumpTime(2.0, 0.0, 3.0));
+  // Decreasing intensity 2 - 2t integrates to 2t - t^2 = 0.75 at t = 0.5,
+  // and to 1 in total.
+  EXPECT_DOUBLE_EQ(0.5, getAffineIntensityJumpTime(2.0, -2.0, 0.75));
+  EXPECT_TRUE(std::isinf(getAffineIntensityJumpTime(2.0, -2.0, 1.5)));
+  EXPECT_TRUE(std::isinf(getAffineIntensityJumpTime(-1.0, -1.0, 0.5)));
+}
+
+TEST(TestSumOfChunksInParallel, ChunksAreSummedInOrder) {
+  using pdmp::mcmc::getSumOfChunksInParallel;
+  // Each partial sum records its range, so the order of the additions
+  // shows in the floating point result.
+  auto partialSum = [] (int begin, int end) {
+    RealVector sum = RealVector::Zero(2);
+    for (int i = begin; i < end; i++) {
+      sum(0) += 1.0 / (i + 1.0);
+      sum(1) += 1.0;
+    }
+    return sum;
+  };
+  pdmp::ThreadPool singleThread(1);
+  pdmp::ThreadPool threeThreads(3);
+  RealVector expected =
+    getSumOfChunksInParallel(partialSum, 1000, 7, singleThread);
+  RealVector actual =
+    getSumOfChunksInParallel(partialSum, 1000, 7, threeThreads);
+  EXPECT_EQ(expected(0), actual(0));
+  EXPECT_EQ(1000.0, actual(1));
+  EXPECT_EQ(0.0, getSumOfChunksInParallel(partialSum, 0, 7, threeThreads)(1));
+}
+
+TEST(TestScopedRngSeed, SeededEnginesAreReproducible) {
+  using pdmp::mcmc::getRng;
+  using pdmp::mcmc::ScopedRngSeed;
+  std::vector<std::uint64_t> draws[2];
+  for (auto& threadDraws : draws) {
+    ScopedRngSeed seed(42);
+    for (int i = 0; i < 3; i++) {
+      threadDraws.push_back(getRng()());
+    }
+  }
+  EXPECT_EQ(draws[0], draws[1]);
+  EXPECT_NE(draws[0][0], draws[0][1]);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "mcmc/variable_ordering.h"
+
+using namespace std;
+using namespace pdmp::mcmc;
+
+namespace {
+
+bool isPermutation(const vector<int>& permutation) {
+  vector<int> sorted = permutation;
+  sort(sorted.begin(), sorted.end());
+  vector<int> identity(permutation.size());
+  iota(identity.begin(), identity.end(), 0);
+  return sorted == identity;
+}
+
+}
+
+TEST(VariableOrderingTests, TestAdjacencyListsOfCliques) {
+  auto adjacencyLists = getAdjacencyLists({{0, 2}, {2, 1, 0}, {3}}, 4);
+  EXPECT_TRUE(adjacencyLists[0] == (vector<int>{1, 2}));
+  EXPECT_TRUE(adjacencyLists[1] == (vector<int>{0, 2}));
+  EXPECT_TRUE(adjacencyLists[2] == (vector<int>{0, 1}));
+  EXPECT_TRUE(adjacencyLists[3].empty());
+}
+
+TEST(VariableOrderingTests, TestLargeCliquesAreConnectedByAStar) {
+  vector<int> clique(kMaxExpandedCliqueSize + 1);
+  iota(clique.begin(), clique.end(), 0);
+  auto adjacencyLists = getAdjacencyLists({clique}, clique.size() + 1);
+  EXPECT_EQ(kMaxExpandedCliqueSize, adjacencyLists[0].size());
+  for (int i = 1; i < clique.size(); i++) {
+    EXPECT_TRUE(adjacencyLists[i] == (vector<int>{0}));
+  }
+
+  // The isolated variable is numbered in its own component.
+  auto permutation = getReverseCuthillMcKeePermutation(adjacencyLists);
+  EXPECT_TRUE(isPermutation(permutation));
+  EXPECT_TRUE(permutation[clique.size()] == 0
+              || permutation[clique.size()] == clique.size());
+}
+
+TEST(VariableOrderingTests, TestScrambledChainGetsUnitBandwidth) {
+  // A chain visiting the variables in a scrambled order.
+  vector<int> chain{7, 2, 9, 0, 5, 3, 8, 1, 6, 4};
+  vector<vector<int>> cliques;
+  for (int i = 0; i + 1 < chain.size(); i++) {
+    cliques.push_back({chain[i], chain[i + 1]});
+  }
+  auto adjacencyLists = getAdjacencyLists(cliques, chain.size());
+  vector<int> identity(chain.size());
+  iota(identity.begin(), identity.end(), 0);
+  EXPECT_GT(getBandwidth(adjacencyLists, identity), 1);
+
+  auto permutation = getReverseCuthillMcKeePermutation(adjacencyLists);
+  EXPECT_TRUE(isPermutation(permutation));
+  EXPECT_EQ(1, getBandwidth(adjacencyLists, permutation));
+}
+
+TEST(VariableOrderingTests, TestGridBandwidthIsBoundedByItsWidth) {
+  // A 6 x 6 grid of variables numbered by a stride coprime to its size.
+  const int kWidth = 6;
+  const int kNumberOfVariables = kWidth * kWidth;
+  auto id = [] (int row, int column) {
+    return ((row * kWidth + column) * 7) % kNumberOfVariables;
+  };
+  vector<vector<int>> cliques;
+  for (int row = 0; row < kWidth; row++) {
+    for (int column = 0; column < kWidth; column++) {
+      if (column + 1 < kWidth) {
+        cliques.push_back({id(row, column), id(row, column + 1)});
+      }
+      if (row + 1 < kWidth) {
+        cliques.push_back({id(row, column), id(row + 1, column)});
+      }
+    }
+  }
+  auto adjacencyLists = getAdjacencyLists(cliques, kNumberOfVariables);
+  auto permutation = getReverseCuthillMcKeePermutation(adjacencyLists);
+  EXPECT_TRUE(isPermutation(permutation));
+  EXPECT_LE(getBandwidth(adjacencyLists, permutation), kWidth);
+}
+
+TEST(VariableOrderingTests, TestComponentsAreNumberedContiguously) {
+  auto adjacencyLists = getAdjacencyLists({{0, 2}, {1, 3}, {3, 5}}, 6);
+  auto permutation = getReverseCuthillMcKeePermutation(adjacencyLists);
+  EXPECT_TRUE(isPermutation(permutation));
+  EXPECT_EQ(1, abs(permutation[0] - permutation[2]));
+  vector<int> component{permutation[1], permutation[3], permutation[5]};
+  sort(component.begin(), component.end());
+  EXPECT_EQ(2, component.back() - component.front());
+}
+
+TEST(VariableOrderingTests, TestOutOfRangeVariableIdThrowsAnException) {
+  EXPECT_THROW(getAdjacencyLists({{0, 3}}, 3), std::out_of_range);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include <Eigen/Core>
+
+#include "mcmc/distributions/gaussian.h"
+#include "mcmc/zig_zag/zig_zag_builder.h"
+
+using namespace pdmp::mcmc;
+
+using RealVector = Eigen::Matrix<double, Eigen::Dynamic, 1>;
+using RealMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+
+TEST(ZigZagBuilderTests, TestStickyCoordinatesSampleTheSpikeAndSlab) {
+  // A N(0, 1) slab and a spike with the same mass, i.e. the stickiness is
+  // the slab density at zero.
+  const double slabDensityAtZero = 1.0 / sqrt(2.0 * M_PI);
+  ZigZagBuilder builder(2);
+  builder.addFactor(
+    {0, 1},
+    GaussianDistribution(RealVector::Zero(2), RealMatrix::Identity(2, 2)));
+  builder.addStickyCoordinates({0, 1}, slabDensityAtZero);
+  auto pdmp = builder.build();
+
+  zig_zag::State state(RealVector::Ones(2), RealVector::Ones(2));
+  RealVector frozenTime = RealVector::Zero(2);
+  RealVector integratedSquares = RealVector::Zero(2);
+  double totalTime = 0.0;
+  for (int i = 0; i < 200000; i++) {
+    const RealVector position = state.position;
+    const RealVector velocity = state.velocity;
+    auto iterationResult = pdmp.simulateOneIteration(std::move(state));
+    const double time = iterationResult.iterationTime;
+    for (int j = 0; j < 2; j++) {
+      if (velocity(j) == 0.0) {
+        EXPECT_EQ(0.0, position(j));
+        frozenTime(j) += time;
+      }
+      integratedSquares(j) +=
+        position(j) * position(j) * time
+        + position(j) * velocity(j) * time * time
+        + velocity(j) * velocity(j) * time * time * time / 3.0;
+    }
+    totalTime += time;
+    state = std::move(iterationResult.state);
+  }
+  for (int j = 0; j < 2; j++) {
+    EXPECT_NEAR(0.5, frozenTime(j) / totalTime, 0.05);
+    EXPECT_NEAR(0.5, integratedSquares(j) / totalTime, 0.05);
+  }
+}
+
+TEST(ZigZagBuilderTests, TestTemperedTargetIsFlattened) {
+  // N(0, I)^0.5 is N(0, 2 I).
+  ZigZagBuilder builder(2);
+  builder.setInverseTemperature(0.5);
+  builder.addFactor(
+    {0, 1},
+    GaussianDistribution(RealVector::Zero(2), RealMatrix::Identity(2, 2)));
+  auto pdmp = builder.build();
+
+  zig_zag::State state(RealVector::Ones(2), RealVector::Ones(2));
+  RealVector integratedSquares = RealVector::Zero(2);
+  double totalTime = 0.0;
+  for (int i = 0; i < 200000; i++) {
+    const RealVector position = state.position;
+    const RealVector velocity = state.velocity;
+    auto iterationResult = pdmp.simulateOneIteration(std::move(state));
+    const double time = iterationResult.iterationTime;
+    for (int j = 0; j < 2; j++) {
+      integratedSquares(j) +=
+        position(j) * position(j) * time
+        + position(j) * velocity(j) * time * time
+        + velocity(j) * velocity(j) * time * time * time / 3.0;
+    }
+    totalTime += time;
+    state = std::move(iterationResult.state);
+  }
+  for (int j = 0; j < 2; j++) {
+    EXPECT_NEAR(2.0, integratedSquares(j) / totalTime, 0.2);
+  }
+}
+
+TEST(ZigZagBuilderTests, TestUnfrozenCoordinateKeepsItsVelocity) {
+  ZigZagBuilder builder(1);
+  builder.addFactor(
+    {0}, GaussianDistribution(RealVector::Zero(1), RealMatrix::Identity(1, 1)));
+  builder.addStickyCoordinates({0}, 1.0);
+  auto pdmp = builder.build();
+
+  // The velocity is flipped by the factor and the independent flips, but
+  // not while the coordinate is frozen.
+  zig_zag::State state(RealVector::Constant(1, -0.5), RealVector::Ones(1));
+  bool wasFrozen = false;
+  double velocityBeforeFreezing = 0.0;
+  int numberOfUnfreezings = 0;
+  for (int i = 0; i < 10000; i++) {
+    const double velocity = state.velocity(0);
+    auto iterationResult = pdmp.simulateOneIteration(std::move(state));
+    state = std::move(iterationResult.state);
+    if (!wasFrozen && state.velocity(0) == 0.0) {
+      velocityBeforeFreezing = velocity;
+      wasFrozen = true;
+    } else if (wasFrozen && state.velocity(0) != 0.0) {
+      EXPECT_EQ(velocityBeforeFreezing, state.velocity(0));
+      EXPECT_EQ(0.0, state.position(0));
+      numberOfUnfreezings++;
+      wasFrozen = false;
+    }
+  }
+  EXPECT_GT(numberOfUnfreezings, 100);
+}
+
+TEST(ZigZagBuilderTests, TestFrozenStatesAreUnfrozenByTheirSign) {
+  ZigZagBuilder builder(1);
+  builder.addStickyCoordinates({0}, 1.0);
+  auto pdmp = builder.build();
+
+  // A fresh PDMP starting from a frozen coordinate, and a zero velocity,
+  // which is unfrozen in the positive direction.
+  for (double velocity : {-0.0, 0.0}) {
+    pdmp.resetEvents();
+    zig_zag::State state(
+      RealVector::Zero(1), RealVector::Constant(1, velocity));
+    while (state.velocity(0) == 0.0) {
+      state = pdmp.simulateOneIteration(std::move(state)).state;
+    }
+    EXPECT_EQ(std::signbit(velocity) ? -1.0 : 1.0, state.velocity(0));
+  }
+}
+
+TEST(ZigZagBuilderTests, TestStickyCoordinatesCanNotBePartitioned) {
+  ZigZagBuilder builder(2);
+  builder.addStickyCoordinates({1}, 1.0);
+  EXPECT_THROW(builder.buildPartitioned(2), std::logic_error);
+}
+
+TEST(ZigZagBuilderTests, TestNonPositiveStickinessThrowsAnException) {
+  ZigZagBuilder builder(1);
+  EXPECT_THROW(builder.addStickyCoordinates({0}, 0.0), std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}